@@ -0,0 +1,121 @@
+// Benchmark: latency of one formatted write as seen by the producing thread,
+// writing to a file synchronously and through fl::sinks::async_sink.
+//
+// Each case times 1,000,000 calls of
+//
+//   fl::format_to(sink, "2026-10-17T12:00:{:02}.{:06} INFO request id={} user={} bytes={:>8} status={}\n", ...)
+//
+// (about 90 bytes) individually with steady_clock and reports percentiles,
+// then the producer's throughput. The file is in the temporary directory and
+// deleted afterwards.
+//
+//   fd_sink                  written on the calling thread: every 64 KB the
+//                            call that fills the buffer pays for write().
+//   async_sink block         async_sink over the same fd_sink, 64 KB blocks,
+//                            16 queued; a full queue makes the writer wait.
+//   async_sink drop          as above, a full queue discards the block.
+//   async_sink grow          as above, a full queue allocates another block.
+//   async_sink, one write    backpressure::block, with each line formatted
+//                            into a stack buffer by format_to_n and passed
+//                            to the sink in one write(), as concurrent
+//                            writers should to keep lines whole.
+//
+// Timer overhead (an empty timed region) is reported separately and is
+// included in every figure.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "fl.hpp"
+#include "fl/async_sink.hpp"
+
+static constexpr std::size_t kCalls = 1'000'000;
+static constexpr const char* kUsers[] = {"alice", "bob", "carol", "dave", "eve", "mallory"};
+
+using clock_type = std::chrono::steady_clock;
+
+static void report(const char* name, std::vector<double>& samples, double seconds, std::uint64_t dropped) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1))]; };
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(8) << at(0.50) << std::setw(8) << at(0.99) << std::setw(9) << at(0.999)
+              << std::setw(10) << samples.back() << std::setw(9) << static_cast<double>(kCalls) * 90 / 1e6 / seconds
+              << std::setw(12) << dropped << "\n";
+}
+
+template <typename Fn>
+static std::vector<double> time_calls(Fn&& fn, double& seconds) {
+    std::vector<double> samples(kCalls);
+    const auto start = clock_type::now();
+    for (std::size_t i = 0; i < kCalls; ++i) {
+        const auto t0 = clock_type::now();
+        fn(i);
+        const auto t1 = clock_type::now();
+        samples[i] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+    seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    return samples;
+}
+
+template <typename Sink>
+static void write_line(Sink& sink, std::size_t i) {
+    fl::format_to(sink, "2026-10-17T12:00:{:02}.{:06} INFO request id={} user={} bytes={:>8} status={}\n",
+                  i / 1000000 % 60, i % 1000000, i, kUsers[i % 6], (i * 7919) % 100000000, 200 + i % 3 * 100);
+}
+
+static void write_whole_line(fl::sinks::output_sink& sink, std::size_t i) {
+    char line[256];
+    const auto result = fl::format_to_n(
+        line, sizeof(line), "2026-10-17T12:00:{:02}.{:06} INFO request id={} user={} bytes={:>8} status={}\n",
+        i / 1000000 % 60, i % 1000000, i, kUsers[i % 6], (i * 7919) % 100000000, 200 + i % 3 * 100);
+    sink.write(line, result.size);
+}
+
+static void run_async(const char* name, const std::string& path, fl::sinks::backpressure policy, bool whole_lines) {
+    fl::sinks::fd_sink file(path.c_str());
+    fl::sinks::async_options opts;
+    opts.policy = policy;
+    fl::sinks::async_sink sink(file, opts);
+    double seconds = 0;
+    auto samples = time_calls([&](std::size_t i) {
+        if (whole_lines) {
+            write_whole_line(sink, i);
+        } else {
+            write_line(sink, i);
+        }
+    }, seconds);
+    sink.close();
+    report(name, samples, seconds, sink.bytes_dropped());
+}
+
+int main() {
+    const std::string path = (std::filesystem::temp_directory_path() / "fl_async_sink_bench.log").string();
+
+    std::cout << "Per-call latency, ns:     " << std::setw(8) << "p50" << std::setw(8) << "p99" << std::setw(9)
+              << "p99.9" << std::setw(10) << "max" << std::setw(9) << "MB/s" << std::setw(12) << "dropped B"
+              << "\n";
+
+    double seconds = 0;
+    auto empty = time_calls([](std::size_t) {}, seconds);
+    report("timer overhead", empty, seconds, 0);
+
+    {
+        fl::sinks::fd_sink sink(path.c_str());
+        auto samples = time_calls([&](std::size_t i) { write_line(sink, i); }, seconds);
+        sink.flush();
+        report("fd_sink", samples, seconds, 0);
+    }
+    run_async("async_sink block", path, fl::sinks::backpressure::block, false);
+    run_async("async_sink drop", path, fl::sinks::backpressure::drop, false);
+    run_async("async_sink grow", path, fl::sinks::backpressure::grow, false);
+    run_async("async_sink, one write", path, fl::sinks::backpressure::block, true);
+
+    std::filesystem::remove(path);
+    return 0;
+}
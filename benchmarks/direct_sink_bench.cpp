@@ -0,0 +1,101 @@
+// Benchmark: formatting and escaping through an output_sink& whose sink does
+// or does not lend its buffer through prepare()/commit() (best of 40 rounds,
+// ns per call).
+//
+// Workloads:
+//
+//   json_escape     4 KB of JSON-ish text with quotes, tabs and backslashes.
+//   html_escape     the same text.
+//   padded          "{:>200}|{:<120}|{:^90}": three wide fills.
+//   numbers         eight integers and a float, "{} {} {} {:.3f} ...".
+//
+// Columns:
+//
+//   write() only    a buffer behind an output_sink subclass that overrides
+//                   write() alone, so every number and escaped chunk is
+//                   built in a temporary and copied, as all output_sink&
+//                   calls were before prepare()/commit() became virtual.
+//   prepare/commit  sinks::buffer_sink through the same output_sink&: the
+//                   kernels write straight into the buffer.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "fl.hpp"
+
+static volatile std::size_t sink_sz;
+
+// A plain buffer that only overrides write().
+class write_only_sink final : public fl::sinks::output_sink {
+public:
+    explicit write_only_sink(char* buffer) noexcept : _buffer(buffer) {}
+
+    void write(const char* data, std::size_t len) override {
+        std::memcpy(_buffer + _size, data, len);
+        _size += len;
+    }
+
+    std::size_t size() const noexcept { return _size; }
+
+private:
+    char* _buffer;
+    std::size_t _size = 0;
+};
+
+// One timed round of calls of fn(sink, i), in ns per call.
+template <typename Sink, typename Fn>
+static double round_ns(char* buffer, int calls, Fn&& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        Sink concrete = [&] {
+            if constexpr (std::is_same_v<Sink, fl::sinks::buffer_sink>) {
+                return Sink(buffer, std::size_t{1} << 16);
+            } else {
+                return Sink(buffer);
+            }
+        }();
+        fl::sinks::output_sink& sink = concrete;
+        fn(sink, i);
+        sink_sz = buffer[0];
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / calls;
+}
+
+// Alternates the two sinks for 40 rounds and reports the best of each.
+template <typename Fn>
+static void compare(const char* name, char* buffer, int calls, Fn&& fn) {
+    double write_only = 1e300;
+    double direct = 1e300;
+    for (int round = 0; round < 40; ++round) {
+        write_only = std::min(write_only, round_ns<write_only_sink>(buffer, calls, fn));
+        direct = std::min(direct, round_ns<fl::sinks::buffer_sink>(buffer, calls, fn));
+    }
+    std::cout << "  " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(14) << write_only << std::setw(16) << direct << "\n";
+}
+
+int main() {
+    std::string text;
+    while (text.size() < 4096) {
+        text += "{\"user\": \"alice\\tbob\", \"path\": \"C:\\\\tmp\\n\"} plain words here ";
+    }
+    static char buffer[std::size_t{1} << 16];
+
+    std::cout << "ns per call through output_sink&:" << std::setw(14) << "write() only" << std::setw(16)
+              << "prepare/commit" << "\n";
+    compare("json_escape", buffer, 2000, [&](fl::sinks::output_sink& sink, int) { fl::json_escape(sink, text); });
+    compare("html_escape", buffer, 2000, [&](fl::sinks::output_sink& sink, int) { fl::html_escape(sink, text); });
+    compare("padded", buffer, 50000, [](fl::sinks::output_sink& sink, int i) {
+        fl::format_to(sink, "{:>200}|{:<120}|{:^90}", i, "x", 2.5);
+    });
+    compare("numbers", buffer, 50000, [](fl::sinks::output_sink& sink, int i) {
+        fl::format_to(sink, "{} {} {} {:.3f} {} {:x} {} {}", i, i * 7, 123456789u + i, i * 0.25, -i, i, 42,
+                      i * 3ull);
+    });
+    return 0;
+}
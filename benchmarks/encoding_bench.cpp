@@ -0,0 +1,238 @@
+// Benchmark: base64 and hex throughput, in MB/s of input (best of 7 runs,
+// each processing a 64 KB random blob 64 times), and the cost of hex-dumping
+// one 32-byte hash, in ns per call.
+//
+// Rows:
+//
+//   scalar            a table lookup per group appending to a string_builder,
+//                     the way responses were encoded before fl/encoding.hpp.
+//   fl::string        fl::base64_encode / hex_encode returning an fl::string
+//                     allocated at its exact size.
+//   string_builder    the sink overload writing into a reused string_builder.
+//   buffer_sink       the sink overload writing in place into a fixed buffer.
+//
+// Decoding rows take the encoded blob as input.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fl.hpp"
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile std::size_t sink_sz;
+static void sink(std::size_t v) { sink_sz = v; }
+
+static constexpr int kRuns = 7;
+static constexpr int kRepeats = 64;
+static constexpr std::size_t kBlobSize = 64 * 1024;
+static constexpr int kHashCalls = 100000;
+
+template <typename Fn>
+static double best_mb_per_s(std::string_view input, Fn&& fn) {
+    double best_ns = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        for (int i = 0; i < kRepeats; ++i) {
+            sink(fn(input));
+        }
+        best_ns = std::min(best_ns, t.elapsed_ns());
+    }
+    return static_cast<double>(input.size()) * kRepeats / best_ns * 1e3;
+}
+
+template <typename Fn>
+static double best_ns_per_call(Fn&& fn) {
+    double best_ns = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        for (int i = 0; i < kHashCalls; ++i) {
+            sink(fn());
+        }
+        best_ns = std::min(best_ns, t.elapsed_ns() / kHashCalls);
+    }
+    return best_ns;
+}
+
+static void report(const char* name, double value, const char* unit) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(value < 100 ? 1 : 0) << value << unit << "\n";
+}
+
+static const char kDigits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static std::size_t scalar_base64_encode(fl::string_builder& out, std::string_view data) {
+    std::size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3) {
+        const std::uint32_t group = static_cast<std::uint32_t>(static_cast<unsigned char>(data[i])) << 16 |
+                                    static_cast<std::uint32_t>(static_cast<unsigned char>(data[i + 1])) << 8 |
+                                    static_cast<unsigned char>(data[i + 2]);
+        out.append(kDigits[group >> 18]);
+        out.append(kDigits[(group >> 12) & 0x3F]);
+        out.append(kDigits[(group >> 6) & 0x3F]);
+        out.append(kDigits[group & 0x3F]);
+    }
+    if (i != data.size()) {
+        const bool two = data.size() - i == 2;
+        const std::uint32_t group = static_cast<std::uint32_t>(static_cast<unsigned char>(data[i])) << 16 |
+                                    (two ? static_cast<std::uint32_t>(static_cast<unsigned char>(data[i + 1])) << 8 : 0);
+        out.append(kDigits[group >> 18]);
+        out.append(kDigits[(group >> 12) & 0x3F]);
+        out.append(two ? kDigits[(group >> 6) & 0x3F] : '=');
+        out.append('=');
+    }
+    return out.size();
+}
+
+static std::size_t scalar_base64_decode(fl::string_builder& out, std::string_view text) {
+    static const auto values = [] {
+        std::array<std::uint8_t, 256> table{};
+        for (std::uint8_t i = 0; i < 64; ++i) {
+            table[static_cast<unsigned char>(kDigits[i])] = i;
+        }
+        return table;
+    }();
+    std::uint32_t bits = 0;
+    int count = 0;
+    for (const char c : text) {
+        if (c == '=') {
+            break;
+        }
+        bits = bits << 6 | values[static_cast<unsigned char>(c)];
+        count += 6;
+        if (count >= 8) {
+            count -= 8;
+            out.append(static_cast<char>(bits >> count));
+        }
+    }
+    return out.size();
+}
+
+static std::size_t scalar_hex_encode(fl::string_builder& out, std::string_view data) {
+    static const char hex[] = "0123456789abcdef";
+    for (const char c : data) {
+        out.append(hex[static_cast<unsigned char>(c) >> 4]);
+        out.append(hex[static_cast<unsigned char>(c) & 0xF]);
+    }
+    return out.size();
+}
+
+static std::size_t scalar_hex_decode(fl::string_builder& out, std::string_view text) {
+    for (std::size_t i = 0; i + 1 < text.size(); i += 2) {
+        out.append(static_cast<char>(fl::detail::hex_digit_value(text[i]) << 4 |
+                                     fl::detail::hex_digit_value(text[i + 1])));
+    }
+    return out.size();
+}
+
+int main() {
+    std::mt19937_64 rng(11);
+    std::string blob(kBlobSize, '\0');
+    for (char& c : blob) {
+        c = static_cast<char>(rng());
+    }
+    const std::string base64 = fl::base64_encode(blob).c_str();
+    const std::string hex = fl::hex_encode(blob).c_str();
+    std::vector<char> buffer(blob.size() * 2);
+    fl::string_builder builder(buffer.size());
+
+    std::cout << "base64 encode (" << blob.size() / 1024 << " KB blob):\n";
+    report("scalar", best_mb_per_s(blob, [&](std::string_view data) {
+        builder.clear();
+        return scalar_base64_encode(builder, data);
+    }), " MB/s");
+    report("fl::string", best_mb_per_s(blob, [&](std::string_view data) {
+        return fl::base64_encode(data).size();
+    }), " MB/s");
+    report("string_builder", best_mb_per_s(blob, [&](std::string_view data) {
+        builder.clear();
+        fl::base64_encode(builder, data);
+        return builder.size();
+    }), " MB/s");
+    report("buffer_sink", best_mb_per_s(blob, [&](std::string_view data) {
+        fl::buffer_sink out(buffer.data(), buffer.size());
+        fl::base64_encode(out, data);
+        return out.written();
+    }), " MB/s");
+
+    std::cout << "base64 decode:\n";
+    report("scalar", best_mb_per_s(base64, [&](std::string_view text) {
+        builder.clear();
+        return scalar_base64_decode(builder, text);
+    }), " MB/s");
+    report("fl::string", best_mb_per_s(base64, [&](std::string_view text) {
+        return fl::base64_decode(text).size();
+    }), " MB/s");
+    report("buffer_sink", best_mb_per_s(base64, [&](std::string_view text) {
+        fl::buffer_sink out(buffer.data(), buffer.size());
+        fl::base64_decode(out, text);
+        return out.written();
+    }), " MB/s");
+
+    std::cout << "hex encode:\n";
+    report("scalar", best_mb_per_s(blob, [&](std::string_view data) {
+        builder.clear();
+        return scalar_hex_encode(builder, data);
+    }), " MB/s");
+    report("fl::string", best_mb_per_s(blob, [&](std::string_view data) {
+        return fl::hex_encode(data).size();
+    }), " MB/s");
+    report("buffer_sink", best_mb_per_s(blob, [&](std::string_view data) {
+        fl::buffer_sink out(buffer.data(), buffer.size());
+        fl::hex_encode(out, data);
+        return out.written();
+    }), " MB/s");
+
+    std::cout << "hex decode:\n";
+    report("scalar", best_mb_per_s(hex, [&](std::string_view text) {
+        builder.clear();
+        return scalar_hex_decode(builder, text);
+    }), " MB/s");
+    report("fl::string", best_mb_per_s(hex, [&](std::string_view text) {
+        return fl::hex_decode(text).size();
+    }), " MB/s");
+    report("buffer_sink", best_mb_per_s(hex, [&](std::string_view text) {
+        fl::buffer_sink out(buffer.data(), buffer.size());
+        fl::hex_decode(out, text);
+        return out.written();
+    }), " MB/s");
+
+    std::array<std::byte, 32> hash;
+    for (std::byte& b : hash) {
+        b = static_cast<std::byte>(rng());
+    }
+    const std::string_view hash_bytes(reinterpret_cast<const char*>(hash.data()), hash.size());
+    std::cout << "32-byte hash to hex, per call:\n";
+    report("scalar", best_ns_per_call([&] {
+        builder.clear();
+        return scalar_hex_encode(builder, hash_bytes);
+    }), " ns");
+    report("hex_encode", best_ns_per_call([&] {
+        builder.clear();
+        fl::hex_encode(builder, hash_bytes);
+        return builder.size();
+    }), " ns");
+    report("format {:x}", best_ns_per_call([&] {
+        builder.clear();
+        fl::format_to(builder, "{:x}", std::span<const std::byte>(hash));
+        return builder.size();
+    }), " ns");
+    return 0;
+}
@@ -0,0 +1,319 @@
+// Benchmark: escaping throughput, in MB/s of input (best of 7 runs, each
+// processing a 64 KB document 64 times).
+//
+// Documents:
+//
+//   clean         log-style ASCII text with some UTF-8 and no byte that needs
+//                 escaping, the common case for JSON string values.
+//   escape-heavy  source code and quoted text, with about one byte in eight
+//                 needing an escape.
+//
+// JSON escaping:
+//
+//   per-char          a switch per byte appending to a string_builder, the way
+//                     callers escaped before fl::json_escape.
+//   json_escape       fl::json_escape into a buffer_sink (sized up front and
+//                     written in place).
+//   json_escape/write fl::json_escape into a sink with write() only, so clean
+//                     runs and escapes are separate writes.
+//   append_json       string_builder::append_json_escaped.
+//
+// JSON unescaping of the escaped document:
+//
+//   per-char          a byte loop decoding escapes into a string_builder.
+//   json_unescape     fl::json_unescape into a buffer_sink.
+//
+// Web payloads, each escaped with a per-char switch into a string_builder and
+// with the fl kernel into a string_builder (sized exactly, one allocation):
+//
+//   comments      user comments for an HTML page: prose with the odd quote,
+//                 apostrophe, ampersand and tag, through html_escape.
+//   query         form values for a query string: words, spaces, punctuation
+//                 and UTF-8, through url_encode and back through url_decode.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fl.hpp"
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile std::size_t sink_sz;
+static void sink(std::size_t v) { sink_sz = v; }
+
+static constexpr int kRuns = 7;
+static constexpr int kRepeats = 64;
+static constexpr std::size_t kDocumentSize = 64 * 1024;
+
+// A sink with only write(), standing in for a socket or stream wrapper.
+struct write_only_sink {
+    char* out;
+    std::size_t size = 0;
+    void write(const char* data, std::size_t len) {
+        std::memcpy(out + size, data, len);
+        size += len;
+    }
+};
+
+template <typename Fn>
+static double best_mb_per_s(std::string_view input, Fn&& fn) {
+    double best_ns = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        for (int i = 0; i < kRepeats; ++i) {
+            sink(fn(input));
+        }
+        best_ns = std::min(best_ns, t.elapsed_ns());
+    }
+    return static_cast<double>(input.size()) * kRepeats / best_ns * 1e3;
+}
+
+static void report(const char* name, double mb_per_s) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(0) << mb_per_s << " MB/s\n";
+}
+
+static std::string make_clean(std::mt19937_64& rng) {
+    const char* words[] = {"request", "user", "latency", "cache", "miss", "ok", "upstream", "caf\xc3\xa9",
+                           "region=eu-west-1", "retry", "status=200", "bytes=4096"};
+    std::string text;
+    while (text.size() < kDocumentSize) {
+        text += words[rng() % 12];
+        text += ' ';
+    }
+    text.resize(kDocumentSize);
+    return text;
+}
+
+static std::string make_heavy(std::mt19937_64& rng) {
+    const char* pieces[] = {"if (x) {\n", "\treturn \"a\\b\";\n", "say \"hello\"", "path\\to\\file", "}\r\n",
+                            "value", " = ", "'quoted'", "\x01\x02"};
+    std::string text;
+    while (text.size() < kDocumentSize) {
+        text += pieces[rng() % 9];
+    }
+    text.resize(kDocumentSize);
+    return text;
+}
+
+static std::size_t per_char_escape(fl::string_builder& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    for (const char c : text) {
+        switch (c) {
+            case '"': out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    const char u[6] = {'\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF]};
+                    out.append(u, 6);
+                } else {
+                    out.append(c);
+                }
+        }
+    }
+    return out.size();
+}
+
+static std::size_t per_char_unescape(fl::string_builder& out, std::string_view text) {
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\') {
+            out.append(text[i]);
+            continue;
+        }
+        const char c = text[++i];
+        switch (c) {
+            case 'n': out.append('\n'); break;
+            case 'r': out.append('\r'); break;
+            case 't': out.append('\t'); break;
+            case 'b': out.append('\b'); break;
+            case 'f': out.append('\f'); break;
+            case 'u': {
+                // Only \u00XX is produced by the escaper.
+                out.append(static_cast<char>(std::stoi(std::string(text.substr(i + 3, 2)), nullptr, 16)));
+                i += 4;
+                break;
+            }
+            default: out.append(c);
+        }
+    }
+    return out.size();
+}
+
+static void run_json(const char* title, const std::string& document) {
+    std::vector<char> buffer(document.size() * 6);
+    fl::string_builder builder(buffer.size());
+
+    std::cout << title << " (" << document.size() / 1024 << " KB):\n";
+    report("per-char", best_mb_per_s(document, [&](std::string_view text) {
+        builder.clear();
+        return per_char_escape(builder, text);
+    }));
+    report("json_escape", best_mb_per_s(document, [&](std::string_view text) {
+        fl::buffer_sink out(buffer.data(), buffer.size());
+        fl::json_escape(out, text);
+        return out.written();
+    }));
+    report("json_escape/write", best_mb_per_s(document, [&](std::string_view text) {
+        write_only_sink out{buffer.data()};
+        fl::json_escape(out, text);
+        return out.size;
+    }));
+    report("append_json", best_mb_per_s(document, [&](std::string_view text) {
+        builder.clear();
+        builder.append_json_escaped(text);
+        return builder.size();
+    }));
+
+    fl::sinks::growing_sink escaped;
+    fl::json_escape(escaped, document);
+    const std::string_view escaped_text(escaped.data(), escaped.size());
+    report("per-char unescape", best_mb_per_s(escaped_text, [&](std::string_view text) {
+        builder.clear();
+        return per_char_unescape(builder, text);
+    }));
+    report("json_unescape", best_mb_per_s(escaped_text, [&](std::string_view text) {
+        fl::buffer_sink out(buffer.data(), buffer.size());
+        fl::json_unescape(out, text);
+        return out.written();
+    }));
+}
+
+static std::string make_comments(std::mt19937_64& rng) {
+    const char* words[] = {"great", "post", "thanks", "I", "don't", "agree", "with", "\"this\"", "Tom & Jerry",
+                           "<b>really</b>", "see", "the", "docs", "na\xc3\xafve", "approach", "works", "fine"};
+    std::string text;
+    while (text.size() < kDocumentSize) {
+        text += words[rng() % 17];
+        text += rng() % 12 == 0 ? ". " : " ";
+    }
+    text.resize(kDocumentSize);
+    return text;
+}
+
+static std::string make_query(std::mt19937_64& rng) {
+    const char* words[] = {"search", "terms", "caf\xc3\xa9", "new york", "a+b", "50%", "q=1", "path/to", "x_y",
+                           "hello world", "page-2", "~user"};
+    std::string text;
+    while (text.size() < kDocumentSize) {
+        text += words[rng() % 12];
+        text += ' ';
+    }
+    text.resize(kDocumentSize);
+    return text;
+}
+
+static std::size_t per_char_html(fl::string_builder& out, std::string_view text) {
+    for (const char c : text) {
+        switch (c) {
+            case '&': out.append("&amp;", 5); break;
+            case '<': out.append("&lt;", 4); break;
+            case '>': out.append("&gt;", 4); break;
+            case '"': out.append("&quot;", 6); break;
+            case '\'': out.append("&#39;", 5); break;
+            default: out.append(c);
+        }
+    }
+    return out.size();
+}
+
+static std::size_t per_char_url_encode(fl::string_builder& out, std::string_view text) {
+    static const char hex[] = "0123456789ABCDEF";
+    for (const char c : text) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u) || c == '-' || c == '.' || c == '_' || c == '~') {
+            out.append(c);
+        } else {
+            const char escaped[3] = {'%', hex[u >> 4], hex[u & 0xF]};
+            out.append(escaped, 3);
+        }
+    }
+    return out.size();
+}
+
+static std::size_t per_char_url_decode(fl::string_builder& out, std::string_view text) {
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%') {
+            out.append(static_cast<char>(std::stoi(std::string(text.substr(i + 1, 2)), nullptr, 16)));
+            i += 2;
+        } else {
+            out.append(text[i]);
+        }
+    }
+    return out.size();
+}
+
+static void run_web(const std::string& comments, const std::string& query) {
+    fl::string_builder builder(comments.size() * 6);
+
+    std::cout << "comments, HTML (" << comments.size() / 1024 << " KB):\n";
+    report("per-char", best_mb_per_s(comments, [&](std::string_view text) {
+        builder.clear();
+        return per_char_html(builder, text);
+    }));
+    report("html_escape", best_mb_per_s(comments, [&](std::string_view text) {
+        fl::string_builder out;
+        fl::html_escape(out, text);
+        return out.size();
+    }));
+
+    std::cout << "query, URL (" << query.size() / 1024 << " KB):\n";
+    report("per-char encode", best_mb_per_s(query, [&](std::string_view text) {
+        builder.clear();
+        return per_char_url_encode(builder, text);
+    }));
+    report("url_encode", best_mb_per_s(query, [&](std::string_view text) {
+        fl::string_builder out;
+        fl::url_encode(out, text);
+        return out.size();
+    }));
+
+    fl::string_builder encoded;
+    fl::url_encode(encoded, query);
+    const std::string_view encoded_text(encoded.data(), encoded.size());
+    report("per-char decode", best_mb_per_s(encoded_text, [&](std::string_view text) {
+        builder.clear();
+        return per_char_url_decode(builder, text);
+    }));
+    report("url_decode", best_mb_per_s(encoded_text, [&](std::string_view text) {
+        fl::string_builder out;
+        fl::url_decode(out, text);
+        return out.size();
+    }));
+}
+
+int main() {
+    std::mt19937_64 rng(7);
+    const std::string clean = make_clean(rng);
+    const std::string heavy = make_heavy(rng);
+
+    std::cout << "JSON string escaping\n";
+    run_json("clean", clean);
+    run_json("escape-heavy", heavy);
+
+    std::cout << "\nWeb payloads\n";
+    run_web(make_comments(rng), make_query(rng));
+    return 0;
+}
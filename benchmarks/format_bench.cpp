@@ -0,0 +1,148 @@
+// Benchmark: per-call cost of fl::format_to on log-line shaped format strings.
+//
+// Each case formats the same arguments into a reused stack buffer:
+//
+//   checked literal  fl::format_to(sink, "...", args...)    compile-time checked,
+//                    formatted through the type-erased vformat_to engine.
+//   static (_fmt)    fl::format_to(sink, "..."_fmt, args...) parsed at compile
+//                    time and expanded into straight-line code.
+//   runtime          fl::format_to(sink, fl::runtime_format(s), args...).
+//   compiled_format  the same runtime string parsed once into an
+//                    fl::compiled_format and rendered per call.
+//   via output_sink& the checked call through a polymorphic sink reference,
+//                    as before formatting was templated on the sink type.
+//   snprintf         the equivalent printf-style call, for reference.
+//
+// A second group produces an owned fl::string from the same call:
+//
+//   fl::format          sizes the output, then writes it into the string's SSO
+//                       buffer or one exact-size block.
+//   growing + copy      the 1.0.0 route: format into a growing sink and copy
+//                       the result out with to_fl_string().
+//   growing + take      the same sink, its buffer handed to the string with
+//                       take() instead of copied.
+//   fl::format (_fmt)   fl::format with a static format string.
+//
+// Reported as nanoseconds per call (best of 5 runs).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "fl.hpp"
+
+using namespace fl::literals;
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile std::size_t sink_sz;
+static void sink(std::size_t v) { sink_sz = v; }
+
+static constexpr int kIterations = 1'000'000;
+static constexpr int kRuns = 5;
+
+template <typename Fn>
+static double best_ns_per_call(Fn&& fn) {
+    double best = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        for (int i = 0; i < kIterations; ++i) {
+            sink(fn(i));
+        }
+        best = std::min(best, t.elapsed_ns() / kIterations);
+    }
+    return best;
+}
+
+static void report(const char* name, double ns) {
+    std::cout << "  " << std::left << std::setw(20) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << ns << " ns/call\n";
+}
+
+int main() {
+    char buffer[256];
+    const char* level = "INFO";
+    const char* user = "alice";
+    const std::string runtime_fmt = "[{}] request user={} id={} bytes={:>8} status={}";
+
+    std::cout << "Log line: \"" << runtime_fmt << "\"\n";
+
+    report("checked literal", best_ns_per_call([&](int i) {
+        fl::buffer_sink s(buffer, sizeof(buffer));
+        fl::format_to(s, "[{}] request user={} id={} bytes={:>8} status={}", level, user, i, 4096u + i, 200);
+        return s.written();
+    }));
+
+    report("static (_fmt)", best_ns_per_call([&](int i) {
+        fl::buffer_sink s(buffer, sizeof(buffer));
+        fl::format_to(s, "[{}] request user={} id={} bytes={:>8} status={}"_fmt, level, user, i, 4096u + i, 200);
+        return s.written();
+    }));
+
+    report("runtime", best_ns_per_call([&](int i) {
+        fl::buffer_sink s(buffer, sizeof(buffer));
+        fl::format_to(s, fl::runtime_format(runtime_fmt), level, user, i, 4096u + i, 200);
+        return s.written();
+    }));
+
+    const fl::compiled_format compiled(runtime_fmt);
+    report("compiled_format", best_ns_per_call([&](int i) {
+        fl::buffer_sink s(buffer, sizeof(buffer));
+        fl::format_to(s, compiled, level, user, i, 4096u + i, 200);
+        return s.written();
+    }));
+
+    report("via output_sink&", best_ns_per_call([&](int i) {
+        fl::buffer_sink s(buffer, sizeof(buffer));
+        fl::sinks::output_sink& base = s;
+        fl::format_to(base, "[{}] request user={} id={} bytes={:>8} status={}", level, user, i, 4096u + i, 200);
+        return s.written();
+    }));
+
+    report("snprintf", best_ns_per_call([&](int i) {
+        int n = std::snprintf(buffer, sizeof(buffer), "[%s] request user=%s id=%d bytes=%8u status=%d",
+                              level, user, i, 4096u + i, 200);
+        return static_cast<std::size_t>(n);
+    }));
+
+    std::cout << "\nOwned fl::string result:\n";
+
+    report("fl::format", best_ns_per_call([&](int i) {
+        fl::string out = fl::format("[{}] request user={} id={} bytes={:>8} status={}", level, user, i, 4096u + i, 200);
+        return out.size();
+    }));
+
+    report("growing + copy", best_ns_per_call([&](int i) {
+        fl::sinks::growing_sink g;
+        fl::vformat_to(g, runtime_fmt, fl::make_format_args(level, user, i, 4096u + i, 200));
+        fl::string out = g.to_fl_string();
+        return out.size();
+    }));
+
+    report("growing + take", best_ns_per_call([&](int i) {
+        fl::sinks::growing_sink g;
+        fl::vformat_to(g, runtime_fmt, fl::make_format_args(level, user, i, 4096u + i, 200));
+        fl::string out = g.take();
+        return out.size();
+    }));
+
+    report("fl::format (_fmt)", best_ns_per_call([&](int i) {
+        fl::string out =
+            fl::format("[{}] request user={} id={} bytes={:>8} status={}"_fmt, level, user, i, 4096u + i, 200);
+        return out.size();
+    }));
+
+    return 0;
+}
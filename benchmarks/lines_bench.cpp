@@ -0,0 +1,158 @@
+// Benchmark: splitting a large buffer into lines, in GB/s of input (best of
+// 5 runs over a 64 MB buffer).
+//
+// Inputs, each 64 MB:
+//
+//   short lines   4-28 byte lines (key=value pairs, CSV rows of numbers).
+//   log lines     60-140 byte lines, as a typical application log.
+//   long lines    about 1-2 KB per line (JSON records, stack traces).
+//
+// Each input alternates LF and CRLF line endings. Every row sums the line
+// lengths, so each line is touched.
+//
+// Rows:
+//
+//   find loop       std::string_view::find('\n', pos) per line, stripping
+//                   '\r' by hand.
+//   memchr loop     memchr per line.
+//   fl::lines       range-for over fl::lines(text).
+//   for_each_line   fl::for_each_line(text, fn).
+//   rope            fl::for_each_line over an fl::rope of the same text in
+//                   64 KB leaves.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "fl.hpp"
+#include "fl/lines.hpp"
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile std::size_t sink_sz;
+static void sink(std::size_t v) { sink_sz = v; }
+
+static constexpr int kRuns = 5;
+static constexpr std::size_t kInputSize = 64 * 1024 * 1024;
+static constexpr std::size_t kLeafSize = 64 * 1024;
+
+template <typename Fn>
+static double best_gb_per_s(std::size_t bytes, Fn&& fn) {
+    double best_ns = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        sink(fn());
+        best_ns = std::min(best_ns, t.elapsed_ns());
+    }
+    return static_cast<double>(bytes) / best_ns;
+}
+
+static void report(const char* name, double value) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(2) << value << " GB/s\n";
+}
+
+static std::string make_input(std::size_t min_line, std::size_t max_line, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::string text;
+    text.reserve(kInputSize + max_line + 2);
+    bool crlf = false;
+    while (text.size() < kInputSize) {
+        const std::size_t size = min_line + rng() % (max_line - min_line + 1);
+        for (std::size_t i = 0; i < size; ++i) {
+            text.push_back(static_cast<char>('!' + rng() % 94));
+        }
+        text += crlf ? "\r\n" : "\n";
+        crlf = !crlf;
+    }
+    return text;
+}
+
+static std::size_t find_loop(std::string_view text) {
+    std::size_t total = 0;
+    std::size_t start = 0;
+    while (start < text.size()) {
+        std::size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::size_t size = end - start;
+        if (size != 0 && end != text.size() && text[end - 1] == '\r') {
+            --size;
+        }
+        total += size;
+        start = end + 1;
+    }
+    return total;
+}
+
+static std::size_t memchr_loop(std::string_view text) {
+    std::size_t total = 0;
+    const char* p = text.data();
+    const char* const last = p + text.size();
+    while (p < last) {
+        const char* end = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(last - p)));
+        if (end == nullptr) {
+            total += static_cast<std::size_t>(last - p);
+            break;
+        }
+        total += static_cast<std::size_t>(end - p) - (end != p && end[-1] == '\r');
+        p = end + 1;
+    }
+    return total;
+}
+
+int main() {
+    struct input {
+        const char* name;
+        std::string text;
+    };
+    const input inputs[] = {
+        {"short lines", make_input(4, 28, 1)},
+        {"log lines", make_input(60, 140, 2)},
+        {"long lines", make_input(1024, 2048, 3)},
+    };
+
+    for (const input& in : inputs) {
+        const std::string_view text = in.text;
+        fl::rope rope;
+        for (std::size_t at = 0; at < text.size(); at += kLeafSize) {
+            rope += fl::rope(text.substr(at, kLeafSize));
+        }
+        std::cout << in.name << " (" << text.size() / (1024 * 1024) << " MB):\n";
+        report("find loop", best_gb_per_s(text.size(), [&] { return find_loop(text); }));
+        report("memchr loop", best_gb_per_s(text.size(), [&] { return memchr_loop(text); }));
+        report("fl::lines", best_gb_per_s(text.size(), [&] {
+            std::size_t total = 0;
+            for (const std::string_view line : fl::lines(text)) {
+                total += line.size();
+            }
+            return total;
+        }));
+        report("for_each_line", best_gb_per_s(text.size(), [&] {
+            std::size_t total = 0;
+            fl::for_each_line(text, [&](std::string_view line) { total += line.size(); });
+            return total;
+        }));
+        report("rope", best_gb_per_s(text.size(), [&] {
+            std::size_t total = 0;
+            fl::for_each_line(rope, [&](std::string_view line) { total += line.size(); });
+            return total;
+        }));
+    }
+    return 0;
+}
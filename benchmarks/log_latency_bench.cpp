@@ -0,0 +1,103 @@
+// Benchmark: latency of one fl::log call as seen by the logging thread.
+//
+// Each case times 200,000 calls of
+//
+//   log.info("request {} user={} bytes={:>8} status={}", id, user, bytes, status)
+//
+// individually with steady_clock and reports percentiles. The ring is sized to
+// hold the whole burst, so the numbers are the hot-path cost of encoding the
+// arguments rather than of waiting for the logger thread:
+//
+//   fl::log -> null_sink      records formatted and discarded in the background.
+//   fl::log -> file_sink      records formatted and written to a temporary file.
+//   format_to(file_sink)      the same line formatted and written synchronously
+//                             on the calling thread, for reference.
+//
+// Timer overhead (an empty timed region) is reported separately and is
+// included in every figure.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "fl.hpp"
+#include "fl/log.hpp"
+
+static constexpr std::size_t kCalls = 200'000;
+
+using clock_type = std::chrono::steady_clock;
+
+static void report(const char* name, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1))]; };
+    std::cout << "  " << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(8) << at(0.50) << std::setw(8) << at(0.99) << std::setw(9) << at(0.999)
+              << std::setw(10) << samples.back() << "\n";
+}
+
+template <typename Fn>
+static std::vector<double> time_calls(Fn&& fn) {
+    std::vector<double> samples(kCalls);
+    for (std::size_t i = 0; i < kCalls; ++i) {
+        const auto t0 = clock_type::now();
+        fn(i);
+        const auto t1 = clock_type::now();
+        samples[i] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+    return samples;
+}
+
+static fl::log::options bench_options() {
+    fl::log::options opts;
+    opts.ring_capacity = std::size_t{64} << 20;
+    return opts;
+}
+
+int main() {
+    const char* user = "alice";
+
+    std::cout << "Per-call latency, ns:     " << std::setw(8) << "p50" << std::setw(8) << "p99" << std::setw(9)
+              << "p99.9" << std::setw(10) << "max" << "\n";
+
+    auto empty = time_calls([](std::size_t) {});
+    report("timer overhead", empty);
+
+    {
+        fl::sinks::null_sink sink;
+        fl::log::logger log(sink, bench_options());
+        log.info("warm-up {}", 0);
+        log.flush();
+        auto samples = time_calls([&](std::size_t i) {
+            log.info("request {} user={} bytes={:>8} status={}", i, user, 4096u + i, 200);
+        });
+        log.flush();
+        report("fl::log -> null_sink", samples);
+    }
+
+    {
+        fl::sinks::file_sink sink(std::tmpfile(), true);
+        fl::log::logger log(sink, bench_options());
+        log.info("warm-up {}", 0);
+        log.flush();
+        auto samples = time_calls([&](std::size_t i) {
+            log.info("request {} user={} bytes={:>8} status={}", i, user, 4096u + i, 200);
+        });
+        log.flush();
+        report("fl::log -> file_sink", samples);
+    }
+
+    {
+        fl::sinks::file_sink sink(std::tmpfile(), true);
+        auto samples = time_calls([&](std::size_t i) {
+            fl::format_to(sink, "[info] request {} user={} bytes={:>8} status={}\n", i, user, 4096u + i, 200);
+        });
+        sink.flush();
+        report("format_to(file_sink)", samples);
+    }
+
+    return 0;
+}
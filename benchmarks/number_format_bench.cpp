@@ -0,0 +1,220 @@
+// Benchmark: number-to-text conversion throughput.
+//
+// Integers (ns per value, best of 5 runs over a 64K-value array):
+//
+//   legacy          the 1.0.0 algorithm: one '% 10' per digit into a temp
+//                   buffer followed by std::reverse_copy.
+//   fl              fl::detail::integer_formatter: countl_zero digit count and
+//                   a 00-99 pair table, written straight into the destination.
+//   std::to_chars   the standard library's implementation.
+//   snprintf        "%llu" / "%llx", for reference.
+//
+// Value distributions: small (0-99, typical counters), mixed (uniformly
+// random bit length, typical metrics), and large (full 64-bit values).
+//
+// Floating point (ns per value, same method):
+//
+//   fl              fl::detail::float_formatter.
+//   std::to_chars   the standard library's implementation.
+//   snprintf        "%.17g" for shortest (the nearest printf equivalent that
+//                   round-trips), "%.2f" / "%.6e" for fixed precision.
+//
+// Value distributions: prices (two decimal places, typical of metrics and
+// money), random (uniform random finite bit patterns, 17 significant digits)
+// and float (random single-precision values, shortest only).
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "fl.hpp"
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile std::size_t sink_sz;
+static void sink(std::size_t v) { sink_sz = v; }
+
+static constexpr int kRuns = 5;
+static constexpr std::size_t kValues = 1 << 16;
+
+// The 1.0.0 formatter, kept here as the baseline.
+static std::size_t legacy_format_uint64(char* buffer, uint64_t value) {
+    if (value == 0) {
+        buffer[0] = '0';
+        return 1;
+    }
+    char temp[20];
+    std::size_t len = 0;
+    while (value > 0) {
+        temp[len++] = static_cast<char>('0' + (value % 10));
+        value /= 10;
+    }
+    std::reverse_copy(temp, temp + len, buffer);
+    return len;
+}
+
+template <typename T, typename Fn>
+static double best_ns_per_value(const std::vector<T>& values, Fn&& fn) {
+    char buffer[80];
+    double best = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        std::size_t total = 0;
+        Timer t;
+        for (T v : values) {
+            total += fn(buffer, v);
+        }
+        sink(total);
+        best = std::min(best, t.elapsed_ns() / static_cast<double>(values.size()));
+    }
+    return best;
+}
+
+static void header(const char* title) {
+    std::cout << "\n" << title << "\n"
+              << "  " << std::left << std::setw(16) << "distribution"
+              << std::right << std::setw(10) << "legacy" << std::setw(10) << "fl"
+              << std::setw(12) << "to_chars" << std::setw(12) << "snprintf" << "   (ns/value)\n";
+}
+
+static void row(const char* name, double legacy, double fl_ns, double to_chars_ns, double snprintf_ns) {
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << legacy << std::setw(10) << fl_ns << std::setw(12) << to_chars_ns
+              << std::setw(12) << snprintf_ns << "\n";
+}
+
+static void bench_integers() {
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> small(kValues), mixed(kValues), large(kValues);
+    for (std::size_t i = 0; i < kValues; ++i) {
+        small[i] = rng() % 100;
+        mixed[i] = rng() >> (rng() % 64);
+        large[i] = rng() | (uint64_t{1} << 63);
+    }
+
+    header("Unsigned decimal");
+    for (auto [name, values] : {std::pair{"small", &small}, std::pair{"mixed", &mixed}, std::pair{"large", &large}}) {
+        row(name,
+            best_ns_per_value(*values, [](char* b, uint64_t v) { return legacy_format_uint64(b, v); }),
+            best_ns_per_value(*values, [](char* b, uint64_t v) {
+                return fl::detail::integer_formatter::format_uint64(b, 80, v);
+            }),
+            best_ns_per_value(*values, [](char* b, uint64_t v) {
+                return static_cast<std::size_t>(std::to_chars(b, b + 80, v).ptr - b);
+            }),
+            best_ns_per_value(*values, [](char* b, uint64_t v) {
+                return static_cast<std::size_t>(std::snprintf(b, 80, "%llu", static_cast<unsigned long long>(v)));
+            }));
+    }
+
+    header("Hexadecimal (legacy column: 1.0.0 '% base' loop)");
+    for (auto [name, values] : {std::pair{"mixed", &mixed}, std::pair{"large", &large}}) {
+        row(name,
+            best_ns_per_value(*values, [](char* b, uint64_t v) {
+                char temp[20];
+                std::size_t len = 0;
+                do {
+                    temp[len++] = "0123456789abcdef"[v % 16];
+                    v /= 16;
+                } while (v);
+                std::reverse_copy(temp, temp + len, b);
+                return len;
+            }),
+            best_ns_per_value(*values, [](char* b, uint64_t v) {
+                return static_cast<std::size_t>(fl::detail::integer_formatter::write_pow2(b, v, 4) - b);
+            }),
+            best_ns_per_value(*values, [](char* b, uint64_t v) {
+                return static_cast<std::size_t>(std::to_chars(b, b + 80, v, 16).ptr - b);
+            }),
+            best_ns_per_value(*values, [](char* b, uint64_t v) {
+                return static_cast<std::size_t>(std::snprintf(b, 80, "%llx", static_cast<unsigned long long>(v)));
+            }));
+    }
+}
+
+static void float_header(const char* title) {
+    std::cout << "\n" << title << "\n"
+              << "  " << std::left << std::setw(16) << "distribution"
+              << std::right << std::setw(10) << "fl" << std::setw(12) << "to_chars"
+              << std::setw(12) << "snprintf" << "   (ns/value)\n";
+}
+
+static void float_row(const char* name, double fl_ns, double to_chars_ns, double snprintf_ns) {
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << fl_ns << std::setw(12) << to_chars_ns << std::setw(12) << snprintf_ns << "\n";
+}
+
+static void bench_floats() {
+    using fl::detail::float_formatter;
+    std::mt19937_64 rng(7);
+    std::vector<double> prices(kValues), random(kValues);
+    std::vector<float> floats(kValues);
+    for (std::size_t i = 0; i < kValues; ++i) {
+        prices[i] = static_cast<double>(rng() % 1000000) / 100.0;
+        do {
+            const uint64_t bits = rng();
+            std::memcpy(&random[i], &bits, sizeof(double));
+        } while (!(random[i] == random[i]) || random[i] - random[i] != 0);  // Finite only.
+        do {
+            const uint32_t bits = static_cast<uint32_t>(rng());
+            std::memcpy(&floats[i], &bits, sizeof(float));
+        } while (!(floats[i] == floats[i]) || floats[i] - floats[i] != 0);
+    }
+
+    float_header("Shortest round-trip");
+    for (auto [name, values] : {std::pair{"prices", &prices}, std::pair{"random", &random}}) {
+        float_row(name,
+                  best_ns_per_value(*values, [](char* b, double v) { return float_formatter::format_shortest(b, v); }),
+                  best_ns_per_value(*values, [](char* b, double v) {
+                      return static_cast<std::size_t>(std::to_chars(b, b + 80, v).ptr - b);
+                  }),
+                  best_ns_per_value(*values, [](char* b, double v) {
+                      return static_cast<std::size_t>(std::snprintf(b, 80, "%.17g", v));
+                  }));
+    }
+    float_row("float",
+              best_ns_per_value(floats, [](char* b, float v) { return float_formatter::format_shortest(b, v); }),
+              best_ns_per_value(floats, [](char* b, float v) {
+                  return static_cast<std::size_t>(std::to_chars(b, b + 80, v).ptr - b);
+              }),
+              best_ns_per_value(floats, [](char* b, float v) {
+                  return static_cast<std::size_t>(std::snprintf(b, 80, "%.9g", static_cast<double>(v)));
+              }));
+
+    float_header("Fixed precision");
+    for (auto [name, values] : {std::pair{"prices .2f", &prices}, std::pair{"random .6e", &random}}) {
+        const bool fixed = values == &prices;
+        float_row(name,
+                  best_ns_per_value(*values, [fixed](char* b, double v) {
+                      return fixed ? float_formatter::format_fixed(b, 80, v, 2)
+                                   : float_formatter::format_scientific(b, 80, v, 6);
+                  }),
+                  best_ns_per_value(*values, [fixed](char* b, double v) {
+                      const auto format = fixed ? std::chars_format::fixed : std::chars_format::scientific;
+                      return static_cast<std::size_t>(std::to_chars(b, b + 80, v, format, fixed ? 2 : 6).ptr - b);
+                  }),
+                  best_ns_per_value(*values, [fixed](char* b, double v) {
+                      return static_cast<std::size_t>(std::snprintf(b, 80, fixed ? "%.2f" : "%.6e", v));
+                  }));
+    }
+}
+
+int main() {
+    bench_integers();
+    bench_floats();
+    return 0;
+}
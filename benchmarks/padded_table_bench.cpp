@@ -0,0 +1,192 @@
+// Benchmark: rendering a padded text table, one fl::format_to call per row.
+//
+// Each row is "{:<18}|{:>12}|{:>10.2f}|{:^8}|{:>6}\n": a left-aligned name, a
+// right-aligned count, a fixed-precision ratio, a centred status string and a
+// right-aligned flag character. 4,096 rows are rendered into a reused buffer.
+//
+// Padding only (specs parsed once, same digit generation on both sides):
+//
+//   temp + per-char  the 1.0.0 route: each padded non-numeric argument is
+//                    formatted into a fresh growing sink first, and every fill
+//                    character is its own virtual write.
+//   bulk fills       fl::detail::format_one: padding computed from the known
+//                    length and written as bulk fills into the destination.
+//
+// Whole rows:
+//
+//   fl::format_to    checked literal format string (parsed per call).
+//   static (_fmt)    compile-time format string.
+//   snprintf         "%-18s|%12llu|%10.2f|%*s%s%*s|%6c", centring by hand.
+//
+// Reported as nanoseconds per row (best of 5 runs).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fl.hpp"
+
+using namespace fl::literals;
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile std::size_t sink_sz;
+static void sink(std::size_t v) { sink_sz = v; }
+
+static constexpr int kRuns = 5;
+static constexpr std::size_t kRows = 4096;
+
+struct row {
+    std::string name;
+    std::uint64_t count;
+    double ratio;
+    const char* status;
+    char flag;
+};
+
+template <typename Fn>
+static double best_ns_per_row(const std::vector<row>& rows, Fn&& fn) {
+    static char buffer[kRows * 80];
+    double best = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        fl::buffer_sink out(buffer, sizeof(buffer));
+        for (const row& r : rows) {
+            fn(out, r);
+        }
+        sink(out.written());
+        best = std::min(best, t.elapsed_ns() / static_cast<double>(rows.size()));
+    }
+    return best;
+}
+
+static void report(const char* name, double ns) {
+    std::cout << "  " << std::left << std::setw(18) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << ns << " ns/row\n";
+}
+
+// The 1.0.0 padded-text path: format into a temporary growing sink, then pad
+// one character per virtual write.
+static void legacy_padded_text(fl::sinks::output_sink& out, const char* text, std::size_t width, char align) {
+    fl::sinks::growing_sink temp;
+    temp.write(text, std::strlen(text));
+    const std::string_view s(temp.data(), temp.size());
+    const std::size_t padding = s.size() < width ? width - s.size() : 0;
+    const std::size_t left = align == '>' ? padding : align == '^' ? (padding + 1) / 2 : 0;
+    const char fill = ' ';
+    for (std::size_t i = 0; i < left; ++i) out.write(&fill, 1);
+    out.write(s.data(), s.size());
+    for (std::size_t i = left; i < padding; ++i) out.write(&fill, 1);
+}
+
+// The 1.0.0 numeric path: digits into a stack buffer, padding one character
+// per virtual write.
+static void legacy_padded_digits(fl::sinks::output_sink& out, const char* digits, std::size_t len, std::size_t width) {
+    const char fill = ' ';
+    for (std::size_t i = len; i < width; ++i) out.write(&fill, 1);
+    out.write(digits, len);
+}
+
+static void legacy_row(fl::sinks::output_sink& out, const row& r) {
+    char digits[64];
+    legacy_padded_text(out, r.name.c_str(), 18, '<');
+    out.write("|", 1);
+    legacy_padded_digits(out, digits, fl::detail::integer_formatter::format_uint64(digits, sizeof(digits), r.count), 12);
+    out.write("|", 1);
+    legacy_padded_digits(out, digits,
+                         fl::detail::float_formatter::format_fixed(digits, sizeof(digits), r.ratio, 2), 10);
+    out.write("|", 1);
+    legacy_padded_text(out, r.status, 8, '^');
+    out.write("|", 1);
+    const char flag[2] = {r.flag, '\0'};
+    legacy_padded_text(out, flag, 6, '>');
+    out.write("\n", 1);
+}
+
+static fl::detail::format_spec parse_spec(const char* text) {
+    fl::detail::format_spec spec;
+    fl::detail::format_spec::parse(text, text + std::strlen(text), spec);
+    return spec;
+}
+
+static const fl::detail::format_spec name_spec = parse_spec("<18");
+static const fl::detail::format_spec count_spec = parse_spec(">12");
+static const fl::detail::format_spec ratio_spec = parse_spec(">10.2f");
+static const fl::detail::format_spec status_spec = parse_spec("^8");
+static const fl::detail::format_spec flag_spec = parse_spec(">6");
+
+static void bulk_row(fl::buffer_sink& out, const row& r) {
+    fl::detail::format_one(out, std::string_view(r.name), &name_spec);
+    out.put('|');
+    fl::detail::format_one(out, r.count, &count_spec);
+    out.put('|');
+    fl::detail::format_one(out, r.ratio, &ratio_spec);
+    out.put('|');
+    fl::detail::format_one(out, std::string_view(r.status), &status_spec);
+    out.put('|');
+    fl::detail::format_one(out, r.flag, &flag_spec);
+    out.put('\n');
+}
+
+int main() {
+    std::mt19937_64 rng(11);
+    const char* names[] = {"ingest", "parse-headers", "auth", "route", "render-template", "compress", "db"};
+    const char* statuses[] = {"ok", "warn", "failed", "retry"};
+    std::vector<row> rows(kRows);
+    for (row& r : rows) {
+        r.name = std::string(names[rng() % 7]) + "-" + std::to_string(rng() % 100);
+        r.count = rng() % 10'000'000;
+        r.ratio = static_cast<double>(rng() % 100000) / 1000.0;
+        r.status = statuses[rng() % 4];
+        r.flag = "YN-"[rng() % 3];
+    }
+
+    std::cout << "Padded table row: \"{:<18}|{:>12}|{:>10.2f}|{:^8}|{:>6}\"\n";
+
+    std::cout << "Padding only:\n";
+    report("temp + per-char", best_ns_per_row(rows, [](fl::buffer_sink& out, const row& r) {
+        legacy_row(out, r);
+    }));
+    report("bulk fills", best_ns_per_row(rows, [](fl::buffer_sink& out, const row& r) {
+        bulk_row(out, r);
+    }));
+
+    std::cout << "\nWhole rows:\n";
+
+    report("fl::format_to", best_ns_per_row(rows, [](fl::buffer_sink& out, const row& r) {
+        fl::format_to(out, "{:<18}|{:>12}|{:>10.2f}|{:^8}|{:>6}\n", r.name, r.count, r.ratio, r.status, r.flag);
+    }));
+
+    report("static (_fmt)", best_ns_per_row(rows, [](fl::buffer_sink& out, const row& r) {
+        fl::format_to(out, "{:<18}|{:>12}|{:>10.2f}|{:^8}|{:>6}\n"_fmt, r.name, r.count, r.ratio, r.status, r.flag);
+    }));
+
+    report("snprintf", best_ns_per_row(rows, [](fl::buffer_sink& out, const row& r) {
+        const std::size_t len = std::strlen(r.status);
+        const int left = static_cast<int>((8 - len + 1) / 2);
+        const int right = static_cast<int>(8 - len) - left;
+        const auto n = std::snprintf(out.buffer() + out.written(), out.available(),
+                                     "%-18s|%12llu|%10.2f|%*s%s%*s|%6c\n", r.name.c_str(),
+                                     static_cast<unsigned long long>(r.count), r.ratio, left, "", r.status,
+                                     right, "", r.flag);
+        out.commit(static_cast<std::size_t>(n));
+    }));
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+// Benchmark: number parsing throughput, in ns per value (best of 7 runs, each
+// parsing the whole input set 16 times), and a CSV column end to end in MB/s.
+//
+// Inputs:
+//
+//   integers     100k int64 values of uniformly random digit count (1-19),
+//                half of them negative.
+//   doubles      100k random doubles printed shortest round-trip (to_chars).
+//   csv column   the same doubles joined with ',' into one 100k-field line.
+//
+// Rows:
+//
+//   strtod/strtoll   the C library, on a NUL-terminated copy of each field.
+//   from_chars       std::from_chars, the library's reference.
+//   fl::parse        fl::parse_prefix, the non-throwing core of fl::parse.
+//   parse_column     fl::parse_column into a reused std::vector.
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fl.hpp"
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile double sink_value;
+static void sink(double v) { sink_value = v; }
+
+static constexpr int kRuns = 7;
+static constexpr int kRepeats = 16;
+static constexpr std::size_t kValues = 100000;
+
+// Best time over kRuns of kRepeats passes of fn(), divided by work units.
+template <typename Fn>
+static double best_ns(double units, Fn&& fn) {
+    double best = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        for (int i = 0; i < kRepeats; ++i) {
+            sink(fn());
+        }
+        best = std::min(best, t.elapsed_ns());
+    }
+    return best / (units * kRepeats);
+}
+
+static void report(const char* name, double value, const char* unit) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(value < 100 ? 1 : 0) << value << unit << "\n";
+}
+
+// Each field as a NUL-terminated string, so the C parsers see the same text.
+static std::vector<std::string> to_fields(const std::vector<std::string_view>& views) {
+    return std::vector<std::string>(views.begin(), views.end());
+}
+
+int main() {
+    std::mt19937_64 rng(21);
+    std::string storage;
+    storage.reserve(kValues * 48);
+    std::vector<std::size_t> int_offsets;
+    std::vector<std::size_t> double_offsets;
+    char buffer[64];
+
+    for (std::size_t i = 0; i < kValues; ++i) {
+        std::int64_t value = static_cast<std::int64_t>(rng() % 1000000000000000000ull);
+        const unsigned digits = 1 + static_cast<unsigned>(rng() % 19);
+        std::int64_t limit = 1;
+        for (unsigned d = 0; d < digits && limit <= INT64_MAX / 10; ++d) {
+            limit *= 10;
+        }
+        value %= limit;
+        if (rng() & 1) {
+            value = -value;
+        }
+        const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        int_offsets.push_back(storage.size());
+        storage.append(buffer, end);
+        storage.push_back('\0');
+    }
+    std::string csv;
+    std::uniform_real_distribution<double> mantissa(1.0, 10.0);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    for (std::size_t i = 0; i < kValues; ++i) {
+        const double value = mantissa(rng) * std::pow(10.0, exponent(rng)) * (rng() & 1 ? 1 : -1);
+        const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        double_offsets.push_back(storage.size());
+        storage.append(buffer, end);
+        storage.push_back('\0');
+        if (i != 0) {
+            csv.push_back(',');
+        }
+        csv.append(buffer, end);
+    }
+
+    std::vector<std::string_view> ints;
+    for (const std::size_t offset : int_offsets) {
+        ints.emplace_back(storage.data() + offset);
+    }
+    std::vector<std::string_view> doubles;
+    for (const std::size_t offset : double_offsets) {
+        doubles.emplace_back(storage.data() + offset);
+    }
+    const std::vector<std::string> int_fields = to_fields(ints);
+    const std::vector<std::string> double_fields = to_fields(doubles);
+
+    std::cout << "int64 (" << kValues / 1000 << "k values, 1-19 digits), per value:\n";
+    report("strtoll", best_ns(kValues, [&] {
+        double total = 0;
+        for (const std::string& field : int_fields) {
+            total += static_cast<double>(std::strtoll(field.c_str(), nullptr, 10));
+        }
+        return total;
+    }), " ns");
+    report("from_chars", best_ns(kValues, [&] {
+        double total = 0;
+        for (const std::string_view text : ints) {
+            std::int64_t value = 0;
+            std::from_chars(text.data(), text.data() + text.size(), value);
+            total += static_cast<double>(value);
+        }
+        return total;
+    }), " ns");
+    report("fl::parse", best_ns(kValues, [&] {
+        double total = 0;
+        for (const std::string_view text : ints) {
+            total += static_cast<double>(fl::parse_prefix<std::int64_t>(text).value);
+        }
+        return total;
+    }), " ns");
+
+    std::cout << "double (" << kValues / 1000 << "k shortest round-trip values), per value:\n";
+    report("strtod", best_ns(kValues, [&] {
+        double total = 0;
+        for (const std::string& field : double_fields) {
+            total += std::strtod(field.c_str(), nullptr);
+        }
+        return total;
+    }), " ns");
+    report("from_chars", best_ns(kValues, [&] {
+        double total = 0;
+        for (const std::string_view text : doubles) {
+            double value = 0;
+            std::from_chars(text.data(), text.data() + text.size(), value);
+            total += value;
+        }
+        return total;
+    }), " ns");
+    report("fl::parse", best_ns(kValues, [&] {
+        double total = 0;
+        for (const std::string_view text : doubles) {
+            total += fl::parse_prefix<double>(text).value;
+        }
+        return total;
+    }), " ns");
+
+    std::cout << "CSV column (" << csv.size() / 1024 << " KB, " << kValues / 1000 << "k doubles):\n";
+    const double csv_mb = static_cast<double>(csv.size()) / 1e6;
+    std::vector<double> column;
+    column.reserve(kValues);
+    report("strtod loop", 1e9 / best_ns(csv_mb, [&] {
+        column.clear();
+        const char* p = csv.c_str();
+        const char* const last = p + csv.size();
+        while (p < last) {
+            char* end = nullptr;
+            column.push_back(std::strtod(p, &end));
+            p = end + 1;
+        }
+        return column.back();
+    }), " MB/s");
+    report("from_chars loop", 1e9 / best_ns(csv_mb, [&] {
+        column.clear();
+        const char* p = csv.data();
+        const char* const last = p + csv.size();
+        while (p < last) {
+            double value = 0;
+            p = std::from_chars(p, last, value).ptr + 1;
+            column.push_back(value);
+        }
+        return column.back();
+    }), " MB/s");
+    report("parse_column", 1e9 / best_ns(csv_mb, [&] {
+        column.clear();
+        fl::parse_column<double>(csv, ',', column);
+        return column.back();
+    }), " MB/s");
+    return 0;
+}
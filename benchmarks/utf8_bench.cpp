@@ -0,0 +1,228 @@
+// Benchmark: UTF-8 validation, code point counting and UTF-16/UTF-32
+// transcoding, in MB/s of UTF-8 (best of 7 runs, each processing a 1 MB
+// corpus 16 times).
+//
+// Corpora:
+//
+//   ASCII    English prose, every byte below 0x80.
+//   Latin    French and German prose: mostly ASCII with two-byte letters.
+//   CJK      Chinese and Japanese prose: almost all three-byte sequences.
+//
+// Rows:
+//
+//   scalar        a byte-at-a-time decoder checking each sequence, the
+//                 usual hand-written validator, and a loop counting
+//                 non-continuation bytes.
+//   fl::utf8      fl::utf8::validate / count_codepoints.
+//
+// Transcoding rows:
+//
+//   scalar        validate, then decode or encode a code point at a time,
+//                 appending to a std::u16string / u32string / std::string
+//                 with push_back, as conversion code without a length pass
+//                 does.
+//   fl            fl::utf8_to_utf16 / utf8_to_utf32 / utf16_to_utf8: a
+//                 validation pass, a length pass, then one write into a
+//                 buffer allocated at the exact size.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "fl.hpp"
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile std::size_t sink_sz;
+static void sink(std::size_t v) { sink_sz = v; }
+
+static constexpr int kRuns = 7;
+static constexpr int kRepeats = 16;
+static constexpr std::size_t kCorpusSize = 1024 * 1024;
+
+template <typename Fn>
+static double best_mb_per_s(std::string_view input, Fn&& fn) {
+    double best_ns = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        for (int i = 0; i < kRepeats; ++i) {
+            sink(fn(input));
+        }
+        best_ns = std::min(best_ns, t.elapsed_ns());
+    }
+    return static_cast<double>(input.size()) * kRepeats / best_ns * 1e3;
+}
+
+static void report(const char* name, double value) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(0) << value << " MB/s\n";
+}
+
+static std::string corpus(std::string_view sentence) {
+    std::string text;
+    while (text.size() < kCorpusSize) {
+        text += sentence;
+    }
+    text.resize(fl::utf8::find_codepoint_boundary(text, kCorpusSize));
+    return text;
+}
+
+static bool scalar_validate(std::string_view text) {
+    std::size_t i = 0;
+    while (i < text.size()) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c < 0x80) {
+            ++i;
+            continue;
+        }
+        std::size_t length;
+        char32_t cp;
+        if (c >= 0xC2 && c <= 0xDF) {
+            length = 2;
+            cp = c & 0x1F;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            length = 3;
+            cp = c & 0x0F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            length = 4;
+            cp = c & 0x07;
+        } else {
+            return false;
+        }
+        if (i + length > text.size()) {
+            return false;
+        }
+        for (std::size_t k = 1; k < length; ++k) {
+            const unsigned char d = static_cast<unsigned char>(text[i + k]);
+            if ((d & 0xC0) != 0x80) {
+                return false;
+            }
+            cp = cp << 6 | (d & 0x3F);
+        }
+        if ((length == 3 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) ||
+            (length == 4 && (cp < 0x10000 || cp > 0x10FFFF))) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+static std::u16string scalar_utf8_to_utf16(std::string_view text) {
+    std::u16string out;
+    if (!scalar_validate(text)) {
+        return out;
+    }
+    for (const char32_t cp : fl::utf8_view(text)) {
+        if (cp < 0x10000) {
+            out.push_back(static_cast<char16_t>(cp));
+        } else {
+            out.push_back(static_cast<char16_t>(0xD7C0 + (cp >> 10)));
+            out.push_back(static_cast<char16_t>(0xDC00 + (cp & 0x3FF)));
+        }
+    }
+    return out;
+}
+
+static std::u32string scalar_utf8_to_utf32(std::string_view text) {
+    std::u32string out;
+    if (!scalar_validate(text)) {
+        return out;
+    }
+    for (const char32_t cp : fl::utf8_view(text)) {
+        out.push_back(cp);
+    }
+    return out;
+}
+
+static std::string scalar_utf16_to_utf8(std::u16string_view text) {
+    std::string out;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        char32_t cp = text[i];
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < text.size()) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (text[++i] - 0xDC00);
+        }
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | cp >> 6));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | cp >> 12));
+            out.push_back(static_cast<char>(0x80 | (cp >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | cp >> 18));
+            out.push_back(static_cast<char>(0x80 | (cp >> 12 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+    return out;
+}
+
+static std::size_t scalar_count(std::string_view text) {
+    std::size_t count = 0;
+    for (const char c : text) {
+        count += (static_cast<unsigned char>(c) & 0xC0) != 0x80 ? 1 : 0;
+    }
+    return count;
+}
+
+int main() {
+    const std::pair<const char*, std::string> corpora[] = {
+        {"ASCII", corpus("The quick brown fox jumps over the lazy dog while the band plays on. ")},
+        {"Latin", corpus("Le cœur a ses raisons que la raison ne connaît point. Übermäßig große Straßen führen "
+                         "über die Brücke. ")},
+        {"CJK", corpus("天地玄黄，宇宙洪荒。日月盈昃，辰宿列张。"
+                       "吾輩は猫である。名前はまだ無い。")},
+    };
+
+    for (const auto& [name, text] : corpora) {
+        std::cout << "validate, " << name << " (" << text.size() / 1024 << " KB):\n";
+        report("scalar", best_mb_per_s(text, [](std::string_view t) { return std::size_t{scalar_validate(t)}; }));
+        report("fl::utf8", best_mb_per_s(text, [](std::string_view t) { return std::size_t{fl::utf8::validate(t)}; }));
+    }
+    for (const auto& [name, text] : corpora) {
+        std::cout << "count_codepoints, " << name << ":\n";
+        report("scalar", best_mb_per_s(text, [](std::string_view t) { return scalar_count(t); }));
+        report("fl::utf8", best_mb_per_s(text, [](std::string_view t) { return fl::utf8::count_codepoints(t); }));
+    }
+    for (const auto& [name, text] : corpora) {
+        const std::u16string utf16 = fl::utf8_to_utf16(text);
+        std::cout << "transcoding, " << name << ":\n";
+        report("scalar to UTF-16", best_mb_per_s(text, [](std::string_view t) {
+            return scalar_utf8_to_utf16(t).size();
+        }));
+        report("fl::utf8_to_utf16", best_mb_per_s(text, [](std::string_view t) {
+            return fl::utf8_to_utf16(t).size();
+        }));
+        report("scalar to UTF-32", best_mb_per_s(text, [](std::string_view t) {
+            return scalar_utf8_to_utf32(t).size();
+        }));
+        report("fl::utf8_to_utf32", best_mb_per_s(text, [](std::string_view t) {
+            return fl::utf8_to_utf32(t).size();
+        }));
+        report("scalar from UTF-16", best_mb_per_s(text, [&](std::string_view) {
+            return scalar_utf16_to_utf8(utf16).size();
+        }));
+        report("fl::utf16_to_utf8", best_mb_per_s(text, [&](std::string_view) {
+            return fl::utf16_to_utf8(utf16).size();
+        }));
+    }
+    return 0;
+}
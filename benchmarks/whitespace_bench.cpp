@@ -0,0 +1,166 @@
+// Benchmark: whitespace trimming and collapsing on CSV and log line shapes
+// (best of 7 runs, each processing the input 16 times).
+//
+// Inputs:
+//
+//   csv fields     100k fields split from CSV lines, each with 0-3 spaces
+//                  of padding on either side, in ns per field.
+//   fixed width    100k fields of a fixed-width report: values right-aligned
+//                  in 32 columns, so each has a long run of leading spaces.
+//   log lines      1 MB of log lines with aligned columns (runs of spaces
+//                  and tabs), in MB/s.
+//
+// Rows:
+//
+//   std            find_first_not_of / find_last_not_of(" \t\n\v\f\r") on a
+//                  std::string_view, and a byte-at-a-time collapse loop
+//                  rewriting a std::string in place.
+//   fl             fl::trim_view, and fl::collapse_whitespace on an
+//                  fl::string.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fl.hpp"
+#include "fl/whitespace.hpp"
+
+// ---------------------------------------------------------------------------
+struct Timer {
+    std::chrono::high_resolution_clock::time_point t0;
+    Timer() : t0(std::chrono::high_resolution_clock::now()) {}
+    double elapsed_ns() const {
+        using namespace std::chrono;
+        return duration<double, std::nano>(high_resolution_clock::now() - t0).count();
+    }
+};
+
+static volatile std::size_t sink_sz;
+static void sink(std::size_t v) { sink_sz = v; }
+
+static constexpr int kRuns = 7;
+static constexpr int kRepeats = 16;
+static constexpr std::size_t kFields = 100000;
+static constexpr std::size_t kLogSize = 1024 * 1024;
+static constexpr std::string_view kSpaces = " \t\n\v\f\r";
+
+// Best time over kRuns of kRepeats passes of fn(), divided by work units.
+template <typename Fn>
+static double best_ns(double units, Fn&& fn) {
+    double best = 1e300;
+    for (int run = 0; run < kRuns; ++run) {
+        Timer t;
+        for (int i = 0; i < kRepeats; ++i) {
+            sink(fn());
+        }
+        best = std::min(best, t.elapsed_ns());
+    }
+    return best / (units * kRepeats);
+}
+
+static void report(const char* name, double value, const char* unit) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(value < 100 ? 1 : 0) << value << unit << "\n";
+}
+
+static std::string_view std_trim(std::string_view text) {
+    const std::size_t first = text.find_first_not_of(kSpaces);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(kSpaces) - first + 1);
+}
+
+static void std_collapse(std::string& text) {
+    const std::string_view inner = std_trim(text);
+    std::size_t out = 0;
+    bool in_run = false;
+    for (const char c : inner) {
+        if (kSpaces.find(c) != std::string_view::npos) {
+            if (!in_run) {
+                text[out++] = ' ';
+            }
+            in_run = true;
+        } else {
+            text[out++] = c;
+            in_run = false;
+        }
+    }
+    text.resize(out);
+}
+
+template <typename Trim>
+static std::size_t trim_all(const std::vector<std::string_view>& fields, Trim&& trim) {
+    std::size_t total = 0;
+    for (const std::string_view field : fields) {
+        total += trim(field).size();
+    }
+    return total;
+}
+
+int main() {
+    std::mt19937 rng(29);
+    const char* const words[] = {"alpha", "12.5", "-3", "Widget large", "2026-10-17", "OK", "n/a", "1e-9"};
+
+    std::string csv_storage;
+    std::string fixed_storage;
+    for (std::size_t i = 0; i < kFields; ++i) {
+        const std::string_view word = words[rng() % 8];
+        csv_storage.append(rng() % 4, ' ').append(word).append(rng() % 4, ' ').push_back(',');
+        fixed_storage.append(32 - word.size(), ' ').append(word);
+    }
+    std::vector<std::string_view> csv_fields;
+    for (std::size_t start = 0, comma; (comma = csv_storage.find(',', start)) != std::string::npos; start = comma + 1) {
+        csv_fields.push_back(std::string_view(csv_storage).substr(start, comma - start));
+    }
+    std::vector<std::string_view> fixed_fields;
+    for (std::size_t i = 0; i < kFields; ++i) {
+        fixed_fields.push_back(std::string_view(fixed_storage).substr(i * 32, 32));
+    }
+
+    std::string log;
+    const char* const levels[] = {"INFO ", "WARN ", "DEBUG", "ERROR"};
+    while (log.size() < kLogSize) {
+        log += "2026-10-17 12:00:" + std::to_string(10 + rng() % 50) + "  " + levels[rng() % 4] + "\t[worker-" +
+               std::to_string(rng() % 16) + "]    request handled   in " + std::to_string(rng() % 1000) +
+               " ms  \n";
+    }
+
+    std::cout << "trim, CSV fields (" << csv_fields.size() / 1000 << "k), per field:\n";
+    report("std", best_ns(csv_fields.size(), [&] { return trim_all(csv_fields, std_trim); }), " ns");
+    report("fl::trim_view", best_ns(csv_fields.size(), [&] {
+        return trim_all(csv_fields, [](std::string_view f) { return fl::trim_view(f); });
+    }), " ns");
+
+    std::cout << "trim, fixed-width fields (" << kFields / 1000 << "k, 32 columns), per field:\n";
+    report("std", best_ns(kFields, [&] { return trim_all(fixed_fields, std_trim); }), " ns");
+    report("fl::trim_view", best_ns(kFields, [&] {
+        return trim_all(fixed_fields, [](std::string_view f) { return fl::trim_view(f); });
+    }), " ns");
+
+    std::cout << "collapse, log lines (" << log.size() / 1024 << " KB), including the copy:\n";
+    const double log_mb = static_cast<double>(log.size()) / 1e6;
+    std::string std_text;
+    report("std", 1e9 / best_ns(log_mb, [&] {
+        std_text = log;
+        std_collapse(std_text);
+        return std_text.size();
+    }), " MB/s");
+    fl::string fl_text;
+    report("fl::collapse", 1e9 / best_ns(log_mb, [&] {
+        fl_text.assign(log.data(), log.size());
+        return fl::collapse_whitespace(fl_text).size();
+    }), " MB/s");
+    std::string copied;
+    report("copy only", 1e9 / best_ns(log_mb, [&] {
+        copied = log;
+        return copied.size();
+    }), " MB/s");
+    return 0;
+}
@@ -5,19 +5,30 @@
 #define FL_HPP
 
 // Umbrella header for the fl library.  Including this single header pulls in
-// every public component: strings, arenas, sinks, formatting, builders, ropes,
+// every public component: strings, arenas, sinks, number formatting,
+// formatting, builders, ropes, UTF-8, whitespace trimming, line splitting,
 // immutable strings, and synchronised strings.
 
 #include "fl/config.hpp"
 #include "fl/string.hpp"
 #include "fl/arena.hpp"
 #include "fl/sinks.hpp"
+#include "fl/encoding.hpp"
+#include "fl/escape.hpp"
+#include "fl/parse.hpp"
+#include "fl/number_format.hpp"
 #include "fl/format.hpp"
 #include "fl/builder.hpp"
 #include "fl/substring_view.hpp"
 #include "fl/rope.hpp"
+#include "fl/utf8.hpp"
+#include "fl/whitespace.hpp"
+#include "fl/lines.hpp"
 #include "fl/immutable_string.hpp"
 #include "fl/synchronised_string.hpp"
+#include "fl/format_record.hpp"
+#include "fl/log.hpp"
+#include "fl/async_sink.hpp"
 
 namespace fl {
     constexpr int MAJOR_VERSION = 1;
@@ -195,6 +195,27 @@ namespace alloc_hooks {
 #endif
         }
 
+        // Hands a thread's cached blocks back to the system allocator when the
+        // thread exits. It is registered by the first push into an empty class
+        // rather than on every pool access, so the hot path keeps a trivially
+        // destructible thread_local with no guard.
+        struct TlsFreeListsRelease {
+            ~TlsFreeListsRelease() {
+                TlsFreeLists& tls = get_tls_free_lists();
+                for (std::size_t idx = 0; idx < POOL_CLASSES.size(); ++idx) {
+                    while (tls.counts[idx] > 0) {
+                        deallocate_aligned_unpooled(tls.slots[idx][--tls.counts[idx]], POOL_CLASSES[idx],
+                                                    DEFAULT_ALIGNMENT);
+                    }
+                }
+            }
+        };
+
+        inline void register_tls_free_lists_release() noexcept {
+            static thread_local TlsFreeListsRelease release;
+            (void)release;
+        }
+
         // Forward declarations for pool instrumentation counters.
         inline std::atomic<std::uint64_t>& pool_hits() noexcept;
         inline std::atomic<std::uint64_t>& pool_misses() noexcept;
@@ -273,6 +294,9 @@ namespace alloc_hooks {
 
             TlsFreeLists& tls = get_tls_free_lists();
             if (tls.counts[idx] < static_cast<uint8_t>(POOL_SLAB_DEPTH)) {
+                if (tls.counts[idx] == 0) {
+                    register_tls_free_lists_release();
+                }
                 tls.slots[idx][tls.counts[idx]++] = p;
                 #ifndef NDEBUG
                 pool_pushes().fetch_add(1, std::memory_order_relaxed);
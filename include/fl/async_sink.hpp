@@ -0,0 +1,470 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_ASYNC_SINK_HPP
+#define FL_ASYNC_SINK_HPP
+
+// A sink that moves the writes of another sink onto a background thread.
+//
+// Each writing thread fills a block of its own. A write copies into the
+// thread's block and takes no lock: the block is borrowed from the thread's
+// slot with one atomic exchange and returned with a release store. When the
+// block is full it goes onto a bounded queue, and the background thread
+// writes queued blocks to the wrapped sink in order, so formatting threads
+// never wait for the disk unless the queue is full and the policy says to.
+//
+// Bytes from one thread reach the wrapped sink in the order written, and a
+// write() of at most block_size bytes is never split, so threads that write
+// whole lines per call never see their lines interleaved. Blocks from
+// different threads are interleaved in the order they were queued.
+
+#include "fl/sinks.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fl {
+namespace sinks {
+
+// What a write does when it fills a block and the queue is already full.
+enum class backpressure : std::uint8_t {
+    block,  // Wait for the background thread to make room.
+    drop,   // Discard the full block and count it in bytes_dropped().
+    grow,   // Queue it anyway, allocating another block.
+};
+
+struct async_options {
+    // Bytes per block. A thread's block is queued when a write does not fit.
+    std::size_t block_size = 64 * 1024;
+    // Full blocks the queue holds before backpressure applies.
+    std::size_t queue_blocks = 16;
+    backpressure policy = backpressure::block;
+    // How often the background thread, when idle, queues partly filled blocks
+    // so that a quiet thread's output is not held back indefinitely.
+    std::chrono::milliseconds flush_interval{100};
+};
+
+namespace detail {
+
+struct async_block {
+    explicit async_block(std::size_t capacity)
+        : data(std::make_unique_for_overwrite<char[]>(capacity)), capacity(capacity) {}
+
+    std::unique_ptr<char[]> data;
+    std::size_t capacity;
+    std::size_t size = 0;
+};
+
+// Marks a slot whose block is in use by its owning thread.
+alignas(async_block) inline char async_busy_marker;
+
+inline async_block* async_busy() noexcept {
+    return reinterpret_cast<async_block*>(&async_busy_marker);
+}
+
+// One thread's current block, shared between that thread and the sink. The
+// owner swaps in async_busy() while it writes; the sink takes the block with a
+// compare-exchange, waiting out a write in progress.
+struct async_slot {
+    std::atomic<async_block*> current{nullptr};
+    // Set when the owning thread has exited; the sink releases the slot once
+    // it has taken the block.
+    std::atomic<bool> closed{false};
+    // Set when the sink has closed; the owning thread forgets the slot.
+    std::atomic<bool> detached{false};
+
+    ~async_slot() {
+        async_block* const block = current.load(std::memory_order_acquire);
+        if (block != async_busy()) {
+            delete block;
+        }
+    }
+};
+
+// The slots the current thread writes through, one per async_sink. The last
+// one used is cached, so a thread writing to one sink finds its slot with a
+// single comparison.
+struct async_thread_slots {
+    std::uint64_t last_owner = 0;
+    async_slot* last = nullptr;
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<async_slot>>> slots;
+
+    ~async_thread_slots() {
+        for (auto& entry : slots) {
+            entry.second->closed.store(true, std::memory_order_release);
+        }
+    }
+};
+
+inline async_thread_slots& current_async_slots() noexcept {
+    thread_local async_thread_slots slots;
+    return slots;
+}
+
+inline std::uint64_t next_async_sink_id() noexcept {
+    static std::atomic<std::uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+// Wraps another sink and writes to it from a background thread. Any number
+// of threads may write concurrently; the wrapped sink is only ever called by
+// the background thread and must outlive the async_sink.
+//
+// flush() queues every thread's partly filled block, waits until the wrapped
+// sink has written everything queued and then flushes it. close() does the
+// same and stops the thread; later writes are dropped. An exception from the
+// wrapped sink is held and rethrown by the next flush() or close(); the block
+// it was writing counts as dropped.
+class async_sink final : public output_sink {
+public:
+    explicit async_sink(output_sink& target, async_options opts = {})
+        : _target(target),
+          _id(detail::next_async_sink_id()),
+          _block_size(std::max<std::size_t>(opts.block_size, 1)),
+          _queue_blocks(std::max<std::size_t>(opts.queue_blocks, 1)),
+          _policy(opts.policy),
+          _flush_interval(opts.flush_interval) {
+        _thread = std::thread([this] { run(); });
+    }
+
+    async_sink(const async_sink&) = delete;
+    async_sink& operator=(const async_sink&) = delete;
+
+    ~async_sink() noexcept override {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void write(const char* data, std::size_t len) override {
+        if (_closed.load(std::memory_order_relaxed)) {
+            _dropped.fetch_add(len, std::memory_order_relaxed);
+            return;
+        }
+        detail::async_slot& slot = local_slot();
+        {
+            // The slot stays busy until the guard returns the block, even if
+            // taking a new block throws.
+            struct borrowed {
+                detail::async_slot& slot;
+                detail::async_block* block;
+                ~borrowed() { slot.current.store(block, std::memory_order_release); }
+            } held{slot, slot.current.exchange(detail::async_busy(), std::memory_order_acquire)};
+            if (!held.block) {
+                held.block = next_block(nullptr);
+            }
+            while (len > held.block->capacity - held.block->size) {
+                // A write longer than a block fills whole blocks; a shorter
+                // one starts a new block rather than being split.
+                if (held.block->size == 0) {
+                    std::memcpy(held.block->data.get(), data, held.block->capacity);
+                    held.block->size = held.block->capacity;
+                    data += held.block->capacity;
+                    len -= held.block->capacity;
+                }
+                // Cleared first, so a throw leaves the queued block to the queue.
+                detail::async_block* const full = std::exchange(held.block, nullptr);
+                held.block = next_block(full);
+            }
+            std::memcpy(held.block->data.get() + held.block->size, data, len);
+            held.block->size += len;
+        }
+        // A write that passed the check above while close() ran may leave
+        // bytes in the slot after close() has swept it; whichever of the two
+        // sees the other takes them and counts them as dropped.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (slot.detached.load(std::memory_order_relaxed)) {
+            drop_slot_block(slot);
+        }
+    }
+
+    // Blocks until everything written before the call, by this thread or by
+    // threads whose writes completed before it, has reached the wrapped sink,
+    // then flushes that sink.
+    void flush() override {
+        collect(true);
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_stopping) {
+            const std::uint64_t ticket = ++_flush_requested;
+            _work.notify_one();
+            _flushed.wait(lock, [&] { return _flush_done >= ticket || _stopping; });
+        }
+        rethrow_error(lock);
+    }
+
+    // Writes everything still pending, flushes the wrapped sink and joins the
+    // background thread. Called by the destructor.
+    void close() {
+        if (_closed.exchange(true)) {
+            return;
+        }
+        collect(true);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _work.notify_one();
+        _thread.join();
+        {
+            std::lock_guard<std::mutex> lock(_slots_mutex);
+            for (auto& slot : _slots) {
+                slot->detached.store(true, std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            for (auto& slot : _slots) {
+                drop_slot_block(*slot);
+            }
+            _slots.clear();
+        }
+        _space.notify_all();
+        _flushed.notify_all();
+        std::unique_lock<std::mutex> lock(_mutex);
+        rethrow_error(lock);
+    }
+
+    std::size_t block_size() const noexcept { return _block_size; }
+
+    // Bytes discarded: full blocks under backpressure::drop, blocks the
+    // wrapped sink failed to write, and writes after close().
+    [[nodiscard]] std::uint64_t bytes_dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+    // Full blocks that found the queue full; with backpressure::block, the
+    // number of times a writer had to wait.
+    [[nodiscard]] std::uint64_t queue_full_count() const noexcept {
+        return _queue_full.load(std::memory_order_relaxed);
+    }
+
+private:
+    using block_ptr = std::unique_ptr<detail::async_block>;
+
+    detail::async_slot& local_slot() {
+        detail::async_thread_slots& slots = detail::current_async_slots();
+        if (slots.last_owner == _id) {
+            return *slots.last;
+        }
+        return attach(slots);
+    }
+
+    detail::async_slot& attach(detail::async_thread_slots& slots) {
+        std::erase_if(slots.slots, [](const auto& entry) {
+            return entry.second->detached.load(std::memory_order_acquire);
+        });
+        auto found = std::find_if(slots.slots.begin(), slots.slots.end(),
+                                  [&](const auto& entry) { return entry.first == _id; });
+        if (found == slots.slots.end()) {
+            auto slot = std::make_shared<detail::async_slot>();
+            {
+                std::lock_guard<std::mutex> lock(_slots_mutex);
+                _slots.push_back(slot);
+            }
+            slots.slots.emplace_back(_id, std::move(slot));
+            found = slots.slots.end() - 1;
+        }
+        slots.last_owner = _id;
+        slots.last = found->second.get();
+        return *slots.last;
+    }
+
+    // Queues full (when not null) and returns an empty block to continue in,
+    // applying the backpressure policy when the queue is full.
+    detail::async_block* next_block(detail::async_block* full) {
+        block_ptr owned(full);
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (owned) {
+            if (_queue.size() >= _queue_blocks) {
+                _queue_full.fetch_add(1, std::memory_order_relaxed);
+                if (_policy == backpressure::drop) {
+                    _dropped.fetch_add(owned->size, std::memory_order_relaxed);
+                    owned->size = 0;
+                    return owned.release();
+                }
+                if (_policy == backpressure::block) {
+                    _space.wait(lock, [&] { return _queue.size() < _queue_blocks || _stopping; });
+                }
+            }
+            if (_stopping) {
+                // close() has begun; the background thread may already be gone.
+                _dropped.fetch_add(owned->size, std::memory_order_relaxed);
+                owned->size = 0;
+                return owned.release();
+            }
+            _queue.push_back(std::move(owned));
+            _work.notify_one();
+        }
+        if (_free.empty()) {
+            lock.unlock();
+            return new detail::async_block(_block_size);
+        }
+        detail::async_block* const block = _free.back().release();
+        _free.pop_back();
+        return block;
+    }
+
+    // Queues the partly filled block of every slot and releases the slots of
+    // threads that have exited. A slot whose owner is mid-write is waited for
+    // when wait is set and skipped otherwise: the background thread must not
+    // wait for a writer that may itself be waiting for queue space.
+    //
+    // Each block is taken and queued under _mutex, so its owner cannot queue
+    // a later block ahead of it. _mutex is released while waiting for a busy
+    // slot, as its owner may need it in next_block(). Nothing takes
+    // _slots_mutex while holding _mutex, so the nesting is safe.
+    void collect(bool wait) {
+        std::lock_guard<std::mutex> slots_lock(_slots_mutex);
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (auto& slot : _slots) {
+            detail::async_block* block = slot->current.load(std::memory_order_acquire);
+            for (;;) {
+                if (block == detail::async_busy()) {
+                    if (!wait) {
+                        break;
+                    }
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                    block = slot->current.load(std::memory_order_acquire);
+                } else if (slot->current.compare_exchange_weak(block, nullptr, std::memory_order_acquire)) {
+                    break;
+                }
+            }
+            if (block == detail::async_busy() || !block) {
+                continue;
+            }
+            if (_stopping) {
+                // A flush() racing close(): the background thread is gone.
+                _dropped.fetch_add(block->size, std::memory_order_relaxed);
+                block->size = 0;
+            }
+            if (block->size == 0) {
+                _free.emplace_back(block);
+            } else {
+                _queue.emplace_back(block);
+            }
+        }
+        std::erase_if(_slots, [](const auto& slot) { return slot->closed.load(std::memory_order_acquire); });
+        _work.notify_one();
+    }
+
+    // Takes the block left in a slot after close(), waiting out a write in
+    // progress, and counts its bytes as dropped.
+    void drop_slot_block(detail::async_slot& slot) noexcept {
+        detail::async_block* block = slot.current.load(std::memory_order_acquire);
+        for (;;) {
+            if (block == detail::async_busy()) {
+                std::this_thread::yield();
+                block = slot.current.load(std::memory_order_acquire);
+            } else if (slot.current.compare_exchange_weak(block, nullptr, std::memory_order_acquire)) {
+                break;
+            }
+        }
+        if (block) {
+            _dropped.fetch_add(block->size, std::memory_order_relaxed);
+            delete block;
+        }
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;) {
+            const bool woken = _work.wait_for(lock, _flush_interval, [&] {
+                return !_queue.empty() || _stopping || _flush_requested != _flush_done;
+            });
+            if (!woken) {
+                lock.unlock();
+                collect(false);
+                lock.lock();
+            }
+            while (!_queue.empty()) {
+                block_ptr block = std::move(_queue.front());
+                _queue.pop_front();
+                _space.notify_one();
+                lock.unlock();
+                try {
+                    _target.write(block->data.get(), block->size);
+                } catch (...) {
+                    _dropped.fetch_add(block->size, std::memory_order_relaxed);
+                    keep_error(std::current_exception());
+                }
+                block->size = 0;
+                lock.lock();
+                _free.push_back(std::move(block));
+            }
+            if (_flush_requested != _flush_done || _stopping) {
+                const std::uint64_t ticket = _flush_requested;
+                lock.unlock();
+                try {
+                    _target.flush();
+                } catch (...) {
+                    keep_error(std::current_exception());
+                }
+                lock.lock();
+                _flush_done = ticket;
+                _flushed.notify_all();
+                if (_stopping && _queue.empty()) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // Called by the background thread without _mutex held.
+    void keep_error(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_error) {
+            _error = std::move(error);
+        }
+    }
+
+    void rethrow_error(std::unique_lock<std::mutex>& lock) {
+        std::exception_ptr error = std::exchange(_error, nullptr);
+        lock.unlock();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    output_sink& _target;
+    const std::uint64_t _id;
+    const std::size_t _block_size;
+    const std::size_t _queue_blocks;
+    const backpressure _policy;
+    const std::chrono::milliseconds _flush_interval;
+    std::atomic<bool> _closed{false};
+    std::atomic<std::uint64_t> _dropped{0};
+    std::atomic<std::uint64_t> _queue_full{0};
+
+    std::mutex _slots_mutex;
+    std::vector<std::shared_ptr<detail::async_slot>> _slots;
+
+    std::mutex _mutex;  // Guards the queue, the free blocks, the held error and the flush and stop state.
+    std::condition_variable _work;
+    std::condition_variable _space;
+    std::condition_variable _flushed;
+    std::deque<block_ptr> _queue;
+    std::vector<block_ptr> _free;
+    std::uint64_t _flush_requested = 0;
+    std::uint64_t _flush_done = 0;
+    bool _stopping = false;
+    std::exception_ptr _error;
+
+    std::thread _thread;
+};
+
+}  // namespace sinks
+}  // namespace fl
+
+#endif  // FL_ASYNC_SINK_HPP
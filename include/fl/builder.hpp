@@ -14,6 +14,8 @@
 #include <cstring>
 #include <utility>
 #include <algorithm>
+#include "fl/escape.hpp"
+#include "fl/number_format.hpp"
 #include "fl/profiling.hpp"
 
 namespace fl {
@@ -27,7 +29,9 @@ enum class growth_policy {
 // A string builder that accumulates characters into a contiguous buffer and
 // produces an fl::string via build(). The builder owns its buffer and supports
 // move semantics but not copying. A configurable growth policy controls how
-// the internal buffer expands when more space is needed.
+// the internal buffer expands when more space is needed. The buffer is
+// allocated exactly as fl::string allocates its heap storage, one byte past
+// the capacity for the terminator, so build() can hand it over as it is.
 class string_builder {
 public:
     using size_type = std::size_t;
@@ -57,9 +61,7 @@ public:
 
     string_builder& operator=(string_builder&& other) noexcept {
         if (this != &other) {
-            if (_owns_buffer && _buffer) {
-                fl::deallocate_bytes(_buffer, _capacity);
-            }
+            _free_buffer();
             _buffer = other._buffer;
             _capacity = other._capacity;
             _size = other._size;
@@ -79,11 +81,7 @@ public:
     string_builder(const string_builder&) = delete;
     string_builder& operator=(const string_builder&) = delete;
 
-    ~string_builder() noexcept {
-        if (_owns_buffer && _buffer) {
-            fl::deallocate_bytes(_buffer, _capacity);
-        }
-    }
+    ~string_builder() noexcept { _free_buffer(); }
 
     string_builder& reserve(size_type cap) noexcept {
         if (cap > _capacity) {
@@ -199,6 +197,35 @@ public:
         return *this;
     }
 
+    // Sink interface, so that fl::format_to and the escaping kernels can write
+    // straight into the builder. prepare(len) grows the buffer to hold len more
+    // characters and returns all of the unused space; commit(len) publishes the
+    // first len characters written to it.
+    void write(const char* data, size_type len) noexcept { append(data, len); }
+
+    void put(char ch) noexcept { append(ch); }
+
+    std::span<char> prepare(size_type len) noexcept {
+        if (_size + len > _capacity) {
+            _grow_for_size(_size + len);
+        }
+        return {_buffer + _size, _capacity - _size};
+    }
+
+    void commit(size_type len) noexcept { _size += len; }
+
+    // Appends text escaped for a JSON string literal (see fl::json_escape),
+    // growing the buffer at most once to the exact escaped size.
+    string_builder& append_json_escaped(std::string_view text) noexcept {
+        const size_type size = json_escaped_size(text);
+        if (_size + size > _capacity) {
+            _grow_for_size(_size + size);
+        }
+        detail::json_escape_to(_buffer + _size, text);
+        _size += size;
+        return *this;
+    }
+
     // Appends a formatted string by replacing the first "{}" placeholder with
     // the string representation of the given value. Supports integral,
     // floating-point, and string_view-convertible types.
@@ -212,22 +239,39 @@ public:
                 size_type prefix_len = p - fmt;
                 append(fmt, prefix_len);
 
-                char temp[64];
                 size_type len = 0;
 
                 if constexpr (std::convertible_to<T, std::string_view>) {
                     std::string_view sv = value;
                     append(sv.data(), sv.size());
                 } else if constexpr (std::integral<T>) {
+                    // Size the digits first, then write them in place.
+                    bool negative = false;
+                    uint64_t magnitude = static_cast<uint64_t>(value);
                     if constexpr (std::signed_integral<T>) {
-                        len = _format_int64(temp, sizeof(temp), static_cast<int64_t>(value));
-                    } else {
-                        len = _format_uint64(temp, sizeof(temp), static_cast<uint64_t>(value));
+                        negative = value < 0;
+                        if (negative) magnitude = 0 - magnitude;
                     }
-                    append(temp, len);
+                    len = detail::integer_formatter::count_digits(magnitude) + (negative ? 1 : 0);
+                    if (_size + len > _capacity) {
+                        _grow_for_size(_size + len);
+                    }
+                    char* out = _buffer + _size;
+                    if (negative) *out++ = '-';
+                    detail::integer_formatter::write_decimal(out, magnitude);
+                    _size += len;
                 } else if constexpr (std::floating_point<T>) {
-                    len = static_cast<size_type>(std::snprintf(temp, sizeof(temp), "%g", static_cast<double>(value)));
-                    if (len > 0) append(temp, len);
+                    // Reserve the worst case and write the shortest form in place.
+                    constexpr size_type max_len = detail::float_formatter::max_shortest_chars;
+                    if (_size + max_len > _capacity) {
+                        _grow_for_size(_size + max_len);
+                    }
+                    if constexpr (std::same_as<T, float>) {
+                        len = detail::float_formatter::format_shortest(_buffer + _size, value);
+                    } else {
+                        len = detail::float_formatter::format_shortest(_buffer + _size, static_cast<double>(value));
+                    }
+                    _size += len;
                 }
 
                 append(p + 2);
@@ -251,16 +295,16 @@ public:
 
         if (_size < SSO_THRESHOLD) {
             string result(_buffer, _size);
-            if (_owns_buffer && _buffer) {
-                fl::deallocate_bytes(_buffer, _capacity);
-            }
+            _free_buffer();
             _buffer = nullptr;
             _capacity = 0;
             _size = 0;
             return result;
         }
 
-        // Transfer heap buffer ownership to the new string.
+        // Transfer heap buffer ownership to the new string; the allocation
+        // always has room for the terminator past the capacity.
+        _buffer[_size] = '\0';
         string result;
         result._size = _size;
         result._flags = 0x01;
@@ -292,6 +336,11 @@ public:
         _size = 0;
     }
 
+    // Discards everything after the first len characters.
+    void truncate(size_type len) noexcept {
+        _size = std::min(_size, len);
+    }
+
     [[nodiscard]] const char* data() const noexcept {
         return _buffer;
     }
@@ -324,20 +373,26 @@ private:
     void _grow_to(size_type new_capacity) noexcept {
         if (new_capacity <= _capacity) return;
 
-        char* new_buffer = static_cast<char*>(fl::allocate_bytes(new_capacity));
+        const std::size_t alloc_n = new_capacity + 1;
+        char* new_buffer = static_cast<char*>(fl::allocate_bytes_aligned(alloc_n, fl::preferred_alloc_alignment()));
         if (_buffer && _size > 0) {
             std::memcpy(new_buffer, _buffer, _size);
         }
 
-        if (_owns_buffer && _buffer) {
-            fl::deallocate_bytes(_buffer, _capacity);
-        }
+        _free_buffer();
 
         _buffer = new_buffer;
-        _capacity = new_capacity;
+        _capacity = fl::alloc_hooks::pool_alloc_usable_capacity(alloc_n);
         _owns_buffer = true;
     }
 
+    // Frees the buffer as fl::string frees heap storage of this capacity.
+    void _free_buffer() noexcept {
+        if (_owns_buffer && _buffer) {
+            fl::deallocate_bytes_aligned(_buffer, _capacity + 1, fl::preferred_alloc_alignment());
+        }
+    }
+
     void _grow_for_size(size_type min_size) noexcept {
         if (min_size <= _capacity) return;
         size_type new_capacity = _calculate_growth_capacity(min_size);
@@ -373,59 +428,6 @@ private:
 
         return candidate;
     }
-
-    static size_type _format_int64(char* buffer, size_type capacity, int64_t value) noexcept {
-        if (capacity == 0) return 0;
-
-        if (value == 0) {
-            buffer[0] = '0';
-            return 1;
-        }
-
-        bool negative = value < 0;
-        uint64_t uvalue = negative ? (value == INT64_MIN ? static_cast<uint64_t>(INT64_MAX) + 1 : static_cast<uint64_t>(-value)) : static_cast<uint64_t>(value);
-
-        size_type len = 0;
-        uint64_t temp = uvalue;
-        while (temp > 0) {
-            ++len;
-            temp /= 10;
-        }
-
-        size_type total_len = negative ? len + 1 : len;
-        if (total_len > capacity) return 0;
-
-        size_type pos = total_len;
-        while (uvalue > 0) {
-            buffer[--pos] = '0' + (uvalue % 10);
-            uvalue /= 10;
-        }
-
-        if (negative) {
-            buffer[0] = '-';
-        }
-
-        return total_len;
-    }
-
-    static size_type _format_uint64(char* buffer, size_type capacity, uint64_t value) noexcept {
-        if (capacity == 0) return 0;
-
-        if (value == 0) {
-            buffer[0] = '0';
-            return 1;
-        }
-
-        char temp[20];
-        size_type len = 0;
-        while (value > 0) {
-            temp[len++] = '0' + (value % 10);
-            value /= 10;
-        }
-
-        std::reverse_copy(temp, temp + len, buffer);
-        return len;
-    }
 };
 
 }  // namespace fl
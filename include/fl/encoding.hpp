@@ -0,0 +1,612 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_ENCODING_HPP
+#define FL_ENCODING_HPP
+
+// Binary-to-text encodings that write into any sinks::character_sink:
+// base64 (RFC 4648, standard and URL-safe alphabets) and hexadecimal.
+//
+// The vector kernels follow Wojciech Muła's methods. Base64 encoding spreads
+// each 3-byte group over a 32-bit lane and extracts the four 6-bit indices
+// with two multiplies, then maps indices to digits with one table shuffle;
+// decoding classifies digits by range and packs four 6-bit values back into
+// three bytes with two multiply-adds. Hex maps nibbles to digits with a
+// compare and an add. The output length is known from the input length, so
+// a direct_sink, including string_builder, is sized once and written in
+// place; the fl::string overloads allocate the result at its exact size.
+
+#include "fl/number_format.hpp"
+#include "fl/sinks.hpp"
+#include "fl/string.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__SSSE3__) && !defined(__AVX2__)
+#include <tmmintrin.h>
+#endif
+
+namespace fl {
+
+enum class base64_alphabet : std::uint8_t {
+    standard,  // A-Z a-z 0-9 + /, padded with '='.
+    url,       // A-Z a-z 0-9 - _, unpadded.
+};
+
+enum class hex_case : std::uint8_t { lower, upper };
+
+namespace detail {
+
+inline constexpr char base64_standard_digits[65] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+inline constexpr char base64_url_digits[65] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+[[nodiscard]] constexpr const char* base64_digits(base64_alphabet alphabet) noexcept {
+    return alphabet == base64_alphabet::url ? base64_url_digits : base64_standard_digits;
+}
+
+// Digit value for each byte, or 0xFF for a byte outside the alphabet.
+template <base64_alphabet Alphabet>
+inline constexpr std::array<std::uint8_t, 256> base64_values = [] {
+    std::array<std::uint8_t, 256> values{};
+    values.fill(0xFF);
+    for (std::uint8_t i = 0; i < 64; ++i) {
+        values[static_cast<unsigned char>(base64_digits(Alphabet)[i])] = i;
+    }
+    return values;
+}();
+
+[[noreturn]] inline void throw_base64_error(const char* message) {
+    throw std::invalid_argument(message);
+}
+
+#if defined(__AVX2__)
+// Unsigned lo <= v <= hi per byte, as min(max(v, lo), hi) == v.
+inline __m256i bytes_in_range(__m256i v, char lo, char hi) noexcept {
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_max_epu8(v, _mm256_set1_epi8(lo)), _mm256_set1_epi8(hi)), v);
+}
+
+// Spreads the four 3-byte groups in the low 12 bytes of each 128-bit lane
+// over 32-bit lanes as [b1 b0 b2 b1] and extracts the four 6-bit indices of
+// each group, one per byte, with a high and a low 16-bit multiply.
+inline __m256i base64_indices(__m256i in) noexcept {
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,  //
+                                                 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                                          _mm256_set1_epi32(0x04000040));
+    const __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                                          _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(ac, bd);
+}
+
+// Maps 6-bit indices to digits. Each index range (A-Z, a-z, 0-9, and the two
+// alphabet-specific digits) selects its offset from the 16-entry table.
+inline __m256i base64_encode_digits(__m256i indices, __m256i offsets) noexcept {
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    range = _mm256_sub_epi8(range, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+    return _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range));
+}
+
+// Replaces digits with their 6-bit values. Returns false if any byte is not
+// a digit of the alphabet.
+inline bool base64_decode_digits(__m256i& block, char c62, char c63) noexcept {
+    const __m256i upper = bytes_in_range(block, 'A', 'Z');
+    const __m256i lower = bytes_in_range(block, 'a', 'z');
+    const __m256i digit = bytes_in_range(block, '0', '9');
+    const __m256i d62 = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c62));
+    const __m256i d63 = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c63));
+    const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(d62, d63)));
+    if (_mm256_movemask_epi8(valid) != -1) {
+        return false;
+    }
+    const __m256i offset = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                        _mm256_and_si256(lower, _mm256_set1_epi8(static_cast<char>(26 - 'a')))),
+        _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(static_cast<char>(52 - '0'))),
+                        _mm256_or_si256(_mm256_and_si256(d62, _mm256_set1_epi8(static_cast<char>(62 - c62))),
+                                        _mm256_and_si256(d63, _mm256_set1_epi8(static_cast<char>(63 - c63))))));
+    block = _mm256_add_epi8(block, offset);
+    return true;
+}
+
+// Packs sixteen 6-bit values per 128-bit lane into twelve bytes, leaving the
+// 24 output bytes at the bottom of the register.
+inline __m256i base64_pack(__m256i values) noexcept {
+    const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    const __m256i quads = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    const __m256i bytes = _mm256_shuffle_epi8(quads, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,  //
+                                                                      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+}
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+inline __m128i bytes_in_range(__m128i v, char lo, char hi) noexcept {
+    return _mm_cmpeq_epi8(_mm_min_epu8(_mm_max_epu8(v, _mm_set1_epi8(lo)), _mm_set1_epi8(hi)), v);
+}
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+// The 128-bit forms of the base64 steps above.
+inline __m128i base64_indices(__m128i in) noexcept {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i ac = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    const __m128i bd = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(ac, bd);
+}
+
+inline __m128i base64_encode_digits(__m128i indices, __m128i offsets) noexcept {
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    range = _mm_sub_epi8(range, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range));
+}
+
+inline bool base64_decode_digits(__m128i& block, char c62, char c63) noexcept {
+    const __m128i upper = bytes_in_range(block, 'A', 'Z');
+    const __m128i lower = bytes_in_range(block, 'a', 'z');
+    const __m128i digit = bytes_in_range(block, '0', '9');
+    const __m128i d62 = _mm_cmpeq_epi8(block, _mm_set1_epi8(c62));
+    const __m128i d63 = _mm_cmpeq_epi8(block, _mm_set1_epi8(c63));
+    const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(d62, d63)));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+        return false;
+    }
+    const __m128i offset = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                     _mm_and_si128(lower, _mm_set1_epi8(static_cast<char>(26 - 'a')))),
+        _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(static_cast<char>(52 - '0'))),
+                     _mm_or_si128(_mm_and_si128(d62, _mm_set1_epi8(static_cast<char>(62 - c62))),
+                                  _mm_and_si128(d63, _mm_set1_epi8(static_cast<char>(63 - c63))))));
+    block = _mm_add_epi8(block, offset);
+    return true;
+}
+
+// Leaves the 12 output bytes at the bottom of the register.
+inline __m128i base64_pack(__m128i values) noexcept {
+    const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+#endif
+
+// Encodes [p, end) into out, which must have room for the encoded length,
+// and returns the end of the output. Padding is written only for the final
+// partial group, so the input may be fed in whole groups of three.
+inline char* base64_encode_to(char* out, const char* p, const char* end, base64_alphabet alphabet) noexcept {
+    const char* digits = base64_digits(alphabet);
+#if defined(__SSSE3__) || defined(__AVX2__)
+    const char off62 = static_cast<char>(digits[62] - 62);
+    const char off63 = static_cast<char>(digits[63] - 63);
+#endif
+#if defined(__AVX2__)
+    // Each step reads 28 bytes (two 16-byte loads, 12 bytes apart) and
+    // consumes 24.
+    const __m256i offsets256 = _mm256_setr_epi8('A', 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                '0' - 52, '0' - 52, '0' - 52, '0' - 52, off62, off63, 0, 0,  //
+                                                'A', 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                '0' - 52, '0' - 52, '0' - 52, '0' - 52, off62, off63, 0, 0);
+    while (end - p >= 28) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12));
+        const __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), base64_encode_digits(base64_indices(in), offsets256));
+        p += 24;
+        out += 32;
+    }
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+    const __m128i offsets128 = _mm_setr_epi8('A', 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, off62, off63, 0, 0);
+    while (end - p >= 16) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), base64_encode_digits(base64_indices(in), offsets128));
+        p += 12;
+        out += 16;
+    }
+#endif
+    for (; end - p >= 3; p += 3, out += 4) {
+        const std::uint32_t group = static_cast<std::uint32_t>(static_cast<unsigned char>(p[0])) << 16 |
+                                    static_cast<std::uint32_t>(static_cast<unsigned char>(p[1])) << 8 |
+                                    static_cast<unsigned char>(p[2]);
+        out[0] = digits[group >> 18];
+        out[1] = digits[(group >> 12) & 0x3F];
+        out[2] = digits[(group >> 6) & 0x3F];
+        out[3] = digits[group & 0x3F];
+    }
+    if (p != end) {
+        const bool two = end - p == 2;
+        const std::uint32_t group = static_cast<std::uint32_t>(static_cast<unsigned char>(p[0])) << 16 |
+                                    (two ? static_cast<std::uint32_t>(static_cast<unsigned char>(p[1])) << 8 : 0);
+        *out++ = digits[group >> 18];
+        *out++ = digits[(group >> 12) & 0x3F];
+        if (two) {
+            *out++ = digits[(group >> 6) & 0x3F];
+        }
+        if (alphabet == base64_alphabet::standard) {
+            *out++ = '=';
+            if (!two) {
+                *out++ = '=';
+            }
+        }
+    }
+    return out;
+}
+
+// Decodes [p, end), which holds no padding, into out, which must have room
+// for the decoded length, and returns the end of the output. The input may be
+// fed in whole groups of four digits; a final group of two or three digits is
+// a partial one. Throws std::invalid_argument on a byte outside the alphabet.
+template <base64_alphabet Alphabet>
+char* base64_decode_to(char* out, const char* p, const char* end) {
+#if defined(__SSSE3__) || defined(__AVX2__)
+    constexpr char c62 = base64_digits(Alphabet)[62];
+    constexpr char c63 = base64_digits(Alphabet)[63];
+#endif
+#if defined(__AVX2__)
+    // Each step stores 32 bytes of which 24 are output; requiring 44 digits
+    // keeps the store inside the decoded length.
+    while (end - p >= 44) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        if (!base64_decode_digits(block, c62, c63)) {
+            break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), base64_pack(block));
+        p += 32;
+        out += 24;
+    }
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+    while (end - p >= 24) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if (!base64_decode_digits(block, c62, c63)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), base64_pack(block));
+        p += 16;
+        out += 12;
+    }
+#endif
+    const auto& values = base64_values<Alphabet>;
+    auto value = [&](char c) -> std::uint32_t {
+        const std::uint8_t v = values[static_cast<unsigned char>(c)];
+        if (v > 63) {
+            throw_base64_error("fl::base64_decode: invalid character");
+        }
+        return v;
+    };
+    for (; end - p >= 4; p += 4, out += 3) {
+        const std::uint32_t group = value(p[0]) << 18 | value(p[1]) << 12 | value(p[2]) << 6 | value(p[3]);
+        out[0] = static_cast<char>(group >> 16);
+        out[1] = static_cast<char>(group >> 8);
+        out[2] = static_cast<char>(group);
+    }
+    if (p != end) {
+        std::uint32_t group = value(p[0]) << 18 | value(p[1]) << 12;
+        *out++ = static_cast<char>(group >> 16);
+        if (end - p == 3) {
+            group |= value(p[2]) << 6;
+            *out++ = static_cast<char>(group >> 8);
+        }
+    }
+    return out;
+}
+
+// The digits of a base64 text without its padding, checking that the length
+// and padding are consistent.
+[[nodiscard]] inline std::string_view base64_digits_of(std::string_view text) {
+    std::size_t padding = 0;
+    while (padding < text.size() && padding < 3 && text[text.size() - 1 - padding] == '=') {
+        ++padding;
+    }
+    const std::size_t digits = text.size() - padding;
+    if (padding > 2 || digits % 4 == 1 || (padding != 0 && text.size() % 4 != 0)) {
+        throw_base64_error("fl::base64_decode: invalid length or padding");
+    }
+    return text.substr(0, digits);
+}
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+// Maps bytes holding nibbles 0-15 to hex digits: '0' + n, plus the distance
+// to the letters for n > 9.
+inline __m128i hex_digits_from_nibbles(__m128i nibbles, __m128i letter_offset) noexcept {
+    const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), letter_offset);
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+// Replaces hex digits with their values. Returns false if any byte is not a
+// hex digit.
+inline bool hex_values(__m128i& block) noexcept {
+    const __m128i digit = bytes_in_range(block, '0', '9');
+    const __m128i folded = _mm_or_si128(block, _mm_set1_epi8(0x20));
+    const __m128i letter = bytes_in_range(folded, 'a', 'f');
+    if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xFFFF) {
+        return false;
+    }
+    block = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(block, _mm_set1_epi8('0'))),
+                         _mm_and_si128(letter, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+    return true;
+}
+
+// Joins the digit values in each 16-bit lane, high nibble first, into one
+// byte value per lane.
+inline __m128i hex_join_pairs(__m128i values) noexcept {
+    return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(values, 8));
+}
+#endif
+
+#if defined(__AVX2__)
+inline __m256i hex_digits_from_nibbles(__m256i nibbles, __m256i letter_offset) noexcept {
+    const __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), letter_offset);
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+}
+
+inline bool hex_values(__m256i& block) noexcept {
+    const __m256i digit = bytes_in_range(block, '0', '9');
+    const __m256i folded = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+    const __m256i letter = bytes_in_range(folded, 'a', 'f');
+    if (_mm256_movemask_epi8(_mm256_or_si256(digit, letter)) != -1) {
+        return false;
+    }
+    block = _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(block, _mm256_set1_epi8('0'))),
+                            _mm256_and_si256(letter, _mm256_sub_epi8(folded, _mm256_set1_epi8('a' - 10))));
+    return true;
+}
+
+inline __m256i hex_join_pairs(__m256i values) noexcept {
+    return _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(values, _mm256_set1_epi16(0x00FF)), 4),
+                           _mm256_srli_epi16(values, 8));
+}
+#endif
+
+// Writes two hex digits per byte of [p, end) to out and returns the end of
+// the output.
+inline char* hex_encode_to(char* out, const char* p, const char* end, hex_case letter_case) noexcept {
+    const char* digits = letter_case == hex_case::upper ? upper_hex_digits : lower_hex_digits;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    const char letter_offset = static_cast<char>(digits[10] - '0' - 10);
+#endif
+#if defined(__AVX2__)
+    const __m256i offset256 = _mm256_set1_epi8(letter_offset);
+    while (end - p >= 32) {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i high =
+            hex_digits_from_nibbles(_mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(0x0F)), offset256);
+        const __m256i low = hex_digits_from_nibbles(_mm256_and_si256(in, _mm256_set1_epi8(0x0F)), offset256);
+        // The unpacks interleave within 128-bit lanes; the permutes restore
+        // input order.
+        const __m256i first = _mm256_unpacklo_epi8(high, low);
+        const __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+        p += 32;
+        out += 64;
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    const __m128i offset128 = _mm_set1_epi8(letter_offset);
+    while (end - p >= 16) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i high = hex_digits_from_nibbles(_mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F)), offset128);
+        const __m128i low = hex_digits_from_nibbles(_mm_and_si128(in, _mm_set1_epi8(0x0F)), offset128);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+        p += 16;
+        out += 32;
+    }
+#endif
+    for (; p != end; ++p, out += 2) {
+        const unsigned char byte = static_cast<unsigned char>(*p);
+        out[0] = digits[byte >> 4];
+        out[1] = digits[byte & 0xF];
+    }
+    return out;
+}
+
+// Decodes pairs of hex digits, in either case, from [p, end), whose length is
+// even, and returns the end of the output. Throws std::invalid_argument on a
+// byte that is not a hex digit.
+inline char* hex_decode_to(char* out, const char* p, const char* end) {
+#if defined(__AVX2__)
+    while (end - p >= 64) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        if (!hex_values(first) || !hex_values(second)) {
+            break;
+        }
+        // packus works within 128-bit lanes; the permute puts the lanes back
+        // in input order.
+        const __m256i bytes = _mm256_packus_epi16(hex_join_pairs(first), hex_join_pairs(second));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute4x64_epi64(bytes, 0xD8));
+        p += 64;
+        out += 32;
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    while (end - p >= 32) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+        if (!hex_values(first) || !hex_values(second)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(hex_join_pairs(first), hex_join_pairs(second)));
+        p += 32;
+        out += 16;
+    }
+#endif
+    for (; p != end; p += 2) {
+        const unsigned high = hex_digit_value(p[0]);
+        const unsigned low = hex_digit_value(p[1]);
+        if ((high | low) > 15) {
+            throw std::invalid_argument("fl::hex_decode: invalid hex digit");
+        }
+        *out++ = static_cast<char>(high << 4 | low);
+    }
+    return out;
+}
+
+// Writes out_size bytes produced by kernel(out, first, last) from the input
+// [data, data + size). A direct sink is written in place in one step. Any
+// other sink receives the output through a local buffer, Chunk input bytes
+// at a time; Chunk is a whole number of the kernel's input groups and the
+// buffer holds the output of one chunk.
+template <std::size_t Chunk, std::size_t ChunkOutput, typename Sink, typename Kernel>
+void transcode_into(Sink& sink, const char* data, std::size_t size, std::size_t out_size, Kernel&& kernel) {
+    if constexpr (sinks::direct_sink<Sink>) {
+        const std::span<char> space = sink.prepare(out_size);
+        if (space.size() >= out_size) {
+            kernel(space.data(), data, data + size);
+            sink.commit(out_size);
+            return;
+        }
+    }
+    char buffer[ChunkOutput];
+    const char* const end = data + size;
+    for (const char* p = data; p != end;) {
+        const char* stop = p + std::min(Chunk, static_cast<std::size_t>(end - p));
+        const char* out = kernel(buffer, p, stop);
+        sink.write(buffer, static_cast<std::size_t>(out - buffer));
+        p = stop;
+    }
+}
+
+// Builds an fl::string of exactly size characters with fill(data).
+template <typename Fill>
+[[nodiscard]] fl::string string_of_size(std::size_t size, Fill&& fill) {
+    fl::string result(size, '\0');
+    fill(result.data());
+    return result;
+}
+
+[[nodiscard]] inline std::string_view as_chars(std::span<const std::byte> bytes) noexcept {
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+}  // namespace detail
+
+// Length of the base64 encoding of size bytes.
+[[nodiscard]] constexpr std::size_t base64_encoded_size(std::size_t size,
+                                                        base64_alphabet alphabet = base64_alphabet::standard) noexcept {
+    if (alphabet == base64_alphabet::standard) {
+        return (size + 2) / 3 * 4;
+    }
+    return size / 3 * 4 + (size % 3 == 0 ? 0 : size % 3 + 1);
+}
+
+// Length of the bytes a base64 text decodes to. Throws std::invalid_argument
+// if the length or padding is malformed.
+[[nodiscard]] inline std::size_t base64_decoded_size(std::string_view text) {
+    const std::size_t digits = detail::base64_digits_of(text).size();
+    return digits / 4 * 3 + (digits % 4 == 0 ? 0 : digits % 4 - 1);
+}
+
+// Writes the base64 encoding of data. The standard alphabet pads the final
+// group with '='; the URL-safe alphabet does not.
+template <sinks::character_sink Sink>
+void base64_encode(Sink& sink, std::string_view data, base64_alphabet alphabet = base64_alphabet::standard) {
+    detail::transcode_into<768, 1024>(sink, data.data(), data.size(), base64_encoded_size(data.size(), alphabet),
+                                      [alphabet](char* out, const char* first, const char* last) {
+                                          return detail::base64_encode_to(out, first, last, alphabet);
+                                      });
+}
+
+template <sinks::character_sink Sink>
+void base64_encode(Sink& sink, std::span<const std::byte> data, base64_alphabet alphabet = base64_alphabet::standard) {
+    base64_encode(sink, detail::as_chars(data), alphabet);
+}
+
+// Writes the bytes a base64 text decodes to. Padding is optional with either
+// alphabet. Throws std::invalid_argument on a byte outside the alphabet or a
+// malformed length or padding, after which the sink may hold part of the
+// output.
+template <sinks::character_sink Sink>
+void base64_decode(Sink& sink, std::string_view text, base64_alphabet alphabet = base64_alphabet::standard) {
+    const std::string_view digits = detail::base64_digits_of(text);
+    const std::size_t size = base64_decoded_size(text);
+    if (alphabet == base64_alphabet::url) {
+        detail::transcode_into<1024, 768>(sink, digits.data(), digits.size(), size,
+                                          detail::base64_decode_to<base64_alphabet::url>);
+    } else {
+        detail::transcode_into<1024, 768>(sink, digits.data(), digits.size(), size,
+                                          detail::base64_decode_to<base64_alphabet::standard>);
+    }
+}
+
+// Writes two hex digits per byte of data.
+template <sinks::character_sink Sink>
+void hex_encode(Sink& sink, std::string_view data, hex_case letter_case = hex_case::lower) {
+    detail::transcode_into<512, 1024>(sink, data.data(), data.size(), data.size() * 2,
+                                      [letter_case](char* out, const char* first, const char* last) {
+                                          return detail::hex_encode_to(out, first, last, letter_case);
+                                      });
+}
+
+template <sinks::character_sink Sink>
+void hex_encode(Sink& sink, std::span<const std::byte> data, hex_case letter_case = hex_case::lower) {
+    hex_encode(sink, detail::as_chars(data), letter_case);
+}
+
+// Writes the bytes a text of hex digit pairs, in either case, decodes to.
+// Throws std::invalid_argument on an odd length or a byte that is not a hex
+// digit, after which the sink may hold part of the output.
+template <sinks::character_sink Sink>
+void hex_decode(Sink& sink, std::string_view text) {
+    if (text.size() % 2 != 0) {
+        throw std::invalid_argument("fl::hex_decode: odd number of digits");
+    }
+    detail::transcode_into<1024, 512>(sink, text.data(), text.size(), text.size() / 2, detail::hex_decode_to);
+}
+
+// The same encodings returned as an fl::string, allocated at its exact size
+// and filled in place.
+[[nodiscard]] inline fl::string base64_encode(std::string_view data,
+                                              base64_alphabet alphabet = base64_alphabet::standard) {
+    return detail::string_of_size(base64_encoded_size(data.size(), alphabet), [&](char* out) {
+        detail::base64_encode_to(out, data.data(), data.data() + data.size(), alphabet);
+    });
+}
+
+[[nodiscard]] inline fl::string base64_encode(std::span<const std::byte> data,
+                                              base64_alphabet alphabet = base64_alphabet::standard) {
+    return base64_encode(detail::as_chars(data), alphabet);
+}
+
+[[nodiscard]] inline fl::string base64_decode(std::string_view text,
+                                              base64_alphabet alphabet = base64_alphabet::standard) {
+    const std::string_view digits = detail::base64_digits_of(text);
+    return detail::string_of_size(base64_decoded_size(text), [&](char* out) {
+        if (alphabet == base64_alphabet::url) {
+            detail::base64_decode_to<base64_alphabet::url>(out, digits.data(), digits.data() + digits.size());
+        } else {
+            detail::base64_decode_to<base64_alphabet::standard>(out, digits.data(), digits.data() + digits.size());
+        }
+    });
+}
+
+[[nodiscard]] inline fl::string hex_encode(std::string_view data, hex_case letter_case = hex_case::lower) {
+    return detail::string_of_size(data.size() * 2, [&](char* out) {
+        detail::hex_encode_to(out, data.data(), data.data() + data.size(), letter_case);
+    });
+}
+
+[[nodiscard]] inline fl::string hex_encode(std::span<const std::byte> data, hex_case letter_case = hex_case::lower) {
+    return hex_encode(detail::as_chars(data), letter_case);
+}
+
+[[nodiscard]] inline fl::string hex_decode(std::string_view text) {
+    if (text.size() % 2 != 0) {
+        throw std::invalid_argument("fl::hex_decode: odd number of digits");
+    }
+    return detail::string_of_size(text.size() / 2, [&](char* out) {
+        detail::hex_decode_to(out, text.data(), text.data() + text.size());
+    });
+}
+
+}  // namespace fl
+
+#endif  // FL_ENCODING_HPP
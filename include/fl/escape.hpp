@@ -0,0 +1,589 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_ESCAPE_HPP
+#define FL_ESCAPE_HPP
+
+// Escaping and unescaping kernels that write into any sinks::character_sink:
+// JSON string literals, HTML and XML text, and URL percent-encoding.
+//
+// Each kernel scans its input a block at a time (32 bytes with AVX2, 16 with
+// SSE2) for the bytes that need rewriting, copies the clean run before them
+// in one write, and emits the replacement. Text that needs no escaping is
+// therefore a vector scan and a single bulk copy. Sinks that model
+// direct_sink are sized exactly up front and written in place.
+
+#include "fl/number_format.hpp"
+#include "fl/sink_concepts.hpp"
+#include "fl/string.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace fl {
+
+namespace detail {
+
+// Returns the first byte in [first, last) that belongs to Class, or last.
+// Class supplies mask(block) for 32-byte (AVX2) and 16-byte (SSE2) blocks,
+// returning one bit per matching byte, and test(byte) for the tail.
+template <typename Class>
+[[nodiscard]] inline const char* find_byte_class(const char* first, const char* last) noexcept {
+#if defined(__AVX2__)
+    while (last - first >= 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const unsigned mask = Class::mask(block);
+        if (mask != 0) {
+            return first + first_set_bit_index(mask);
+        }
+        first += 32;
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    while (last - first >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const unsigned mask = Class::mask(block);
+        if (mask != 0) {
+            return first + first_set_bit_index(mask);
+        }
+        first += 16;
+    }
+#endif
+    while (first != last && !Class::test(static_cast<unsigned char>(*first))) {
+        ++first;
+    }
+    return first;
+}
+
+// Sums weight(byte) over the bytes of Class in [first, last). Blocks without
+// a match cost one compare.
+template <typename Class, typename Weight>
+[[nodiscard]] inline std::size_t sum_byte_class(const char* first, const char* last, Weight&& weight) noexcept {
+    std::size_t sum = 0;
+    auto add_matches = [&](unsigned mask) {
+        for (; mask != 0; mask &= mask - 1) {
+            sum += weight(static_cast<unsigned char>(first[first_set_bit_index(mask)]));
+        }
+    };
+#if defined(__AVX2__)
+    for (; last - first >= 32; first += 32) {
+        add_matches(Class::mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first))));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    for (; last - first >= 16; first += 16) {
+        add_matches(Class::mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first))));
+    }
+#endif
+    for (; first != last; ++first) {
+        if (Class::test(static_cast<unsigned char>(*first))) {
+            sum += weight(static_cast<unsigned char>(*first));
+        }
+    }
+    return sum;
+}
+
+// Copies [p, stop) to out, handing each byte of Class to emit(out, p), which
+// writes its replacement and advances both pointers (p may end up past stop).
+// Every block is stored whole before its first match is replaced, so out
+// must have room for at least stop - p more bytes at each step; a buffer
+// sized for the exact output, or for the worst case, always does. Returns the
+// end of the output.
+template <typename Class, typename Emit>
+inline char* transform_byte_class(char* out, const char*& p, const char* stop, Emit&& emit) {
+#if defined(__AVX2__)
+    while (stop - p >= 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const unsigned mask = Class::mask(block);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), block);
+        if (mask == 0) {
+            p += 32;
+            out += 32;
+            continue;
+        }
+        const unsigned clean = first_set_bit_index(mask);
+        p += clean;
+        out += clean;
+        emit(out, p);
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    while (stop - p >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const unsigned mask = Class::mask(block);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+        if (mask == 0) {
+            p += 16;
+            out += 16;
+            continue;
+        }
+        const unsigned clean = first_set_bit_index(mask);
+        p += clean;
+        out += clean;
+        emit(out, p);
+    }
+#endif
+    while (p < stop) {
+        if (Class::test(static_cast<unsigned char>(*p))) {
+            emit(out, p);
+        } else {
+            *out++ = *p++;
+        }
+    }
+    return out;
+}
+
+// Input bytes a write-only sink receives per intermediate buffer once the
+// text turns out to need rewriting.
+inline constexpr std::size_t escape_chunk = 256;
+
+// Writes text with each byte of Class replaced through emit, which writes at
+// most MaxExpansion bytes per input byte. A direct sink is sized with
+// size_of(text) and written in place. Any other sink receives each clean run
+// straight from text, and the stretch after a replaced byte through a local
+// buffer, one chunk at a time.
+template <typename Class, std::size_t MaxExpansion, typename Sink, typename Size, typename Emit>
+void escape_into(Sink& sink, std::string_view text, Size&& size_of, Emit&& emit) {
+    if constexpr (sinks::direct_sink<Sink>) {
+        const std::size_t size = size_of(text);
+        const std::span<char> space = sink.prepare(size);
+        if (space.size() >= size) {
+            const char* p = text.data();
+            transform_byte_class<Class>(space.data(), p, p + text.size(), emit);
+            sink.commit(size);
+            return;
+        }
+    }
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    while (p != end) {
+        const char* special = find_byte_class<Class>(p, end);
+        if (special != p) {
+            sink.write(p, static_cast<std::size_t>(special - p));
+            p = special;
+            if (p == end) {
+                return;
+            }
+        }
+        char buffer[escape_chunk * MaxExpansion];
+        const char* stop = p + std::min(escape_chunk, static_cast<std::size_t>(end - p));
+        const char* out = transform_byte_class<Class>(buffer, p, stop, emit);
+        sink.write(buffer, static_cast<std::size_t>(out - buffer));
+    }
+}
+
+// The decoding counterpart of escape_into: a replacement is never longer than
+// the sequence it replaces, so text.size() bounds the output. The last
+// sequence in a chunk may extend up to Overrun bytes past it.
+template <typename Class, std::size_t Overrun, typename Sink, typename Emit>
+void unescape_into(Sink& sink, std::string_view text, Emit&& emit) {
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    if constexpr (sinks::direct_sink<Sink>) {
+        const std::span<char> space = sink.prepare(text.size());
+        if (space.size() >= text.size()) {
+            const char* out = transform_byte_class<Class>(space.data(), p, end, emit);
+            sink.commit(static_cast<std::size_t>(out - space.data()));
+            return;
+        }
+    }
+    while (p < end) {
+        const char* special = find_byte_class<Class>(p, end);
+        if (special != p) {
+            sink.write(p, static_cast<std::size_t>(special - p));
+            p = special;
+            if (p == end) {
+                return;
+            }
+        }
+        char buffer[escape_chunk + Overrun];
+        const char* stop = p + std::min(escape_chunk, static_cast<std::size_t>(end - p));
+        const char* out = transform_byte_class<Class>(buffer, p, stop, emit);
+        sink.write(buffer, static_cast<std::size_t>(out - buffer));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// JSON
+
+// The character after the backslash for each byte JSON requires escaped: '"',
+// '\\' and the control characters below 0x20. 'u' selects the six-byte
+// \u00XX form; 0 means the byte is copied as it is, which includes all of
+// UTF-8 above 0x7F.
+inline constexpr std::array<char, 256> json_escape_codes = [] {
+    std::array<char, 256> codes{};
+    for (std::size_t c = 0; c < 0x20; ++c) {
+        codes[c] = 'u';
+    }
+    codes['\b'] = 'b';
+    codes['\f'] = 'f';
+    codes['\n'] = 'n';
+    codes['\r'] = 'r';
+    codes['\t'] = 't';
+    codes['"'] = '"';
+    codes['\\'] = '\\';
+    return codes;
+}();
+
+struct json_escape_class {
+    static bool test(unsigned char c) noexcept { return json_escape_codes[c] != 0; }
+#if defined(__AVX2__)
+    // A byte is a control character when max(byte, 0x1F) is 0x1F.
+    static unsigned mask(__m256i block) noexcept {
+        const __m256i control = _mm256_set1_epi8(0x1F);
+        const __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('"')),
+                            _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\'))),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(block, control), control));
+        return static_cast<unsigned>(_mm256_movemask_epi8(hits));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    static unsigned mask(__m128i block) noexcept {
+        const __m128i control = _mm_set1_epi8(0x1F);
+        const __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'))),
+            _mm_cmpeq_epi8(_mm_max_epu8(block, control), control));
+        return static_cast<unsigned>(_mm_movemask_epi8(hits));
+    }
+#endif
+};
+
+struct backslash_class {
+    static bool test(unsigned char c) noexcept { return c == '\\'; }
+#if defined(__AVX2__)
+    static unsigned mask(__m256i block) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\'))));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    static unsigned mask(__m128i block) noexcept {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\\'))));
+    }
+#endif
+};
+
+// Writes the escape sequence for c, which must need one, and returns its
+// length (2 or 6).
+inline std::size_t write_json_escape(char* out, unsigned char c) noexcept {
+    const char code = json_escape_codes[c];
+    out[0] = '\\';
+    if (code != 'u') {
+        out[1] = code;
+        return 2;
+    }
+    std::memcpy(out + 1, "u00", 3);
+    out[4] = lower_hex_digits[c >> 4];
+    out[5] = lower_hex_digits[c & 0xF];
+    return 6;
+}
+
+inline void emit_json_escape(char*& out, const char*& p) noexcept {
+    out += write_json_escape(out, static_cast<unsigned char>(*p++));
+}
+
+// Escapes text into out, which must have room for json_escaped_size(text)
+// characters, and returns the end of the output.
+inline char* json_escape_to(char* out, std::string_view text) noexcept {
+    const char* p = text.data();
+    return transform_byte_class<json_escape_class>(out, p, p + text.size(), emit_json_escape);
+}
+
+// Reads the four hex digits of a \u escape at p.
+inline std::uint32_t read_json_hex4(const char* p, const char* end) {
+    if (end - p < 4) {
+        throw std::invalid_argument("fl::json_unescape: truncated \\u escape");
+    }
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const unsigned digit = hex_digit_value(p[i]);
+        if (digit > 15) {
+            throw std::invalid_argument("fl::json_unescape: invalid \\u escape");
+        }
+        value = (value << 4) | digit;
+    }
+    return value;
+}
+
+inline std::size_t write_utf8(char* out, std::uint32_t cp) noexcept {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// Decodes the escape sequence starting at the backslash p into out (at most
+// four bytes, never more than the sequence itself), advancing p past it.
+inline std::size_t decode_json_escape(const char*& p, const char* end, char* out) {
+    if (end - p < 2) {
+        throw std::invalid_argument("fl::json_unescape: truncated escape sequence");
+    }
+    const char code = p[1];
+    p += 2;
+    switch (code) {
+        case '"': out[0] = '"'; return 1;
+        case '\\': out[0] = '\\'; return 1;
+        case '/': out[0] = '/'; return 1;
+        case 'b': out[0] = '\b'; return 1;
+        case 'f': out[0] = '\f'; return 1;
+        case 'n': out[0] = '\n'; return 1;
+        case 'r': out[0] = '\r'; return 1;
+        case 't': out[0] = '\t'; return 1;
+        case 'u': break;
+        default: throw std::invalid_argument("fl::json_unescape: invalid escape sequence");
+    }
+    std::uint32_t cp = read_json_hex4(p, end);
+    p += 4;
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        // A high surrogate must be followed by an escaped low surrogate.
+        if (end - p < 6 || p[0] != '\\' || p[1] != 'u') {
+            throw std::invalid_argument("fl::json_unescape: unpaired surrogate");
+        }
+        const std::uint32_t low = read_json_hex4(p + 2, end);
+        if (low < 0xDC00 || low > 0xDFFF) {
+            throw std::invalid_argument("fl::json_unescape: unpaired surrogate");
+        }
+        p += 6;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        throw std::invalid_argument("fl::json_unescape: unpaired surrogate");
+    }
+    return write_utf8(out, cp);
+}
+
+// ---------------------------------------------------------------------------
+// HTML and XML
+
+// The five characters with a meaning in markup text and attribute values.
+struct markup_escape_class {
+    static bool test(unsigned char c) noexcept {
+        return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+    }
+#if defined(__AVX2__)
+    static unsigned mask(__m256i block) noexcept {
+        const __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('&')),
+                                            _mm256_cmpeq_epi8(block, _mm256_set1_epi8('<'))),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('>')),
+                                            _mm256_cmpeq_epi8(block, _mm256_set1_epi8('"')))),
+            _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\'')));
+        return static_cast<unsigned>(_mm256_movemask_epi8(hits));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    static unsigned mask(__m128i block) noexcept {
+        const __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('&')), _mm_cmpeq_epi8(block, _mm_set1_epi8('<'))),
+                         _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('>')), _mm_cmpeq_epi8(block, _mm_set1_epi8('"')))),
+            _mm_cmpeq_epi8(block, _mm_set1_epi8('\'')));
+        return static_cast<unsigned>(_mm_movemask_epi8(hits));
+    }
+#endif
+};
+
+// The entity for each markup character. HTML and XML differ only in the
+// apostrophe: &apos; is not an HTML 4 entity, so HTML uses the numeric form.
+struct markup_entities {
+    std::string_view amp, lt, gt, quot, apos;
+
+    constexpr std::string_view operator[](unsigned char c) const noexcept {
+        switch (c) {
+            case '&': return amp;
+            case '<': return lt;
+            case '>': return gt;
+            case '"': return quot;
+            default: return apos;
+        }
+    }
+};
+
+inline constexpr markup_entities html_entities{"&amp;", "&lt;", "&gt;", "&quot;", "&#39;"};
+inline constexpr markup_entities xml_entities{"&amp;", "&lt;", "&gt;", "&quot;", "&apos;"};
+
+template <const markup_entities& Entities>
+inline void emit_markup_escape(char*& out, const char*& p) noexcept {
+    const std::string_view entity = Entities[static_cast<unsigned char>(*p++)];
+    std::memcpy(out, entity.data(), entity.size());
+    out += entity.size();
+}
+
+template <const markup_entities& Entities>
+[[nodiscard]] inline std::size_t markup_escaped_size(std::string_view text) noexcept {
+    return text.size() + sum_byte_class<markup_escape_class>(text.data(), text.data() + text.size(),
+                                                             [](unsigned char c) { return Entities[c].size() - 1; });
+}
+
+// ---------------------------------------------------------------------------
+// URL percent-encoding (RFC 3986)
+
+// Bytes outside the unreserved set A-Z a-z 0-9 - . _ ~, which are encoded.
+struct url_encode_class {
+    static bool test(unsigned char c) noexcept {
+        const unsigned char lower = c | 0x20;
+        return !((lower >= 'a' && lower <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' ||
+                 c == '~');
+    }
+#if defined(__AVX2__)
+    // Ranges are tested as min(max(v, lo), hi) == v, unsigned.
+    static unsigned mask(__m256i block) noexcept {
+        auto in_range = [](__m256i v, char lo, char hi) {
+            return _mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_max_epu8(v, _mm256_set1_epi8(lo)), _mm256_set1_epi8(hi)),
+                                     v);
+        };
+        const __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+        const __m256i unreserved = _mm256_or_si256(
+            _mm256_or_si256(in_range(lower, 'a', 'z'), in_range(block, '-', '.')),
+            _mm256_or_si256(in_range(block, '0', '9'),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('_')),
+                                            _mm256_cmpeq_epi8(block, _mm256_set1_epi8('~')))));
+        return ~static_cast<unsigned>(_mm256_movemask_epi8(unreserved));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    static unsigned mask(__m128i block) noexcept {
+        auto in_range = [](__m128i v, char lo, char hi) {
+            return _mm_cmpeq_epi8(_mm_min_epu8(_mm_max_epu8(v, _mm_set1_epi8(lo)), _mm_set1_epi8(hi)), v);
+        };
+        const __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+        const __m128i unreserved =
+            _mm_or_si128(_mm_or_si128(in_range(lower, 'a', 'z'), in_range(block, '-', '.')),
+                         _mm_or_si128(in_range(block, '0', '9'), _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('_')),
+                                                                              _mm_cmpeq_epi8(block, _mm_set1_epi8('~')))));
+        return ~static_cast<unsigned>(_mm_movemask_epi8(unreserved)) & 0xFFFFu;
+    }
+#endif
+};
+
+struct percent_class {
+    static bool test(unsigned char c) noexcept { return c == '%'; }
+#if defined(__AVX2__)
+    static unsigned mask(__m256i block) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('%'))));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    static unsigned mask(__m128i block) noexcept {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('%'))));
+    }
+#endif
+};
+
+inline void emit_percent_encoding(char*& out, const char*& p) noexcept {
+    const unsigned char c = static_cast<unsigned char>(*p++);
+    out[0] = '%';
+    out[1] = upper_hex_digits[c >> 4];
+    out[2] = upper_hex_digits[c & 0xF];
+    out += 3;
+}
+
+// Decodes the %XX at p, advancing p past it.
+inline void emit_percent_decoding(char*& out, const char*& p, const char* end) {
+    const unsigned high = end - p >= 3 ? hex_digit_value(p[1]) : 16;
+    const unsigned low = end - p >= 3 ? hex_digit_value(p[2]) : 16;
+    if ((high | low) > 15) {
+        throw std::invalid_argument("fl::url_decode: invalid percent-encoding");
+    }
+    *out++ = static_cast<char>((high << 4) | low);
+    p += 3;
+}
+
+}  // namespace detail
+
+// Length of text once escaped for a JSON string literal.
+[[nodiscard]] inline std::size_t json_escaped_size(std::string_view text) noexcept {
+    return text.size() + detail::sum_byte_class<detail::json_escape_class>(
+                             text.data(), text.data() + text.size(),
+                             [](unsigned char c) -> std::size_t { return detail::json_escape_codes[c] == 'u' ? 5 : 1; });
+}
+
+// Writes text escaped for use inside a JSON string literal: '"', '\\' and
+// control characters become escape sequences, everything else, including
+// UTF-8, is copied. The surrounding quotes are not written.
+template <sinks::character_sink Sink>
+void json_escape(Sink& sink, std::string_view text) {
+    detail::escape_into<detail::json_escape_class, 6>(sink, text, json_escaped_size, detail::emit_json_escape);
+}
+
+// Writes the decoded contents of a JSON string literal (without its quotes).
+// \uXXXX escapes, including surrogate pairs, are written as UTF-8. Throws
+// std::invalid_argument on a malformed escape, after which the sink may hold
+// part of the output.
+template <sinks::character_sink Sink>
+void json_unescape(Sink& sink, std::string_view text) {
+    const char* const end = text.data() + text.size();
+    detail::unescape_into<detail::backslash_class, 16>(
+        sink, text, [end](char*& out, const char*& p) { out += detail::decode_json_escape(p, end, out); });
+}
+
+// Length of text once escaped by html_escape().
+[[nodiscard]] inline std::size_t html_escaped_size(std::string_view text) noexcept {
+    return detail::markup_escaped_size<detail::html_entities>(text);
+}
+
+// Length of text once escaped by xml_escape().
+[[nodiscard]] inline std::size_t xml_escaped_size(std::string_view text) noexcept {
+    return detail::markup_escaped_size<detail::xml_entities>(text);
+}
+
+// Length of text once percent-encoded by url_encode().
+[[nodiscard]] inline std::size_t url_encoded_size(std::string_view text) noexcept {
+    return text.size() + 2 * detail::sum_byte_class<detail::url_encode_class>(
+                                 text.data(), text.data() + text.size(), [](unsigned char) { return 1; });
+}
+
+// Writes text escaped for HTML element content and quoted attribute values:
+// & < > " ' become &amp; &lt; &gt; &quot; &#39;. Other bytes are copied.
+template <sinks::character_sink Sink>
+void html_escape(Sink& sink, std::string_view text) {
+    detail::escape_into<detail::markup_escape_class, 6>(sink, text, html_escaped_size,
+                                                         detail::emit_markup_escape<detail::html_entities>);
+}
+
+// As html_escape(), with the XML apostrophe entity &apos;.
+template <sinks::character_sink Sink>
+void xml_escape(Sink& sink, std::string_view text) {
+    detail::escape_into<detail::markup_escape_class, 6>(sink, text, xml_escaped_size,
+                                                         detail::emit_markup_escape<detail::xml_entities>);
+}
+
+// Percent-encodes text as RFC 3986 requires for a URL component: every byte
+// outside A-Z a-z 0-9 - . _ ~ becomes %XX with upper-case hex.
+template <sinks::character_sink Sink>
+void url_encode(Sink& sink, std::string_view text) {
+    detail::escape_into<detail::url_encode_class, 3>(sink, text, url_encoded_size, detail::emit_percent_encoding);
+}
+
+// Decodes %XX sequences; every other byte, '+' included, is copied. Throws
+// std::invalid_argument on a '%' not followed by two hex digits, after which
+// the sink may hold part of the output.
+template <sinks::character_sink Sink>
+void url_decode(Sink& sink, std::string_view text) {
+    const char* const end = text.data() + text.size();
+    detail::unescape_into<detail::percent_class, 4>(
+        sink, text, [end](char*& out, const char*& p) { detail::emit_percent_decoding(out, p, end); });
+}
+
+}  // namespace fl
+
+#endif  // FL_ESCAPE_HPP
@@ -8,15 +8,40 @@
 // Supports alignment, padding, width, precision, and base conversions for
 // integral and floating-point types. Output is written through a sink
 // abstraction so callers can target fixed buffers or growing storage.
-
+//
+// Literal format strings are parsed and validated at compile time through
+// fl::format_string: malformed placeholders, out-of-range argument references,
+// and specifiers that do not suit the argument type are compile errors. Format
+// strings only known at runtime are passed through fl::runtime_format() and
+// report the same problems by throwing fl::format_error.
+//
+// Other types become formattable by specialising fl::formatter<T>; the fl
+// string types, std::string and std::string_view have built-in
+// specialisations, and enumerations print their underlying value.
+
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <cstdint>
 #include <type_traits>
 #include <limits>
 #include <stdexcept>
-#include <functional>
 #include <array>
+#include <string>
+#include <span>
+#include <string_view>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "fl/builder.hpp"
+#include "fl/encoding.hpp"
+#include "fl/escape.hpp"
+#include "fl/immutable_string.hpp"
+#include "fl/rope.hpp"
+#include "fl/sinks.hpp"
+#include "fl/substring_view.hpp"
+#include "fl/number_format.hpp"
 #include "fl/profiling.hpp"
 
 namespace fl {
@@ -24,166 +49,364 @@ namespace fl {
 // Forward declaration.
 class string;
 
-namespace detail {
+// The formatting and output APIs share one set of sinks.
+using buffer_sink = sinks::buffer_sink;
+using growing_sink = sinks::growing_sink;
 
-// Abstract sink interface for formatting output.
-struct sink_base {
-    virtual ~sink_base() = default;
-    virtual void write(const char* data, std::size_t len) = 0;
+// Thrown when a runtime format string is malformed or does not match its
+// arguments. Literal format strings report the same problems at compile time.
+class format_error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
 };
 
-// Formatting sink that writes to a caller-provided fixed-size buffer. Throws
-// std::overflow_error if the output exceeds the buffer capacity.
-class buffer_sink : public sink_base {
-public:
-    buffer_sink(char* buffer, std::size_t capacity) noexcept
-        : _buffer(buffer), _capacity(capacity), _size(0) {}
+// Customisation point for formatting a type the engine does not know about.
+// A specialisation provides
+//
+//   constexpr const char* parse(const char* first, const char* last);
+//   template <typename Sink> void format(const T& value, Sink& sink) const;
+//
+// parse() receives the specification between ':' and '}' (empty for "{}")
+// and returns one past the last character it understood; anything short of
+// last is reported as an invalid specifier. It runs at compile time for
+// literal format strings, so it must be constexpr. format() writes the value
+// to any character sink; a format() taking sinks::output_sink& also works.
+// Types without a specialisation are not formattable.
+template <typename T>
+struct formatter {
+    formatter() = delete;
+};
 
-    void write(const char* data, std::size_t len) override {
-        if (_size + len > _capacity) {
-            throw std::overflow_error("fl::buffer_sink: output buffer overflow");
+// Structural string wrapper so a string literal can be a template argument.
+template <std::size_t N>
+struct fixed_string {
+    char data[N]{};
+
+    consteval fixed_string(const char (&str)[N]) {
+        for (std::size_t i = 0; i < N; ++i) {
+            data[i] = str[i];
         }
-        std::memcpy(_buffer + _size, data, len);
-        _size += len;
     }
 
-    std::size_t size() const noexcept { return _size; }
-    char* buffer() const noexcept { return _buffer; }
-
-private:
-    char* _buffer;
-    std::size_t _capacity;
-    std::size_t _size;
+    [[nodiscard]] constexpr std::string_view view() const noexcept { return {data, N - 1}; }
 };
 
-// Formatting sink backed by a dynamically growing std::string.
-class growing_sink : public sink_base {
-public:
-    growing_sink(std::size_t initial_capacity = 256) : _buffer(), _size(0) {
-        _buffer.reserve(initial_capacity);
-    }
+// A named argument, referenced in the format string as {name}. The name is
+// looked up per call through a small table built alongside the arguments.
+// Holds a reference: use it only within the formatting call.
+template <typename T>
+struct named_arg {
+    std::string_view name;
+    const T& value;
+};
 
-    void write(const char* data, std::size_t len) override {
-        _buffer.append(data, len);
-        _size += len;
-    }
+// A named argument whose name is part of its type, so {name} in a literal
+// format string is resolved and checked at compile time.
+template <fixed_string Name, typename T>
+struct static_named_arg {
+    const T& value;
+};
 
-    std::size_t size() const noexcept { return _size; }
-    const std::string& buffer() const noexcept { return _buffer; }
-    std::string& buffer() noexcept { return _buffer; }
-    fl::string to_fl_string() const;
+// fl::arg("user", v) names an argument for {user}.
+template <typename T>
+constexpr named_arg<T> arg(std::string_view name, const T& value) noexcept {
+    return {name, value};
+}
 
-private:
-    std::string _buffer;
-    std::size_t _size;
-};
+// fl::arg<"user">(v) names an argument for {user} at compile time.
+template <fixed_string Name, typename T>
+constexpr static_named_arg<Name, T> arg(const T& value) noexcept {
+    return {value};
+}
 
-// Stateless utility for converting integers to decimal strings without any
-// heap allocation.
-class integer_formatter {
-public:
-    static std::size_t format_int64(char* buffer, std::size_t capacity, int64_t value) noexcept {
-        if (capacity == 0) return 0;
+// Format implementation for common types.
+namespace detail {
 
-        if (value == 0) {
-            buffer[0] = '0';
-            return 1;
+    template <typename T>
+    inline constexpr bool dependent_false_v = false;
+
+    // Named-argument wrappers are formatted as the value they carry.
+    template <typename T>
+    struct named_arg_traits {
+        static constexpr bool is_named = false;
+        static constexpr bool is_runtime = false;
+        using value_type = T;
+    };
+
+    template <typename T>
+    struct named_arg_traits<named_arg<T>> {
+        static constexpr bool is_named = true;
+        static constexpr bool is_runtime = true;
+        using value_type = T;
+    };
+
+    template <fixed_string Name, typename T>
+    struct named_arg_traits<static_named_arg<Name, T>> {
+        static constexpr bool is_named = true;
+        static constexpr bool is_runtime = false;
+        static constexpr std::string_view name = Name.view();
+        using value_type = T;
+    };
+
+    template <typename T>
+    inline constexpr bool is_named_arg_v = named_arg_traits<std::decay_t<T>>::is_named;
+
+    template <typename T>
+    constexpr const auto& unwrap_arg(const T& arg) noexcept {
+        if constexpr (is_named_arg_v<T>) {
+            return arg.value;
+        } else {
+            return arg;
         }
+    }
 
-        bool negative = value < 0;
-        uint64_t uvalue = negative ? static_cast<uint64_t>(-value) : static_cast<uint64_t>(value);
-
-        char temp[20];
-        std::size_t len = 0;
-        while (uvalue > 0) {
-            temp[len++] = '0' + (uvalue % 10);
-            uvalue /= 10;
+    template <typename T>
+    constexpr std::string_view arg_name(const T& arg) noexcept {
+        if constexpr (named_arg_traits<T>::is_runtime) {
+            return arg.name;
+        } else {
+            return named_arg_traits<T>::name;
         }
+    }
 
-        if (negative && capacity > len) {
-            buffer[0] = '-';
-            std::reverse_copy(temp, temp + len, buffer + 1);
-            return len + 1;
+    // Contiguous string types, formatted through a std::string_view of their
+    // characters.
+    template <typename U>
+    inline constexpr bool is_string_like_v =
+        std::is_same_v<U, const char*> || std::is_same_v<U, char*> || std::is_same_v<U, std::string_view> ||
+        std::is_same_v<U, std::string> || std::is_same_v<U, fl::string> ||
+        std::is_same_v<U, fl::immutable_string> || std::is_same_v<U, fl::immutable_string_view> ||
+        std::is_same_v<U, fl::substring_view>;
+
+    template <typename V>
+    constexpr std::string_view as_string_view(const V& value) noexcept {
+        if constexpr (std::is_convertible_v<const V&, const char*>) {
+            return std::string_view(static_cast<const char*>(value));
+        } else {
+            return std::string_view(value.data(), value.size());
         }
+    }
 
-        std::reverse_copy(temp, temp + len, buffer);
-        return len;
+    // True when fl::formatter<U> has been specialised.
+    template <typename U>
+    inline constexpr bool has_formatter_v = std::is_default_constructible_v<fl::formatter<U>>;
+
+    template <typename U>
+    inline constexpr bool is_pointer_arg_v =
+        std::is_same_v<U, const void*> || std::is_same_v<U, void*> || std::is_same_v<U, std::nullptr_t>;
+
+    // Writes the address as 0x-prefixed lowercase hexadecimal ending at end
+    // and returns where it starts. end needs 2 + 2 * sizeof(void*) bytes of
+    // room before it.
+    inline char* write_pointer_backwards(char* end, const void* value) noexcept {
+        auto address = reinterpret_cast<std::uintptr_t>(value);
+        char* p = end;
+        do {
+            *--p = "0123456789abcdef"[address & 0xF];
+            address >>= 4;
+        } while (address != 0);
+        *--p = 'x';
+        *--p = '0';
+        return p;
     }
 
-    static std::size_t format_uint64(char* buffer, std::size_t capacity, uint64_t value) noexcept {
-        if (capacity == 0) return 0;
+    inline constexpr std::size_t max_pointer_chars = 2 + 2 * sizeof(std::uintptr_t);
 
-        if (value == 0) {
-            buffer[0] = '0';
-            return 1;
-        }
+    // Not constexpr on purpose: reaching this during constant evaluation of a
+    // format_string makes the call site ill-formed, and the compiler quotes the
+    // message in its diagnostic.
+    [[noreturn]] inline void throw_format_error(const char* message) {
+        throw format_error(message);
+    }
 
-        char temp[20];
-        std::size_t len = 0;
-        while (value > 0) {
-            temp[len++] = '0' + (value % 10);
-            value /= 10;
+    // Writes one character through put() when the sink has it.
+    template <typename Sink>
+    inline void put_char(Sink& sink, char ch) {
+        if constexpr (requires { sink.put(ch); }) {
+            sink.put(ch);
+        } else {
+            sink.write(&ch, 1);
         }
-
-        std::reverse_copy(temp, temp + len, buffer);
-        return len;
     }
 
-private:
-    static void reverse_copy_impl(const char* first, const char* last, char* dest) noexcept {
-        while (first != last) {
-            *dest++ = *--last;
+    // Writes count copies of ch. Direct sinks are filled in place; others
+    // receive the run in blocks, one write per 64 characters.
+    template <typename Sink>
+    inline void write_fill(Sink& sink, char ch, std::size_t count) {
+        if (count <= 1) {
+            if (count == 1) put_char(sink, ch);
+            return;
+        }
+        if constexpr (sinks::direct_sink<Sink>) {
+            const std::span<char> space = sink.prepare(count);
+            if (space.size() >= count) {
+                std::memset(space.data(), ch, count);
+                sink.commit(count);
+                return;
+            }
         }
+        char block[64];
+        std::memset(block, ch, std::min(count, sizeof(block)));
+        while (count > sizeof(block)) {
+            sink.write(block, sizeof(block));
+            count -= sizeof(block);
+        }
+        sink.write(block, count);
     }
-};
-
-}  // namespace detail
 
-// Reuse the sinks' buffer_sink implementation to avoid duplicate symbols.
-// sinks.hpp is included before this header via fl.hpp, so import the
-// implementation here for formatting APIs.
-using buffer_sink = sinks::buffer_sink;
+    // Passes a size hint to sinks that can use one.
+    template <typename Sink>
+    inline void reserve_hint(Sink& sink, std::size_t len) {
+        if constexpr (requires { sink.reserve(len); }) {
+            sink.reserve(len);
+        }
+    }
 
-// Format implementation for common types.
-namespace detail {
+    // Whether Sink's prepare() and commit() are direct calls. Through an
+    // output_sink& they are two virtual calls, which cost more than copying a
+    // number's few characters out of a temporary with one.
+    template <typename Sink>
+    inline constexpr bool inline_direct_sink =
+        sinks::direct_sink<Sink> && (!std::is_polymorphic_v<Sink> || std::is_final_v<Sink>);
+
+    // Writes the output of fill(char* out) -> char* end, at most MaxLen
+    // characters. Sinks with inline prepare() receive it in place; others via
+    // a stack buffer.
+    template <std::size_t MaxLen, typename Sink, typename Fill>
+    inline void write_bounded(Sink& sink, Fill&& fill) {
+        if constexpr (inline_direct_sink<Sink>) {
+            const std::span<char> space = sink.prepare(MaxLen);
+            if (space.size() >= MaxLen) {
+                sink.commit(static_cast<std::size_t>(fill(space.data()) - space.data()));
+                return;
+            }
+        }
+        char temp[MaxLen];
+        sink.write(temp, static_cast<std::size_t>(fill(temp) - temp));
+    }
 
-    // Formats a single value and writes it to the sink.
     template <typename Sink, typename T>
-    void format_value(Sink& sink, T value) {
-        char temp[64];
-        std::size_t len = 0;
+    void format_custom(Sink& sink, const T& value, std::string_view spec);
 
-        if constexpr (std::is_same_v<T, const char*>) {
-            sink.write(value, std::strlen(value));
-        } else if constexpr (std::is_same_v<T, const fl::string&>) {
-            sink.write(value.data(), value.size());
-        } else if constexpr (std::is_same_v<T, char>) {
-            temp[0] = value;
-            sink.write(temp, 1);
-        } else if constexpr (std::is_same_v<T, bool>) {
+    // Formats a single value and writes it to the sink. Character arrays decay
+    // to pointers so string literals are accepted directly.
+    template <typename Sink, typename T>
+    void format_value(Sink& sink, const T& value) {
+        using U = std::decay_t<T>;
+
+        if constexpr (is_string_like_v<U>) {
+            const std::string_view text = as_string_view(value);
+            sink.write(text.data(), text.size());
+        } else if constexpr (is_pointer_arg_v<U>) {
+            // Pointers print as 0x-prefixed lowercase hexadecimal.
+            char temp[max_pointer_chars];
+            char* end = temp + sizeof(temp);
+            const char* p = write_pointer_backwards(end, static_cast<const void*>(value));
+            sink.write(p, static_cast<std::size_t>(end - p));
+        } else if constexpr (std::is_same_v<U, char>) {
+            put_char(sink, value);
+        } else if constexpr (std::is_same_v<U, bool>) {
             if (value) {
                 sink.write("true", 4);
             } else {
                 sink.write("false", 5);
             }
-        } else if constexpr (std::is_same_v<T, int64_t>) {
-            len = integer_formatter::format_int64(temp, sizeof(temp), value);
-            sink.write(temp, len);
-        } else if constexpr (std::is_same_v<T, uint64_t>) {
-            len = integer_formatter::format_uint64(temp, sizeof(temp), value);
-            sink.write(temp, len);
-        } else if constexpr (std::is_integral_v<T>) {
-            if constexpr (std::is_signed_v<T>) {
-                len = integer_formatter::format_int64(temp, sizeof(temp), static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<U>) {
+            write_bounded<integer_formatter::max_decimal_chars>(sink, [&](char* out) {
+                if constexpr (std::is_signed_v<U>) {
+                    return out + integer_formatter::format_int64(out, integer_formatter::max_decimal_chars,
+                                                                 static_cast<int64_t>(value));
+                } else {
+                    return out + integer_formatter::format_uint64(out, integer_formatter::max_decimal_chars,
+                                                                  static_cast<uint64_t>(value));
+                }
+            });
+        } else if constexpr (std::is_floating_point_v<U>) {
+            write_bounded<float_formatter::max_shortest_chars>(sink, [&](char* out) {
+                if constexpr (std::is_same_v<U, float>) {
+                    return out + float_formatter::format_shortest(out, value);
+                } else {
+                    return out + float_formatter::format_shortest(out, static_cast<double>(value));
+                }
+            });
+        } else if constexpr (has_formatter_v<U>) {
+            format_custom(sink, value, std::string_view());
+        } else if constexpr (std::is_enum_v<U>) {
+            format_value(sink, static_cast<std::underlying_type_t<U>>(value));
+        } else {
+            static_assert(dependent_false_v<T>, "Unsupported type for formatting");
+        }
+    }
+
+    // Argument categories used to validate format specifications against the
+    // argument they apply to.
+    enum class arg_kind : std::uint8_t {
+        integer,         // Integral types other than bool and char.
+        character,       // char: text, 'c', or an integer presentation.
+        boolean,         // bool: text, 's', or an integer presentation.
+        floating_point,
+        string,
+        pointer,
+        custom,          // Formatted by an fl::formatter specialisation.
+    };
+
+    template <typename T>
+    constexpr arg_kind classify_arg() noexcept {
+        using U = std::decay_t<T>;
+        if constexpr (is_named_arg_v<U>) {
+            return classify_arg<typename named_arg_traits<U>::value_type>();
+        } else if constexpr (std::is_same_v<U, char>) {
+            return arg_kind::character;
+        } else if constexpr (std::is_same_v<U, bool>) {
+            return arg_kind::boolean;
+        } else if constexpr (std::is_integral_v<U>) {
+            return arg_kind::integer;
+        } else if constexpr (std::is_floating_point_v<U>) {
+            return arg_kind::floating_point;
+        } else if constexpr (is_string_like_v<U>) {
+            return arg_kind::string;
+        } else if constexpr (is_pointer_arg_v<U>) {
+            return arg_kind::pointer;
+        } else if constexpr (has_formatter_v<U>) {
+            return arg_kind::custom;
+        } else if constexpr (std::is_enum_v<U>) {
+            return arg_kind::integer;
+        } else {
+            static_assert(dependent_false_v<T>, "Unsupported type for formatting");
+        }
+    }
+
+    // Runs formatter<U>::parse over a specification; used to check the
+    // specifiers of custom arguments in a literal format string.
+    template <typename U>
+    constexpr const char* parse_custom_spec(const char* first, const char* last) {
+        fl::formatter<U> f;
+        return f.parse(first, last);
+    }
+
+    // What the format-string checker knows about one argument type.
+    struct arg_info {
+        arg_kind kind = arg_kind::integer;
+        const char* (*parse_spec)(const char*, const char*) = nullptr;  // Set for, and only for, custom kinds.
+        std::string_view name{};     // Set for fl::arg<"name">.
+        bool runtime_named = false;  // Set for fl::arg("name", v).
+    };
+
+    template <typename T>
+    constexpr arg_info describe_arg() noexcept {
+        using U = std::decay_t<T>;
+        if constexpr (is_named_arg_v<U>) {
+            arg_info info = describe_arg<typename named_arg_traits<U>::value_type>();
+            if constexpr (named_arg_traits<U>::is_runtime) {
+                info.runtime_named = true;
             } else {
-                len = integer_formatter::format_uint64(temp, sizeof(temp), static_cast<uint64_t>(value));
+                info.name = named_arg_traits<U>::name;
             }
-            sink.write(temp, len);
-        } else if constexpr (std::is_floating_point_v<T>) {
-            len = std::snprintf(temp, sizeof(temp), "%g", static_cast<double>(value));
-            if (len > 0) sink.write(temp, len);
+            return info;
+        } else if constexpr (classify_arg<T>() == arg_kind::custom) {
+            return arg_info{arg_kind::custom, &parse_custom_spec<U>};
         } else {
-            static_assert(false, "Unsupported type for formatting");
+            return arg_info{classify_arg<T>(), nullptr};
         }
     }
 
@@ -198,439 +421,1452 @@ namespace detail {
     std::size_t width = 0;
     std::size_t precision = 6;
     bool precision_set = false;         // True when precision was explicitly provided.
-    char type = '\0';                   // Type specifier: d, x, b, o, f, e, g, s, c.
+    char type = '\0';                   // Type specifier: d, x, b, o, f, F, e, g, s, j, c, p.
 
-    // Parses the format specification starting at spec_start and populates
-    // the given spec struct. Returns the number of characters consumed.
-    static std::size_t parse(const char* spec_start, format_spec& spec) {
-        const char* p = spec_start;
+    // Parses the format specification in [first, last) and populates the
+    // given spec struct. Returns a pointer one past the last character
+    // consumed; anything short of last is not a valid specification.
+    static constexpr const char* parse(const char* first, const char* last, format_spec& spec) noexcept {
+        auto is_align = [](char c) { return c == '<' || c == '>' || c == '^' || c == '='; };
+        const char* p = first;
 
         // Check for sign (+). Allow sign before or after fill+align.
-        if (*p == '+') {
+        if (p != last && *p == '+') {
             spec.sign = true;
             ++p;
         }
 
         // Check for fill + align (e.g., "0>" or "*<" or "*^").
-        if (*p && *(p + 1) && (*(p + 1) == '<' || *(p + 1) == '>' || *(p + 1) == '^' || *(p + 1) == '=')) {
-            spec.fill = *p;
-            spec.align = *(p + 1);
+        if (last - p >= 2 && is_align(p[1])) {
+            spec.fill = p[0];
+            spec.align = p[1];
             p += 2;
-        } else if (*p && (*p == '<' || *p == '>' || *p == '^' || *p == '=')) {
+        } else if (p != last && is_align(*p)) {
             spec.align = *p;
             ++p;
         }
 
         // Check for base prefix (#).
-        if (*p == '#') {
+        if (p != last && *p == '#') {
             spec.show_base = true;
             ++p;
         }
 
         // Parse width.
-        while (*p && *p >= '0' && *p <= '9') {
-            spec.width = spec.width * 10 + (*p - '0');
+        while (p != last && *p >= '0' && *p <= '9') {
+            spec.width = spec.width * 10 + static_cast<std::size_t>(*p - '0');
             ++p;
         }
 
         // Parse precision.
-        if (*p == '.') {
+        if (p != last && *p == '.') {
             ++p;
             spec.precision = 0;
             spec.precision_set = true;
-            while (*p && *p >= '0' && *p <= '9') {
-                spec.precision = spec.precision * 10 + (*p - '0');
+            while (p != last && *p >= '0' && *p <= '9') {
+                spec.precision = spec.precision * 10 + static_cast<std::size_t>(*p - '0');
                 ++p;
             }
         }
 
         // Parse type specifier.
-        if (*p && (*p == 'd' || *p == 'x' || *p == 'X' || *p == 'b' || *p == 'B' ||
-                   *p == 'o' || *p == 'f' || *p == 'e' || *p == 'E' ||
-                   *p == 'g' || *p == 'G' || *p == 's' || *p == 'c')) {
+        if (p != last && (*p == 'd' || *p == 'x' || *p == 'X' || *p == 'b' || *p == 'B' ||
+                          *p == 'o' || *p == 'f' || *p == 'F' || *p == 'e' || *p == 'E' ||
+                          *p == 'g' || *p == 'G' || *p == 's' || *p == 'j' || *p == 'c' || *p == 'p')) {
             spec.type = *p;
             ++p;
         }
 
-        return p - spec_start;
+        return p;
     }
 };
 
-// Formats an integer value according to the given format_spec, handling base
-// conversion, sign, prefix, alignment, and padding.
-template <typename Sink>
-void format_int_with_spec(Sink& sink, int64_t value, const format_spec& spec) {
-    char digits[128];
-    std::size_t digit_len = 0;
-    const char* prefix = "";
-    std::size_t prefix_len = 0;
-
-    char base_char = spec.type ? spec.type : 'd';
-    int base = 10;
-    bool is_negative = value < 0;
-    uint64_t abs_value = is_negative ? static_cast<uint64_t>(-value) : static_cast<uint64_t>(value);
-
-    switch (base_char) {
-        case 'x':
-            base = 16;
-            if (spec.show_base && value != 0) { prefix = "0x"; prefix_len = 2; }
+// Rejects specifications that make no sense for the argument kind, such as a
+// precision on an integer or a hexadecimal presentation for a string.
+constexpr void check_format_spec(arg_kind kind, const format_spec& spec) {
+    const char t = spec.type;
+    switch (kind) {
+        case arg_kind::integer:
+            if (spec.precision_set) {
+                throw_format_error("precision not allowed for integer arguments");
+            }
+            if (t != '\0' && t != 'd' && t != 'x' && t != 'X' && t != 'b' && t != 'B' && t != 'o') {
+                throw_format_error("invalid type specifier for integer argument");
+            }
             break;
-        case 'X':
-            base = 16;
-            if (spec.show_base && value != 0) { prefix = "0X"; prefix_len = 2; }
+        case arg_kind::character:
+        case arg_kind::boolean: {
+            const char text_type = kind == arg_kind::character ? 'c' : 's';
+            if (spec.precision_set) {
+                throw_format_error("precision not allowed for character and boolean arguments");
+            }
+            if (t == '\0' || t == text_type) {
+                if (spec.sign || spec.show_base || spec.align == '=') {
+                    throw_format_error("sign, '#', and '=' alignment not allowed for text presentation");
+                }
+            } else if (t != 'd' && t != 'x' && t != 'X' && t != 'b' && t != 'B' && t != 'o') {
+                throw_format_error(kind == arg_kind::character ? "invalid type specifier for character argument"
+                                                               : "invalid type specifier for boolean argument");
+            }
             break;
-        case 'b':
-        case 'B':
-            base = 2;
-            if (spec.show_base && value != 0) { prefix = "0b"; prefix_len = 2; }
+        }
+        case arg_kind::floating_point:
+            if (t != '\0' && t != 'f' && t != 'F' && t != 'e' && t != 'E' && t != 'g' && t != 'G') {
+                throw_format_error("invalid type specifier for floating-point argument");
+            }
             break;
-        case 'o':
-            base = 8;
-            if (spec.show_base && value != 0) { prefix = "0"; prefix_len = 1; }
+        case arg_kind::string:
+            if (t != '\0' && t != 's' && t != 'j') {
+                throw_format_error("invalid type specifier for string argument");
+            }
+            if (spec.sign || spec.show_base || spec.align == '=') {
+                throw_format_error("sign, '#', and '=' alignment not allowed for string arguments");
+            }
             break;
-        default:
-            base = 10;
+        case arg_kind::pointer:
+            if (t != '\0' && t != 'p') {
+                throw_format_error("invalid type specifier for pointer argument");
+            }
+            if (spec.sign || spec.show_base || spec.precision_set) {
+                throw_format_error("sign, '#', and precision not allowed for pointer arguments");
+            }
             break;
+        case arg_kind::custom:
+            // Checked by the type's formatter.
+            break;
+    }
+}
+
+inline constexpr std::size_t no_arg = static_cast<std::size_t>(-1);
+
+// A {name} the compile-time check could not resolve because some arguments
+// are named only at runtime; it is looked up when formatting.
+inline constexpr std::size_t deferred_arg = no_arg - 1;
+
+// One step of a parsed format string: a literal run followed by at most one
+// replacement field. Literals and specifications are stored as offsets into
+// the format string so a segment table never owns text. The specification is
+// parsed with the built-in grammar up front; spec_valid records whether that
+// consumed all of it, which only custom formatters may do without.
+struct format_segment {
+    std::size_t literal_offset = 0;
+    std::size_t literal_size = 0;
+    std::size_t arg_index = no_arg;
+    std::size_t spec_offset = 0;
+    std::size_t spec_size = 0;
+    std::size_t name_offset = 0;  // The {name} of a named argument.
+    std::size_t name_size = 0;
+    bool has_spec = false;
+    bool spec_valid = true;
+    format_spec spec{};
+};
+
+constexpr bool is_name_start(char c) noexcept {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+constexpr bool is_name_char(char c) noexcept {
+    return is_name_start(c) || (c >= '0' && c <= '9');
+}
+
+// Scans the segment starting at pos and returns the position just past it.
+// Escaped braces end the current literal so that every segment's literal is a
+// single contiguous slice of the format string. Shared by the compile-time and
+// runtime paths so both accept exactly the same grammar.
+//
+// A replacement field names its argument by position ({0}), by name ({user},
+// resolved through lookup(name)) or not at all ({}), which takes the next
+// argument in order. As in std::format, automatic and explicit positions
+// cannot be mixed; next_arg becomes no_arg once an explicit one is seen.
+template <typename Lookup>
+constexpr std::size_t scan_segment(std::string_view fmt, std::size_t pos, std::size_t& next_arg,
+                                   std::size_t arg_count, format_segment& seg, Lookup&& lookup) {
+    seg = format_segment{};
+    seg.literal_offset = pos;
+
+    // A plain loop: string_view::find_first_of calls memchr once per byte.
+    std::size_t brace = pos;
+    while (brace < fmt.size() && fmt[brace] != '{' && fmt[brace] != '}') {
+        ++brace;
+    }
+    if (brace == fmt.size()) {
+        seg.literal_size = fmt.size() - pos;
+        return fmt.size();
+    }
+
+    const bool doubled = brace + 1 < fmt.size() && fmt[brace + 1] == fmt[brace];
+    if (doubled) {
+        // "{{" or "}}": keep one brace as literal text.
+        seg.literal_size = brace + 1 - pos;
+        return brace + 2;
+    }
+    if (fmt[brace] == '}') {
+        throw_format_error("unmatched '}' in format string");
+    }
+
+    seg.literal_size = brace - pos;
+    std::size_t close = brace + 1;
+    while (close < fmt.size() && fmt[close] != '}') {
+        ++close;
+    }
+    if (close == fmt.size()) {
+        throw_format_error("unmatched '{' in format string");
     }
 
-    if (abs_value == 0) {
-        digits[digit_len++] = '0';
+    std::size_t field = brace + 1;
+    if (field == close || fmt[field] == ':') {
+        if (next_arg == no_arg) {
+            throw_format_error("cannot switch from manual to automatic argument indexing");
+        }
+        if (next_arg >= arg_count) {
+            throw_format_error("argument index out of range");
+        }
+        seg.arg_index = next_arg++;
+    } else if (fmt[field] >= '0' && fmt[field] <= '9') {
+        std::size_t index = 0;
+        while (field != close && fmt[field] >= '0' && fmt[field] <= '9') {
+            if (index <= arg_count) {
+                index = index * 10 + static_cast<std::size_t>(fmt[field] - '0');
+            }
+            ++field;
+        }
+        if (next_arg != no_arg && next_arg != 0) {
+            throw_format_error("cannot switch from automatic to manual argument indexing");
+        }
+        next_arg = no_arg;
+        if (index >= arg_count) {
+            throw_format_error("argument index out of range");
+        }
+        seg.arg_index = index;
+    } else if (is_name_start(fmt[field])) {
+        seg.name_offset = field;
+        while (field != close && is_name_char(fmt[field])) {
+            ++field;
+        }
+        seg.name_size = field - seg.name_offset;
+        seg.arg_index = lookup(fmt.substr(seg.name_offset, seg.name_size));
+        if (seg.arg_index == no_arg) {
+            throw_format_error("argument name not found");
+        }
     } else {
-        char temp[128];
-        std::size_t temp_len = 0;
-        while (abs_value > 0) {
-            int digit = abs_value % base;
-            temp[temp_len++] = (digit < 10) ? ('0' + digit) :
-                          (base_char == 'X' || base_char == 'B') ?
-                          ('A' + digit - 10) : ('a' + digit - 10);
-            abs_value /= base;
+        throw_format_error("invalid replacement field");
+    }
+
+    if (field != close) {
+        if (fmt[field] != ':') {
+            throw_format_error("invalid replacement field");
         }
-        for (std::size_t i = 0; i < temp_len; ++i) {
-            digits[digit_len++] = temp[temp_len - 1 - i];
+        const char* spec_first = fmt.data() + field + 1;
+        const char* spec_last = fmt.data() + close;
+        seg.spec_offset = field + 1;
+        seg.spec_size = close - (field + 1);
+        seg.spec_valid = format_spec::parse(spec_first, spec_last, seg.spec) == spec_last;
+        seg.has_spec = true;
+    }
+    return close + 1;
+}
+
+// Resolves {name} against the argument types: a compile-time name matches
+// directly, and a name that may belong to a runtime-named argument is
+// deferred to the call.
+template <std::size_t N>
+constexpr std::size_t find_named_arg(const std::array<arg_info, N>& args, std::string_view name) {
+    bool runtime_names = false;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (!args[i].name.empty() && args[i].name == name) {
+            return i;
         }
+        runtime_names = runtime_names || args[i].runtime_named;
     }
+    return runtime_names ? deferred_arg : no_arg;
+}
 
-    char sign_char = '\0';
-    std::size_t sign_len = 0;
-    if (is_negative) {
-        sign_char = '-';
-        sign_len = 1;
-    } else if (spec.sign) {
-        sign_char = '+';
-        sign_len = 1;
+// Checks one segment's specification against its argument. Custom arguments
+// are checked by their formatter's parse().
+constexpr void check_segment_spec(std::string_view fmt, const format_segment& seg, const arg_info& info) {
+    if (info.kind == arg_kind::custom) {
+        // describe_arg() always sets parse_spec for custom kinds. Testing it
+        // against null is not a constant expression under GCC's
+        // -fsanitize=undefined or -fno-delete-null-pointer-checks.
+        const char* first = fmt.data() + seg.spec_offset;
+        const char* last = first + seg.spec_size;
+        if (info.parse_spec(first, last) != last) {
+            throw_format_error("invalid format specifier");
+        }
+        return;
+    }
+    if (!seg.has_spec) {
+        return;
     }
+    if (!seg.spec_valid) {
+        throw_format_error("invalid format specifier");
+    }
+    check_format_spec(info.kind, seg.spec);
+}
+
+// Validates a whole format string against the argument kinds. Used by the
+// consteval format_string constructor; any failure is a compile error.
+template <std::size_t N>
+constexpr void check_format_string(std::string_view fmt, const std::array<arg_info, N>& args) {
+    std::size_t pos = 0;
+    std::size_t next_arg = 0;
+    auto lookup = [&](std::string_view name) { return find_named_arg(args, name); };
+    while (pos < fmt.size()) {
+        format_segment seg;
+        pos = scan_segment(fmt, pos, next_arg, N, seg, lookup);
+        if (seg.arg_index != no_arg && seg.arg_index != deferred_arg) {
+            check_segment_spec(fmt, seg, args[seg.arg_index]);
+        }
+    }
+}
+
+template <std::size_t N>
+constexpr std::size_t count_segments(std::string_view fmt, const std::array<arg_info, N>& kinds) {
+    check_format_string(fmt, kinds);
+    std::size_t pos = 0;
+    std::size_t next_arg = 0;
+    std::size_t count = 0;
+    auto lookup = [&](std::string_view name) { return find_named_arg(kinds, name); };
+    while (pos < fmt.size()) {
+        format_segment seg;
+        pos = scan_segment(fmt, pos, next_arg, N, seg, lookup);
+        ++count;
+    }
+    return count;
+}
 
-    std::size_t total_content = sign_len + prefix_len + digit_len;
+template <std::size_t Count, std::size_t N>
+constexpr std::array<format_segment, Count> parse_segments(std::string_view fmt,
+                                                           const std::array<arg_info, N>& kinds) {
+    std::array<format_segment, Count> segments{};
+    std::size_t pos = 0;
+    std::size_t next_arg = 0;
+    auto lookup = [&](std::string_view name) { return find_named_arg(kinds, name); };
+    for (std::size_t i = 0; i < Count; ++i) {
+        pos = scan_segment(fmt, pos, next_arg, N, segments[i], lookup);
+    }
+    return segments;
+}
+
+// Compile-time segment table for a static_format_string and argument list.
+template <auto Str, typename... Args>
+struct static_format_table {
+    static constexpr std::array<arg_info, sizeof...(Args)> kinds{describe_arg<Args>()...};
+    static constexpr std::size_t count = count_segments(Str.view(), kinds);
+    static constexpr std::array<format_segment, count> segments =
+        parse_segments<count>(Str.view(), kinds);
+};
+
+}  // namespace detail
+
+// Marks a format string that is only known at runtime. It is parsed on every
+// call and errors are reported by throwing fl::format_error.
+struct runtime_format_string {
+    std::string_view str;
+};
+
+inline runtime_format_string runtime_format(std::string_view fmt) noexcept {
+    return runtime_format_string{fmt};
+}
+
+// A format string checked against its argument types. Constructing one from a
+// constant expression parses every placeholder and specifier at compile time,
+// so a malformed string or a specifier that does not suit its argument fails
+// the build instead of misformatting at runtime. Only the view is kept: a
+// function parameter is never a constant expression, so the parse result could
+// not be used to specialise the call anyway. For fully expanded formatting see
+// the _fmt literal below.
+template <typename... Args>
+class basic_format_string {
+public:
+    template <typename S>
+        requires std::convertible_to<const S&, std::string_view>
+    consteval basic_format_string(const S& fmt) : _str(fmt), _checked(true) {
+        detail::check_format_string(_str, std::array<detail::arg_info, sizeof...(Args)>{
+                                              detail::describe_arg<Args>()...});
+    }
+
+    basic_format_string(runtime_format_string fmt) noexcept
+        : _str(fmt.str), _checked(false) {}
+
+    [[nodiscard]] constexpr std::string_view get() const noexcept { return _str; }
+
+    // True when the string was validated at compile time.
+    [[nodiscard]] constexpr bool is_checked() const noexcept { return _checked; }
+
+private:
+    std::string_view _str;
+    bool _checked;
+};
+
+template <typename... Args>
+using format_string = basic_format_string<std::type_identity_t<Args>...>;
+
+// Type-erased reference to one formatting argument. Built-in types are held
+// by value in a tagged union so that a single, non-template formatting engine
+// can handle every call; any other type is held as a pointer to the value plus
+// the function that formats it.
+class format_arg {
+public:
+    enum class type : std::uint8_t {
+        none,
+        int64,
+        uint64,
+        float32,
+        float64,
+        string,
+        boolean,
+        character,
+        pointer,
+        custom,
+    };
+
+    // Formats a value of a type the engine does not know about through its
+    // fl::formatter, given the text of the specification.
+    struct handle {
+        const void* value;
+        void (*format)(sinks::output_sink& sink, const void* value, std::string_view spec);
+    };
+
+    constexpr format_arg() noexcept : _type(type::none), _int64(0) {}
+    constexpr explicit format_arg(std::int64_t value) noexcept : _type(type::int64), _int64(value) {}
+    constexpr explicit format_arg(std::uint64_t value) noexcept : _type(type::uint64), _uint64(value) {}
+    constexpr explicit format_arg(float value) noexcept : _type(type::float32), _float32(value) {}
+    constexpr explicit format_arg(double value) noexcept : _type(type::float64), _float64(value) {}
+    constexpr explicit format_arg(std::string_view value) noexcept : _type(type::string), _string(value) {}
+    constexpr explicit format_arg(bool value) noexcept : _type(type::boolean), _bool(value) {}
+    constexpr explicit format_arg(char value) noexcept : _type(type::character), _char(value) {}
+    constexpr explicit format_arg(const void* value) noexcept : _type(type::pointer), _pointer(value) {}
+    constexpr explicit format_arg(handle value) noexcept : _type(type::custom), _custom(value) {}
+
+    [[nodiscard]] constexpr type kind() const noexcept { return _type; }
+    [[nodiscard]] constexpr explicit operator bool() const noexcept { return _type != type::none; }
+
+    [[nodiscard]] constexpr std::int64_t int64_value() const noexcept { return _int64; }
+    [[nodiscard]] constexpr std::uint64_t uint64_value() const noexcept { return _uint64; }
+    [[nodiscard]] constexpr float float32_value() const noexcept { return _float32; }
+    [[nodiscard]] constexpr double float64_value() const noexcept { return _float64; }
+    [[nodiscard]] constexpr std::string_view string_value() const noexcept { return _string; }
+    [[nodiscard]] constexpr bool bool_value() const noexcept { return _bool; }
+    [[nodiscard]] constexpr char char_value() const noexcept { return _char; }
+    [[nodiscard]] constexpr const void* pointer_value() const noexcept { return _pointer; }
+    [[nodiscard]] constexpr handle custom_value() const noexcept { return _custom; }
+
+private:
+    type _type;
+    union {
+        std::int64_t _int64;
+        std::uint64_t _uint64;
+        float _float32;
+        double _float64;
+        std::string_view _string;
+        bool _bool;
+        char _char;
+        const void* _pointer;
+        handle _custom;
+    };
+};
+
+namespace detail {
+
+template <typename U>
+void format_custom_erased(sinks::output_sink& sink, const void* value, std::string_view spec) {
+    format_custom(sink, *static_cast<const U*>(value), spec);
+}
+
+// Converts an argument to its erased form. Integers widen to 64 bits and
+// strings of every supported kind become views, so the engine sees one
+// representation per category.
+template <typename T>
+format_arg make_format_arg(const T& value) noexcept {
+    using U = std::decay_t<T>;
+    if constexpr (is_named_arg_v<U>) {
+        return make_format_arg(value.value);
+    } else if constexpr (std::is_same_v<U, bool>) {
+        return format_arg(value);
+    } else if constexpr (std::is_same_v<U, char>) {
+        return format_arg(value);
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        return format_arg(static_cast<std::int64_t>(value));
+    } else if constexpr (std::is_integral_v<U>) {
+        return format_arg(static_cast<std::uint64_t>(value));
+    } else if constexpr (std::is_same_v<U, float>) {
+        // Kept apart from double so the shortest form is the float's own.
+        return format_arg(value);
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return format_arg(static_cast<double>(value));
+    } else if constexpr (is_string_like_v<U>) {
+        return format_arg(as_string_view(value));
+    } else if constexpr (is_pointer_arg_v<U>) {
+        return format_arg(static_cast<const void*>(value));
+    } else if constexpr (has_formatter_v<U>) {
+        return format_arg(format_arg::handle{&value, &format_custom_erased<U>});
+    } else if constexpr (std::is_enum_v<U>) {
+        return make_format_arg(static_cast<std::underlying_type_t<U>>(value));
+    } else {
+        static_assert(dependent_false_v<T>, "Unsupported type for formatting");
+    }
+}
+
+}  // namespace detail
+
+// Owns the erased arguments of one formatting call. Lives on the caller's
+// stack for the duration of the call; the arguments it refers to must too.
+//
+// Named arguments are followed by a name-to-index table stored as pairs of
+// erased values (the name, then the index) after the N arguments, so that
+// format_args stays two words and is passed in registers.
+template <std::size_t N, std::size_t Named = 0>
+struct format_arg_store {
+    std::array<format_arg, N + 2 * Named> args;
+};
+
+template <typename... Args>
+auto make_format_args(const Args&... args) noexcept {
+    constexpr std::size_t named_count = (std::size_t{0} + ... + (detail::is_named_arg_v<Args> ? 1 : 0));
+    format_arg_store<sizeof...(Args), named_count> store{{detail::make_format_arg(args)...}};
+    if constexpr (named_count > 0) {
+        std::size_t index = 0;
+        std::size_t slot = sizeof...(Args);
+        auto add = [&](const auto& arg) {
+            if constexpr (detail::is_named_arg_v<decltype(arg)>) {
+                store.args[slot++] = format_arg(detail::arg_name(arg));
+                store.args[slot++] = format_arg(static_cast<std::uint64_t>(index));
+            }
+            ++index;
+        };
+        (add(args), ...);
+    }
+    return store;
+}
+
+// Non-owning view of a format_arg_store, passed by value to vformat_to().
+class format_args {
+public:
+    constexpr format_args() noexcept : _args(nullptr), _size(0), _named_size(0) {}
+
+    template <std::size_t N, std::size_t Named>
+    constexpr format_args(const format_arg_store<N, Named>& store) noexcept
+        : _args(store.args.data()), _size(static_cast<std::uint32_t>(N)),
+          _named_size(static_cast<std::uint32_t>(Named)) {}
+
+    // Returns an empty (none) argument when index is out of range.
+    [[nodiscard]] constexpr format_arg get(std::size_t index) const noexcept {
+        return index < _size ? _args[index] : format_arg();
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept { return _size; }
+
+    // Returns the index of the argument named name, or detail::no_arg.
+    [[nodiscard]] constexpr std::size_t find(std::string_view name) const noexcept {
+        const format_arg* table = _args + _size;
+        for (std::size_t i = 0; i < _named_size; ++i) {
+            if (table[2 * i].string_value() == name) {
+                return static_cast<std::size_t>(table[2 * i + 1].uint64_value());
+            }
+        }
+        return detail::no_arg;
+    }
+
+private:
+    const format_arg* _args;
+    std::uint32_t _size;
+    std::uint32_t _named_size;
+};
+
+// A format string carried in the type. format_to() parses it once at compile
+// time into a constant segment table and expands the table into straight-line
+// code: one write per literal run and one typed formatter call per
+// placeholder, with each specifier folded in as a constant. Created with the
+// _fmt literal.
+template <fixed_string S>
+struct static_format_string {
+    static constexpr std::string_view view() noexcept { return S.view(); }
+};
+
+inline namespace literals {
+
+// "{} of {}"_fmt yields an fl::static_format_string.
+template <fixed_string S>
+constexpr static_format_string<S> operator""_fmt() noexcept {
+    return {};
+}
+
+}  // namespace literals
+
+namespace detail {
+
+// Writes a number laid out as sign, base prefix and digits, padded to the
+// spec's width. Numeric alignment ('=', or a '0' fill) pads between the prefix
+// and the digits; the other alignments pad around the whole field.
+template <typename Sink>
+void write_numeric_field(Sink& sink, char sign_char, const char* prefix, std::size_t prefix_len,
+                         const char* digits, std::size_t digit_len, const format_spec& spec) {
+    const std::size_t sign_len = sign_char != '\0' ? 1 : 0;
+    const std::size_t total_content = sign_len + prefix_len + digit_len;
 
     if (total_content < spec.width) {
         std::size_t padding = spec.width - total_content;
         char fill_char = spec.fill ? spec.fill : ' ';
 
         if (spec.align == '<') {
-            if (sign_len) sink.write(&sign_char, 1);
+            if (sign_len) put_char(sink, sign_char);
             if (prefix_len) sink.write(prefix, prefix_len);
             sink.write(digits, digit_len);
-            for (std::size_t i = 0; i < padding; ++i) {
-                sink.write(&fill_char, 1);
-            }
+            write_fill(sink, fill_char, padding);
         } else if (spec.align == '^') {
             // Center align: bias extra padding to the left.
             std::size_t left_pad = (padding + 1) / 2;
             std::size_t right_pad = padding - left_pad;
-            for (std::size_t i = 0; i < left_pad; ++i) sink.write(&fill_char, 1);
-            if (sign_len) sink.write(&sign_char, 1);
+            write_fill(sink, fill_char, left_pad);
+            if (sign_len) put_char(sink, sign_char);
             if (prefix_len) sink.write(prefix, prefix_len);
             sink.write(digits, digit_len);
-            for (std::size_t i = 0; i < right_pad; ++i) sink.write(&fill_char, 1);
+            write_fill(sink, fill_char, right_pad);
         } else if (spec.align == '=' || (spec.fill == '0' && spec.align == '>') || (spec.align == '\0' && spec.fill != ' ' && spec.fill != '\0')) {
             // Numeric padding: sign/prefix, then padding, then digits.
-            if (sign_len) sink.write(&sign_char, 1);
+            if (sign_len) put_char(sink, sign_char);
             if (prefix_len) sink.write(prefix, prefix_len);
-            for (std::size_t i = 0; i < padding; ++i) {
-                sink.write(&fill_char, 1);
-            }
+            write_fill(sink, fill_char, padding);
             sink.write(digits, digit_len);
         } else {
             // Default: right align.
-            for (std::size_t i = 0; i < padding; ++i) {
-                sink.write(&fill_char, 1);
-            }
-            if (sign_len) sink.write(&sign_char, 1);
+            write_fill(sink, fill_char, padding);
+            if (sign_len) put_char(sink, sign_char);
             if (prefix_len) sink.write(prefix, prefix_len);
             sink.write(digits, digit_len);
         }
     } else {
-        if (sign_len) sink.write(&sign_char, 1);
+        if (sign_len) put_char(sink, sign_char);
         if (prefix_len) sink.write(prefix, prefix_len);
         sink.write(digits, digit_len);
     }
 }
 
-// Formats a floating-point value according to the given format_spec,
-// handling precision, format character (e, f, g), alignment, and padding.
-template <typename Sink>
-void format_float_with_spec(Sink& sink, double value, const format_spec& spec) {
-    char temp[256];
-    std::size_t len = 0;
-
-    char fmt_char = spec.type ? spec.type : 'g';
-    [[maybe_unused]] const char* fmt_str = nullptr;
-    char fmt_buffer[16];
-
-    switch (fmt_char) {
-        case 'e':
-        case 'E':
-            std::snprintf(fmt_buffer, sizeof(fmt_buffer), "%%%zu%c", spec.precision, fmt_char);
+// Formats an integer value according to the given format_spec, handling base
+// conversion, sign, prefix, alignment, and padding. Takes the argument's own
+// type so unsigned values above INT64_MAX keep their magnitude.
+template <typename Sink, typename T>
+void format_int_with_spec(Sink& sink, T value, const format_spec& spec) {
+    static_assert(std::is_integral_v<T>);
+    bool is_negative = false;
+    uint64_t abs_value = static_cast<uint64_t>(value);
+    if constexpr (std::is_signed_v<T>) {
+        is_negative = value < 0;
+        if (is_negative) {
+            abs_value = 0 - abs_value;
+        }
+    }
+
+    const char* prefix = "";
+    std::size_t prefix_len = 0;
+    char digits[integer_formatter::max_chars];
+    char* digits_end = digits;
+
+    switch (spec.type) {
+        case 'x':
+        case 'X':
+            if (spec.show_base && abs_value != 0) { prefix = spec.type == 'x' ? "0x" : "0X"; prefix_len = 2; }
+            digits_end = integer_formatter::write_pow2(digits, abs_value, 4, spec.type == 'X');
             break;
-        case 'f':
-        case 'F':
-            std::snprintf(fmt_buffer, sizeof(fmt_buffer), "%%.%zuf", spec.precision);
+        case 'b':
+        case 'B':
+            if (spec.show_base && abs_value != 0) { prefix = "0b"; prefix_len = 2; }
+            digits_end = integer_formatter::write_pow2(digits, abs_value, 1);
             break;
-        case 'g':
-        case 'G':
-            std::snprintf(fmt_buffer, sizeof(fmt_buffer), "%%.%zu%c", spec.precision, fmt_char);
+        case 'o':
+            if (spec.show_base && abs_value != 0) { prefix = "0"; prefix_len = 1; }
+            digits_end = integer_formatter::write_pow2(digits, abs_value, 3);
             break;
         default:
-            std::snprintf(fmt_buffer, sizeof(fmt_buffer), "%%g");
+            digits_end = integer_formatter::write_decimal(digits, abs_value);
             break;
     }
+    const std::size_t digit_len = static_cast<std::size_t>(digits_end - digits);
 
-    len = std::snprintf(temp, sizeof(temp), fmt_buffer, value);
-    if (len >= sizeof(temp)) len = sizeof(temp) - 1;
+    char sign_char = '\0';
+    if (is_negative) {
+        sign_char = '-';
+    } else if (spec.sign) {
+        sign_char = '+';
+    }
+    write_numeric_field(sink, sign_char, prefix, prefix_len, digits, digit_len, spec);
+}
 
-    if (len < spec.width) {
-        std::size_t padding = spec.width - len;
-        char fill_char = spec.fill ? spec.fill : ' ';
+// Formats a floating-point value according to the given format_spec. With
+// neither a type nor a precision the value prints in its shortest round-trip
+// form; a bare precision means significant digits, as with 'g'. The sign is
+// kept apart from the digits so '+' and numeric padding work as for integers.
+template <typename Sink, typename Float>
+void format_float_with_spec(Sink& sink, Float value, const format_spec& spec) {
+    char sign_char = '\0';
+    if (std::signbit(value)) {
+        sign_char = '-';
+        value = -value;
+    } else if (spec.sign) {
+        sign_char = '+';
+    }
 
-        if (spec.align == '<') {
-            sink.write(temp, len);
-            for (std::size_t i = 0; i < padding; ++i) {
-                sink.write(&fill_char, 1);
-            }
-        } else if (spec.align == '^') {
-            // Center align: bias extra padding to the left.
-            std::size_t left_pad = (padding + 1) / 2;
-            std::size_t right_pad = padding - left_pad;
-            for (std::size_t i = 0; i < left_pad; ++i) {
-                sink.write(&fill_char, 1);
-            }
-            sink.write(temp, len);
-            for (std::size_t i = 0; i < right_pad; ++i) {
-                sink.write(&fill_char, 1);
+    if (spec.type == '\0' && !spec.precision_set) {
+        char digits[float_formatter::max_shortest_chars];
+        const std::size_t len = float_formatter::format_shortest(digits, value);
+        write_numeric_field(sink, sign_char, "", 0, digits, len, spec);
+        return;
+    }
+
+    // Precisions beyond what a double can carry only add zeros; the cap keeps
+    // the digit count within int range.
+    const int precision = static_cast<int>(std::min<std::size_t>(spec.precision, 1u << 20));
+    const bool upper = spec.type == 'F' || spec.type == 'E' || spec.type == 'G';
+    const double wide = value;
+    auto write_digits = [&](char* out, std::size_t capacity) {
+        switch (spec.type) {
+            case 'f':
+            case 'F':
+                return float_formatter::format_fixed(out, capacity, wide, precision, upper);
+            case 'e':
+            case 'E':
+                return float_formatter::format_scientific(out, capacity, wide, precision, upper);
+            default:
+                return float_formatter::format_general(out, capacity, wide, precision, upper);
+        }
+    };
+
+    char digits[128];
+    std::size_t len = write_digits(digits, sizeof(digits));
+    if (len <= sizeof(digits)) {
+        write_numeric_field(sink, sign_char, "", 0, digits, len, spec);
+        return;
+    }
+    std::string large(len, '\0');
+    len = write_digits(large.data(), large.size());
+    write_numeric_field(sink, sign_char, "", 0, large.data(), len, spec);
+}
+
+// Writes len characters produced by emit() with the spec's fill and
+// alignment around them; default_align applies when the spec gives none.
+template <typename Sink, typename Emit>
+void write_padded(Sink& sink, std::size_t len, const format_spec& spec, Emit&& emit, char default_align = '<') {
+    if (len >= spec.width) {
+        emit();
+        return;
+    }
+    const char fill_char = spec.fill ? spec.fill : ' ';
+    const std::size_t padding = spec.width - len;
+    const char align = spec.align ? spec.align : default_align;
+    std::size_t left = 0;
+    if (align == '>') {
+        left = padding;
+    } else if (align == '^') {
+        // Center align: bias extra padding to the left.
+        left = (padding + 1) / 2;
+    }
+    write_fill(sink, fill_char, left);
+    emit();
+    write_fill(sink, fill_char, padding - left);
+}
+
+// Writes text with width, alignment and, for strings, precision truncation.
+// The length is known up front, so no intermediate buffer is needed. The 'j'
+// type escapes the text for a JSON string; precision then counts input
+// characters and width the escaped output.
+template <typename Sink>
+void format_text_with_spec(Sink& sink, std::string_view text, const format_spec& spec, char default_align = '<') {
+    std::size_t len = text.size();
+    if (spec.precision_set && spec.precision < len) {
+        len = spec.precision;
+    }
+    if (spec.type == 'j') {
+        text = text.substr(0, len);
+        if (spec.width == 0) {
+            json_escape(sink, text);
+            return;
+        }
+        write_padded(sink, json_escaped_size(text), spec, [&] { json_escape(sink, text); }, default_align);
+        return;
+    }
+    write_padded(sink, len, spec, [&] { sink.write(text.data(), len); }, default_align);
+}
+
+// Formats one argument, applying the specification when one is present.
+template <typename Sink, typename T>
+void format_one(Sink& sink, const T& value, const format_spec* spec) {
+    using U = std::decay_t<T>;
+    if (!spec) {
+        format_value(sink, value);
+        return;
+    }
+
+    if constexpr (std::is_same_v<U, char> || std::is_same_v<U, bool>) {
+        // Characters and booleans print as text unless an integer
+        // presentation type asks for their numeric value. A char's value is
+        // signed or not as char is, like std::format.
+        if constexpr (std::is_same_v<U, char>) {
+            if (spec->type == '\0' || spec->type == 'c') {
+                format_text_with_spec(sink, std::string_view(&value, 1), *spec);
+            } else {
+                format_int_with_spec(sink, static_cast<int>(value), *spec);
             }
         } else {
-            // Default: right align.
-            for (std::size_t i = 0; i < padding; ++i) {
-                sink.write(&fill_char, 1);
+            if (spec->type == '\0' || spec->type == 's') {
+                format_text_with_spec(sink, value ? std::string_view("true") : std::string_view("false"), *spec);
+            } else {
+                format_int_with_spec(sink, static_cast<unsigned char>(value), *spec);
             }
-            sink.write(temp, len);
         }
+    } else if constexpr (std::is_integral_v<U>) {
+        format_int_with_spec(sink, value, *spec);
+    } else if constexpr (std::is_floating_point_v<U>) {
+        if constexpr (std::is_same_v<U, float>) {
+            format_float_with_spec(sink, value, *spec);
+        } else {
+            format_float_with_spec(sink, static_cast<double>(value), *spec);
+        }
+    } else if constexpr (is_string_like_v<U>) {
+        format_text_with_spec(sink, as_string_view(value), *spec);
+    } else if constexpr (is_pointer_arg_v<U>) {
+        char temp[max_pointer_chars];
+        char* end = temp + sizeof(temp);
+        const char* p = write_pointer_backwards(end, static_cast<const void*>(value));
+        format_text_with_spec(sink, std::string_view(p, static_cast<std::size_t>(end - p)), *spec, '>');
+    } else if constexpr (std::is_enum_v<U>) {
+        format_one(sink, static_cast<std::underlying_type_t<U>>(value), spec);
     } else {
-        sink.write(temp, len);
+        static_assert(dependent_false_v<T>, "Unsupported type for formatting");
     }
 }
 
-// Parses the format string, matches each "{}" or "{:spec}" placeholder to the
-// corresponding argument, and writes the formatted output to the sink.
-    template <typename Sink, typename... Args>
-    void format_impl(Sink& sink, const char* fmt, Args&&... args) {
-        int arg_index = 0;
+// Presents any character_sink as an output_sink, for the formatters of
+// custom types, which are compiled once against the polymorphic interface.
+template <typename Sink>
+class output_sink_ref final : public sinks::output_sink {
+public:
+    explicit output_sink_ref(Sink& sink) noexcept : _sink(sink) {}
 
-        using formatter_t = std::function<void(Sink&, const format_spec*)>;
-        const std::array<formatter_t, sizeof...(Args)> formatters{
-            [&args](Sink& s, const format_spec* spec) {
-                if (!spec) {
-                    format_value(s, args);
-                    return;
-                }
+    void write(const char* data, std::size_t len) override { _sink.write(data, len); }
 
-                if constexpr (std::is_integral_v<std::decay_t<decltype(args)>>) {
-                    if constexpr (std::is_signed_v<std::decay_t<decltype(args)>>) {
-                        format_int_with_spec(s, static_cast<int64_t>(args), *spec);
-                    } else {
-                        // Cast unsigned to signed for consistent handling.
-                        format_int_with_spec(s, static_cast<int64_t>(args), *spec);
-                    }
-                    return;
-                }
+    // Lends the wrapped sink's storage when it has any.
+    std::span<char> prepare(std::size_t len) override {
+        if constexpr (sinks::direct_sink<Sink>) {
+            return _sink.prepare(len);
+        } else {
+            (void)len;
+            return {};
+        }
+    }
 
-                if constexpr (std::is_floating_point_v<std::decay_t<decltype(args)>>) {
-                    format_float_with_spec(s, static_cast<double>(args), *spec);
-                    return;
-                }
+    void commit(std::size_t len) override {
+        if constexpr (sinks::direct_sink<Sink>) {
+            _sink.commit(len);
+        } else {
+            (void)len;
+        }
+    }
 
-                // Other types: format into a temporary string, then apply
-                // alignment and width.
-                {
-                    growing_sink gs;
-                    format_value(gs, args);
-                    const std::string& tmp = gs.buffer();
-                    std::size_t len = tmp.size();
-
-                    // Apply precision truncation for strings when provided.
-                    std::size_t effective_len = len;
-                    if (spec->precision_set && spec->precision < effective_len) {
-                        effective_len = spec->precision;
-                    }
-
-                    std::size_t width = spec->width;
-                    char fill_char = spec->fill ? spec->fill : ' ';
-
-                    if (effective_len < width) {
-                        std::size_t padding = width - effective_len;
-                        if (spec->align == '<') {
-                            s.write(tmp.data(), effective_len);
-                            for (std::size_t i = 0; i < padding; ++i) s.write(&fill_char, 1);
-                        } else if (spec->align == '^') {
-                            // Center align: bias extra padding to the left.
-                            std::size_t left = (padding + 1) / 2;
-                            std::size_t right = padding - left;
-                            for (std::size_t i = 0; i < left; ++i) s.write(&fill_char, 1);
-                            s.write(tmp.data(), effective_len);
-                            for (std::size_t i = 0; i < right; ++i) s.write(&fill_char, 1);
-                        } else {
-                            // Right align (default).
-                            for (std::size_t i = 0; i < padding; ++i) s.write(&fill_char, 1);
-                            s.write(tmp.data(), effective_len);
-                        }
-                    } else {
-                        s.write(tmp.data(), effective_len);
-                    }
-                }
-            }...
-        };
+private:
+    Sink& _sink;
+};
 
-        while (*fmt) {
-            if (*fmt == '{') {
-                if (*(fmt + 1) == '{') {
-                    sink.write("{", 1);
-                    fmt += 2;
-                    continue;
-                }
+// Formats a value through its fl::formatter specialisation. The formatter is
+// handed the sink itself when its format() accepts that type, and an
+// output_sink view of it otherwise.
+template <typename Sink, typename T>
+void format_custom(Sink& sink, const T& value, std::string_view spec) {
+    fl::formatter<T> f;
+    const char* last = spec.data() + spec.size();
+    if (f.parse(spec.data(), last) != last) {
+        throw_format_error("invalid format specifier");
+    }
+    if constexpr (requires { f.format(value, sink); }) {
+        f.format(value, sink);
+    } else {
+        output_sink_ref<Sink> ref(sink);
+        f.format(value, ref);
+    }
+}
 
-                const char* start = fmt + 1;
-                const char* end = start;
-                while (*end && *end != '}') ++end;
-                if (*end == '}') {
-                    if (start == end) {
-                        if (arg_index < static_cast<int>(formatters.size())) {
-                            formatters[arg_index++](sink, nullptr);
-                        }
-                    } else {
-                        if (*start == ':' && arg_index < static_cast<int>(formatters.size())) {
-                            format_spec spec;
-                            const char* to_parse = start + 1;
-                            std::size_t consumed = format_spec::parse(to_parse, spec);
-                            const char* after = to_parse + consumed;
-                            if (after == end) {
-                                formatters[arg_index++](sink, &spec);
-                            } else {
-                                sink.write("{", 1);
-                            }
-                        } else {
-                            sink.write("{", 1);
-                        }
-                    }
-                    fmt = end + 1;
-                    continue;
-                } else {
-                    sink.write("{", 1);
-                    ++fmt;
-                    continue;
-                }
+// Maps an erased argument to the kind used for specifier validation.
+constexpr arg_kind erased_arg_kind(format_arg::type type) noexcept {
+    switch (type) {
+        case format_arg::type::float32:
+        case format_arg::type::float64:
+            return arg_kind::floating_point;
+        case format_arg::type::string:
+            return arg_kind::string;
+        case format_arg::type::pointer:
+            return arg_kind::pointer;
+        case format_arg::type::character:
+            return arg_kind::character;
+        case format_arg::type::boolean:
+            return arg_kind::boolean;
+        default:
+            return arg_kind::integer;
+    }
+}
+
+// Formats one erased argument by switching on its tag and calling the typed
+// formatter, so each formatter is instantiated once per sink type rather than
+// once per argument pack.
+template <typename Sink>
+void format_erased_arg(Sink& sink, const format_arg& arg, std::string_view fmt, const format_segment& seg) {
+    const format_spec* spec = seg.has_spec ? &seg.spec : nullptr;
+    if (spec && arg.kind() != format_arg::type::custom && arg.kind() != format_arg::type::none) {
+        if (!seg.spec_valid) {
+            throw_format_error("invalid format specifier");
+        }
+        check_format_spec(erased_arg_kind(arg.kind()), *spec);
+    }
+    switch (arg.kind()) {
+        case format_arg::type::int64:
+            format_one(sink, arg.int64_value(), spec);
+            break;
+        case format_arg::type::uint64:
+            format_one(sink, arg.uint64_value(), spec);
+            break;
+        case format_arg::type::float32:
+            format_one(sink, arg.float32_value(), spec);
+            break;
+        case format_arg::type::float64:
+            format_one(sink, arg.float64_value(), spec);
+            break;
+        case format_arg::type::string:
+            format_one(sink, arg.string_value(), spec);
+            break;
+        case format_arg::type::boolean:
+            format_one(sink, arg.bool_value(), spec);
+            break;
+        case format_arg::type::character:
+            format_one(sink, arg.char_value(), spec);
+            break;
+        case format_arg::type::pointer:
+            format_one(sink, arg.pointer_value(), spec);
+            break;
+        case format_arg::type::custom: {
+            const format_arg::handle h = arg.custom_value();
+            const std::string_view spec_text = fmt.substr(seg.spec_offset, seg.spec_size);
+            if constexpr (std::is_base_of_v<sinks::output_sink, Sink>) {
+                h.format(sink, h.value, spec_text);
+            } else {
+                output_sink_ref<Sink> ref(sink);
+                h.format(ref, h.value, spec_text);
             }
+            break;
+        }
+        case format_arg::type::none:
+            throw_format_error("argument index out of range");
+    }
+}
+
+// Appends to a string_builder whose capacity the caller has already reserved,
+// so every write lands in the existing block.
+class string_builder_sink final : public sinks::output_sink {
+public:
+    explicit string_builder_sink(string_builder& builder) noexcept : _builder(builder) {}
+
+    void write(const char* data, std::size_t len) override { _builder.append(data, len); }
+    void put(char ch) { _builder.append(ch); }
+    void reserve(std::size_t len) override { _builder.reserve(_builder.size() + len); }
+    std::span<char> prepare(std::size_t len) noexcept override { return _builder.prepare(len); }
+    void commit(std::size_t len) noexcept override { _builder.commit(len); }
 
-            if (*fmt == '}') {
-                if (*(fmt + 1) == '}') {
-                    sink.write("}", 1);
-                    fmt += 2;
-                    continue;
+private:
+    string_builder& _builder;
+};
+
+// Writes up to a fixed capacity and silently drops the rest, while counting
+// everything it is given.
+class truncating_sink final : public sinks::output_sink {
+public:
+    truncating_sink(char* buffer, std::size_t capacity) noexcept
+        : _buffer(buffer), _capacity(capacity), _size(0) {}
+
+    void write(const char* data, std::size_t len) override {
+        if (_size < _capacity) {
+            std::memcpy(_buffer + _size, data, std::min(len, _capacity - _size));
+        }
+        _size += len;
+    }
+
+    void put(char ch) noexcept {
+        if (_size < _capacity) {
+            _buffer[_size] = ch;
+        }
+        ++_size;
+    }
+
+    // Storage is lent only while the output still fits; past that point the
+    // sink just counts.
+    std::span<char> prepare(std::size_t len) noexcept override {
+        if (_size > _capacity || len > _capacity - _size) {
+            return {};
+        }
+        return {_buffer + _size, _capacity - _size};
+    }
+
+    void commit(std::size_t len) noexcept override { _size += len; }
+
+    char* end() const noexcept { return _buffer + std::min(_size, _capacity); }
+    std::size_t size() const noexcept { return _size; }
+
+private:
+    char* _buffer;
+    std::size_t _capacity;
+    std::size_t _size;
+};
+
+// Emits one segment of a static_format_string. Everything about the segment is
+// a constant, so the literal write and the argument's formatter are selected
+// at compile time and the specifier is folded into the formatter.
+template <auto Str, format_segment Seg, typename Sink, typename... Args>
+void format_static_segment(Sink& sink, const Args&... args) {
+    if constexpr (Seg.literal_size != 0) {
+        sink.write(Str.data + Seg.literal_offset, Seg.literal_size);
+    }
+    if constexpr (Seg.arg_index == deferred_arg) {
+        // {name} may match an fl::arg("name", v): compare against the
+        // runtime names and format the match through the checked erased path.
+        const std::string_view name(Str.data + Seg.name_offset, Seg.name_size);
+        bool found = false;
+        auto try_arg = [&](const auto& arg) {
+            if constexpr (named_arg_traits<std::decay_t<decltype(arg)>>::is_runtime) {
+                if (!found && arg.name == name) {
+                    found = true;
+                    format_erased_arg(sink, make_format_arg(arg.value), Str.view(), Seg);
                 }
-                sink.write("}", 1);
-                ++fmt;
-                continue;
             }
+        };
+        (try_arg(args), ...);
+        if (!found) {
+            throw_format_error("argument name not found");
+        }
+    } else if constexpr (Seg.arg_index != no_arg) {
+        const auto& value = unwrap_arg(std::get<Seg.arg_index>(std::tie(args...)));
+        using U = std::decay_t<decltype(value)>;
+        if constexpr (classify_arg<U>() == arg_kind::custom) {
+            format_custom(sink, value, std::string_view(Str.data + Seg.spec_offset, Seg.spec_size));
+        } else if constexpr (Seg.has_spec) {
+            format_one(sink, value, &Seg.spec);
+        } else {
+            format_value(sink, value);
+        }
+    }
+}
 
-            sink.write(fmt, 1);
-            ++fmt;
+// Short output is formatted once into this much stack space while it is
+// measured; only longer output is formatted a second time, straight into its
+// exact-size destination.
+inline constexpr std::size_t format_probe_size = 256;
+
+// Runs emit(sink) and returns its output as an fl::string with one allocation
+// of exactly the right size (none when the result fits in SSO).
+template <typename Emit>
+fl::string format_to_new_string(Emit&& emit) {
+    char probe_buffer[format_probe_size];
+    truncating_sink probe(probe_buffer, sizeof(probe_buffer));
+    emit(probe);
+    if (probe.size() <= sizeof(probe_buffer)) {
+        return fl::string(probe_buffer, probe.size());
+    }
+    fl::string result(probe.size(), '\0');
+    sinks::buffer_sink sink(result.data(), result.size());
+    emit(sink);
+    return result;
+}
+
+// Runs emit(sink) and appends its output to an fl::string or string_builder.
+template <typename Out, typename Emit>
+void append_formatted(Out& out, Emit&& emit) {
+    char probe_buffer[format_probe_size];
+    truncating_sink probe(probe_buffer, sizeof(probe_buffer));
+    emit(probe);
+    if (probe.size() <= sizeof(probe_buffer)) {
+        out.append(probe_buffer, probe.size());
+        return;
+    }
+    if constexpr (std::is_same_v<Out, string_builder>) {
+        out.reserve(out.size() + probe.size());
+        string_builder_sink sink(out);
+        emit(sink);
+    } else {
+        const std::size_t old_size = out.size();
+        out.append(probe.size(), '\0');
+        sinks::buffer_sink sink(out.data() + old_size, probe.size());
+        emit(sink);
+    }
+}
+
+// Expands a static_format_string into the given sink.
+template <auto Str, typename Sink, typename... Args>
+void format_static_to(Sink& sink, const Args&... args) {
+    using table = static_format_table<Str, Args...>;
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (format_static_segment<Str, table::segments[I]>(sink, args...), ...);
+    }(std::make_index_sequence<table::count>{});
+}
+
+// Scans a runtime format string and formats the erased arguments into any
+// character sink. Literal text between placeholders goes out as one write.
+template <typename Sink>
+void vformat_impl(Sink& sink, std::string_view fmt, format_args args) {
+    reserve_hint(sink, fmt.size());
+    std::size_t pos = 0;
+    std::size_t next_arg = 0;
+    while (pos < fmt.size()) {
+        format_segment seg;
+        pos = scan_segment(fmt, pos, next_arg, args.size(), seg,
+                           [&](std::string_view name) { return args.find(name); });
+        if (seg.literal_size) {
+            sink.write(fmt.data() + seg.literal_offset, seg.literal_size);
+        }
+        if (seg.arg_index != no_arg) {
+            format_erased_arg(sink, args.get(seg.arg_index), fmt, seg);
         }
     }
+}
 
-}  // namespace detail
+// Argument references in a compiled_format are checked against the argument
+// count when it is rendered; format_args never holds more than this many.
+inline constexpr std::size_t max_format_args = std::numeric_limits<std::uint32_t>::max();
 
-// Formats the arguments according to the format string and writes the result
-// to the given buffer sink. Supports format specifications such as {},
-// {:10}, {:>20}, {:*^15}, {:0>10}, etc.
-template <typename... Args>
-void format_to(buffer_sink& sink, const char* fmt, Args&&... args) {
-    detail::format_impl(sink, fmt, std::forward<Args>(args)...);
+// Renders segments parsed ahead of time from fmt. Only the argument lookup
+// and the specifier-against-type check remain per call.
+template <typename Sink>
+void render_segments(Sink& sink, std::string_view fmt, const format_segment* first, const format_segment* last,
+                     std::size_t size_hint, format_args args) {
+    reserve_hint(sink, size_hint);
+    for (; first != last; ++first) {
+        const format_segment& seg = *first;
+        if (seg.literal_size) {
+            sink.write(fmt.data() + seg.literal_offset, seg.literal_size);
+        }
+        if (seg.arg_index == no_arg) {
+            continue;
+        }
+        std::size_t index = seg.arg_index;
+        if (index == deferred_arg) {
+            index = args.find(fmt.substr(seg.name_offset, seg.name_size));
+            if (index == no_arg) {
+                throw_format_error("argument name not found");
+            }
+        } else if (index >= args.size()) {
+            throw_format_error("argument index out of range");
+        }
+        format_erased_arg(sink, args.get(index), fmt, seg);
+    }
 }
 
-// Specialization for a single integer argument. Avoids the overhead of the
-// generic variadic path when only one integral value needs formatting.
+}  // namespace detail
+
+// Formats text with the string specification: fill, alignment, width, and a
+// precision that truncates. The formatters of the other string types derive
+// from it, and so can user formatters that render to a string.
+template <>
+struct formatter<std::string_view> {
+    constexpr const char* parse(const char* first, const char* last) {
+        const char* end = detail::format_spec::parse(first, last, _spec);
+        if (end == last) {
+            detail::check_format_spec(detail::arg_kind::string, _spec);
+        }
+        _has_spec = first != last;
+        return end;
+    }
+
+    template <typename Sink>
+    void format(std::string_view value, Sink& sink) const {
+        if (_has_spec) {
+            detail::format_text_with_spec(sink, value, _spec);
+        } else {
+            sink.write(value.data(), value.size());
+        }
+    }
+
+protected:
+    detail::format_spec _spec{};
+    bool _has_spec = false;
+};
+
+namespace detail {
+
 template <typename T>
-typename std::enable_if<std::is_integral_v<T>>::type
-format_to(buffer_sink& sink, const char* fmt, T value)
-{
-    const char* p = fmt;
-    while (*p) {
-        if (*p == '{') {
-            if (*(p + 1) == '{') {
-                sink.write("{", 1);
-                p += 2;
-                continue;
-            }
+struct contiguous_string_formatter : formatter<std::string_view> {
+    template <typename Sink>
+    void format(const T& value, Sink& sink) const {
+        formatter<std::string_view>::format(as_string_view(value), sink);
+    }
+};
 
-            const char* start = p + 1;
-            const char* end = start;
-            while (*end && *end != '}') ++end;
-            if (*end == '}') {
-                if (start == end) {
-                    char temp[64];
-                    std::size_t len = 0;
-                    if constexpr (std::is_signed_v<T>) {
-                        len = detail::integer_formatter::format_int64(temp, sizeof(temp), static_cast<int64_t>(value));
-                    } else {
-                        len = detail::integer_formatter::format_uint64(temp, sizeof(temp), static_cast<uint64_t>(value));
-                    }
-                    if (len > 0) sink.write(temp, len);
-                } else if (*start == ':') {
-                    detail::format_spec spec;
-                    const char* to_parse = start + 1;
-                    std::size_t consumed = detail::format_spec::parse(to_parse, spec);
-                    const char* after = to_parse + consumed;
-                    if (after == end) {
-                        detail::format_int_with_spec(sink, static_cast<int64_t>(value), spec);
-                    } else {
-                        sink.write("{", 1);
-                    }
+}  // namespace detail
+
+template <> struct formatter<const char*> : detail::contiguous_string_formatter<const char*> {};
+template <> struct formatter<char*> : detail::contiguous_string_formatter<char*> {};
+template <> struct formatter<std::string> : detail::contiguous_string_formatter<std::string> {};
+template <> struct formatter<fl::string> : detail::contiguous_string_formatter<fl::string> {};
+template <> struct formatter<fl::immutable_string> : detail::contiguous_string_formatter<fl::immutable_string> {};
+template <>
+struct formatter<fl::immutable_string_view> : detail::contiguous_string_formatter<fl::immutable_string_view> {};
+template <> struct formatter<fl::substring_view> : detail::contiguous_string_formatter<fl::substring_view> {};
+
+// Formats a rope leaf by leaf, so it is never flattened. Width and precision
+// use the rope's length, which is known without walking it.
+template <>
+struct formatter<fl::rope> : formatter<std::string_view> {
+    template <typename Sink>
+    void format(const fl::rope& value, Sink& sink) const {
+        std::size_t len = value.size();
+        if (_has_spec && _spec.precision_set && _spec.precision < len) {
+            len = _spec.precision;
+        }
+        const bool escape = _has_spec && _spec.type == 'j';
+        // Visits the first len characters, leaf by leaf.
+        auto for_each_chunk = [&](auto&& fn) {
+            std::size_t remaining = len;
+            value.for_each_chunk([&](std::string_view chunk) {
+                const std::size_t n = std::min(chunk.size(), remaining);
+                fn(chunk.substr(0, n));
+                remaining -= n;
+                return remaining != 0;
+            });
+        };
+        auto emit = [&] {
+            for_each_chunk([&](std::string_view chunk) {
+                if (escape) {
+                    json_escape(sink, chunk);
                 } else {
-                    sink.write("{", 1);
+                    sink.write(chunk.data(), chunk.size());
                 }
+            });
+        };
+        if (!_has_spec) {
+            emit();
+            return;
+        }
+        std::size_t output_len = len;
+        if (escape && _spec.width != 0) {
+            output_len = 0;
+            for_each_chunk([&](std::string_view chunk) { output_len += json_escaped_size(chunk); });
+        }
+        detail::write_padded(sink, output_len, _spec, emit);
+    }
+};
 
-                p = end + 1;
-                continue;
-            } else {
-                sink.write("{", 1);
-                ++p;
-                continue;
+// Formats a span of bytes as two hex digits per byte: lower case for {} and
+// {:x}, upper case for {:X}. '#' adds a 0x prefix, a precision limits the
+// number of bytes shown, and fill, alignment and width pad the digits.
+template <std::size_t Extent>
+struct formatter<std::span<const std::byte, Extent>> {
+    constexpr const char* parse(const char* first, const char* last) {
+        const char* end = detail::format_spec::parse(first, last, _spec);
+        if (end == last) {
+            if (_spec.type != '\0' && _spec.type != 'x' && _spec.type != 'X') {
+                detail::throw_format_error("invalid type specifier for byte span argument");
+            }
+            if (_spec.sign || _spec.align == '=') {
+                detail::throw_format_error("sign and '=' alignment not allowed for byte span arguments");
             }
         }
+        return end;
+    }
 
-        if (*p == '}') {
-            if (*(p + 1) == '}') {
-                sink.write("}", 1);
-                p += 2;
-                continue;
+    template <typename Sink>
+    void format(std::span<const std::byte> bytes, Sink& sink) const {
+        if (_spec.precision_set && _spec.precision < bytes.size()) {
+            bytes = bytes.first(_spec.precision);
+        }
+        const bool upper = _spec.type == 'X';
+        auto emit = [&] {
+            if (_spec.show_base) {
+                sink.write(upper ? "0X" : "0x", 2);
             }
-            sink.write("}", 1);
-            ++p;
-            continue;
+            hex_encode(sink, bytes, upper ? hex_case::upper : hex_case::lower);
+        };
+        detail::write_padded(sink, bytes.size() * 2 + (_spec.show_base ? 2 : 0), _spec, emit);
+    }
+
+protected:
+    detail::format_spec _spec{};
+};
+
+template <std::size_t Extent>
+struct formatter<std::span<std::byte, Extent>> : formatter<std::span<const std::byte>> {};
+
+template <std::size_t Extent>
+struct formatter<std::span<const unsigned char, Extent>> : formatter<std::span<const std::byte>> {
+    template <typename Sink>
+    void format(std::span<const unsigned char, Extent> bytes, Sink& sink) const {
+        formatter<std::span<const std::byte>>::format(std::as_bytes(bytes), sink);
+    }
+};
+
+template <std::size_t Extent>
+struct formatter<std::span<unsigned char, Extent>> : formatter<std::span<const unsigned char, Extent>> {};
+
+// Formats the erased arguments according to a runtime format string. This is
+// the non-template entry point for code holding a polymorphic sink: the
+// engine is compiled once against output_sink and call sites only build the
+// argument array. Specifiers are validated against the argument types and
+// errors throw fl::format_error.
+inline void vformat_to(sinks::output_sink& sink, std::string_view fmt, format_args args) {
+    detail::vformat_impl(sink, fmt, args);
+}
+
+// The same engine over a concrete sink. Any type with write(data, len) works;
+// writes to it are direct calls rather than virtual dispatch, and a sink that
+// also models direct_sink receives numbers formatted in place.
+template <sinks::character_sink Sink>
+    requires(!std::is_same_v<Sink, sinks::output_sink>)
+void vformat_to(Sink& sink, std::string_view fmt, format_args args) {
+    detail::vformat_impl(sink, fmt, args);
+}
+
+// A runtime format string parsed once for repeated use, for templates loaded
+// from configuration and rendered many times. Construction scans the string
+// and parses every specifier, throwing fl::format_error on malformed syntax;
+// rendering then writes the literal runs and formats the arguments without
+// rescanning. The text is held as an immutable_string and every literal is a
+// slice of it, so copies share one buffer. Argument indices, names and the
+// suitability of each specifier for its argument are checked per render,
+// since the argument types are not known until then.
+class compiled_format {
+public:
+    compiled_format() = default;
+
+    explicit compiled_format(std::string_view fmt)
+        : compiled_format(fmt.empty() ? immutable_string() : immutable_string(fmt.data(), fmt.size())) {}
+
+    explicit compiled_format(immutable_string fmt) : _source(std::move(fmt)) {
+        const std::string_view text(_source.data(), _source.size());
+        std::size_t pos = 0;
+        std::size_t next_arg = 0;
+        while (pos < text.size()) {
+            detail::format_segment seg;
+            pos = detail::scan_segment(text, pos, next_arg, detail::max_format_args, seg,
+                                       [](std::string_view) { return detail::deferred_arg; });
+            _literal_size += seg.literal_size;
+            _segments.push_back(seg);
         }
+    }
 
-        sink.write(p, 1);
-        ++p;
+    // Renders the erased arguments into any character sink.
+    template <sinks::character_sink Sink>
+    void vformat_to(Sink& sink, format_args args) const {
+        detail::render_segments(sink, source_view(), _segments.data(), _segments.data() + _segments.size(),
+                                _literal_size, args);
     }
+
+    [[nodiscard]] const immutable_string& source() const noexcept { return _source; }
+
+    // Literal text of segment i, a slice of source().
+    [[nodiscard]] immutable_string_view literal(std::size_t i) const noexcept {
+        return immutable_string_view(_source.data() + _segments[i].literal_offset, _segments[i].literal_size);
+    }
+
+    // Number of segments: each is a literal run followed by at most one
+    // placeholder.
+    [[nodiscard]] std::size_t segment_count() const noexcept { return _segments.size(); }
+
+private:
+    std::string_view source_view() const noexcept { return {_source.data(), _source.size()}; }
+
+    immutable_string _source;
+    std::vector<detail::format_segment> _segments;
+    std::size_t _literal_size = 0;
+};
+
+// Formats the arguments according to the format string and writes the result
+// to the given sink, which may be any character_sink: the library's sinks, or
+// a user type with a write(const char*, std::size_t) member. Supports format
+// specifications such as {}, {:10}, {:>20}, {:*^15}, {:0>10}, etc. A literal
+// format string is checked against the argument types at compile time; wrap
+// runtime strings in fl::runtime_format().
+template <sinks::character_sink Sink, typename... Args>
+void format_to(Sink& sink, format_string<Args...> fmt, Args&&... args) {
+    vformat_to(sink, fmt.get(), make_format_args(args...));
+}
+
+// Formats with a static_format_string ("..."_fmt). The call expands to the
+// literal writes and formatter calls of the parsed string with no scanning at
+// runtime.
+template <sinks::character_sink Sink, fixed_string S, typename... Args>
+void format_to(Sink& sink, static_format_string<S>, Args&&... args) {
+    detail::format_static_to<S>(sink, args...);
+}
+
+// Renders a compiled_format; see compiled_format for which checks remain.
+template <sinks::character_sink Sink, typename... Args>
+void format_to(Sink& sink, const compiled_format& fmt, Args&&... args) {
+    fmt.vformat_to(sink, make_format_args(args...));
+}
+
+// Returns the number of characters the arguments format to, without writing
+// them anywhere.
+template <typename... Args>
+[[nodiscard]] std::size_t formatted_size(format_string<Args...> fmt, Args&&... args) {
+    sinks::null_sink counter;
+    vformat_to(counter, fmt.get(), make_format_args(args...));
+    return counter.bytes_written();
+}
+
+template <fixed_string S, typename... Args>
+[[nodiscard]] std::size_t formatted_size(static_format_string<S>, Args&&... args) {
+    sinks::null_sink counter;
+    detail::format_static_to<S>(counter, args...);
+    return counter.bytes_written();
+}
+
+template <typename... Args>
+[[nodiscard]] std::size_t formatted_size(const compiled_format& fmt, Args&&... args) {
+    sinks::null_sink counter;
+    fmt.vformat_to(counter, make_format_args(args...));
+    return counter.bytes_written();
+}
+
+// Formats into a new fl::string. The output is sized first, so the string is
+// filled in its SSO buffer or in a single exact-size heap block.
+template <typename... Args>
+[[nodiscard]] fl::string format(format_string<Args...> fmt, Args&&... args) {
+    const auto store = make_format_args(args...);
+    return detail::format_to_new_string([&](auto& sink) { vformat_to(sink, fmt.get(), store); });
+}
+
+template <fixed_string S, typename... Args>
+[[nodiscard]] fl::string format(static_format_string<S>, Args&&... args) {
+    return detail::format_to_new_string([&](auto& sink) { detail::format_static_to<S>(sink, args...); });
+}
+
+template <typename... Args>
+[[nodiscard]] fl::string format(const compiled_format& fmt, Args&&... args) {
+    const auto store = make_format_args(args...);
+    return detail::format_to_new_string([&](auto& sink) { fmt.vformat_to(sink, store); });
+}
+
+// Appends the formatted output to an fl::string, growing it at most once.
+template <typename... Args>
+void format_to(fl::string& out, format_string<Args...> fmt, Args&&... args) {
+    const auto store = make_format_args(args...);
+    detail::append_formatted(out, [&](auto& sink) { vformat_to(sink, fmt.get(), store); });
+}
+
+// Appends the formatted output to a string_builder, growing it at most once.
+template <typename... Args>
+void format_to(string_builder& out, format_string<Args...> fmt, Args&&... args) {
+    const auto store = make_format_args(args...);
+    detail::append_formatted(out, [&](auto& sink) { vformat_to(sink, fmt.get(), store); });
+}
+
+// Result of format_to_n(): one past the last character written, and the size
+// the full output would have had.
+struct format_to_n_result {
+    char* out;
+    std::size_t size;
+};
+
+// Formats into [out, out + n), truncating rather than overflowing. Compare the
+// returned size with n to detect truncation. No terminator is written.
+template <typename... Args>
+format_to_n_result format_to_n(char* out, std::size_t n, format_string<Args...> fmt, Args&&... args) {
+    detail::truncating_sink sink(out, n);
+    vformat_to(sink, fmt.get(), make_format_args(args...));
+    return {sink.end(), sink.size()};
 }
 
 }  // namespace fl
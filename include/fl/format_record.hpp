@@ -0,0 +1,489 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_FORMAT_RECORD_HPP
+#define FL_FORMAT_RECORD_HPP
+
+// Deferred formatting: capture a call's arguments now, format them later.
+//
+// fl::format_record::capture() serialises the arguments of a format call into
+// a caller-provided buffer as a compact binary record: numbers, enumerations
+// and pointer values as their raw bytes, strings and byte spans as copied
+// bytes, and fl::immutable_string as a reference-counted handle. Other
+// trivially copyable types are copied as raw bytes only if they opt in through
+// fl::enable_deferred_copy, since a copied pointer inside one would outlive
+// what it points to. Nothing is
+// formatted, so the capturing thread pays roughly the cost of a memcpy.
+// render() later decodes the record and runs the ordinary formatting engine,
+// with the same specifiers and number formatters as fl::format_to.
+//
+// The codec in fl::detail is shared with fl::log, which stores records of the
+// same layout in its per-thread rings.
+
+#include "fl/format.hpp"
+#include "fl/immutable_string.hpp"
+#include "fl/rope.hpp"
+#include "fl/sinks.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace fl {
+
+// Opts a trivially copyable type with an fl::formatter into deferred
+// formatting, where it is copied as raw bytes. Only a type that refers to no
+// other object should opt in: the record is rendered after the call returns.
+template <typename T>
+inline constexpr bool enable_deferred_copy = false;
+
+namespace detail {
+
+// Records, and fields within them, are aligned so that any argument can be
+// stored in place.
+inline constexpr std::size_t record_align = 16;
+
+constexpr std::size_t record_align_up(std::size_t n, std::size_t alignment) noexcept {
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+template <typename T>
+struct record_name_traits {
+    static constexpr bool is_static_named = false;
+};
+
+template <fixed_string Name, typename T>
+struct record_name_traits<static_named_arg<Name, T>> {
+    static constexpr bool is_static_named = true;
+    using value_type = T;
+
+    template <typename D>
+    static constexpr auto wrap(const D& value) noexcept {
+        return fl::arg<Name>(value);
+    }
+};
+
+// Text that is copied into the record and read back as a std::string_view.
+template <typename T>
+inline constexpr bool is_record_text_v =
+    (is_string_like_v<T> && !std::is_same_v<T, immutable_string>) || std::is_same_v<T, fl::rope>;
+
+// A span of bytes, copied into the record and read back as a span.
+template <typename T>
+inline constexpr bool is_record_bytes_v = false;
+
+template <typename E, std::size_t Extent>
+    requires(std::is_same_v<std::remove_const_t<E>, std::byte> || std::is_same_v<std::remove_const_t<E>, unsigned char>)
+inline constexpr bool is_record_bytes_v<std::span<E, Extent>> = true;
+
+// Values copied as their raw bytes.
+template <typename T>
+inline constexpr bool is_record_value_v = std::is_arithmetic_v<T> || std::is_enum_v<T> || is_pointer_arg_v<T> ||
+                                          (std::is_trivially_copyable_v<T> && enable_deferred_copy<T>);
+
+// The copied bytes of a text or byte span argument.
+template <typename T>
+std::string_view record_bytes(const T& value) noexcept {
+    if constexpr (is_record_bytes_v<T>) {
+        return std::string_view(reinterpret_cast<const char*>(value.data()), value.size_bytes());
+    } else {
+        return as_string_view(value);
+    }
+}
+
+// The type an argument is decoded as and formatted from.
+template <typename T>
+struct record_decoded {
+    using type = T;
+};
+
+template <typename T>
+    requires(record_name_traits<T>::is_static_named)
+struct record_decoded<T> {
+    using type = typename record_decoded<std::decay_t<typename record_name_traits<T>::value_type>>::type;
+};
+
+template <typename T>
+    requires(is_record_text_v<T>)
+struct record_decoded<T> {
+    using type = std::string_view;
+};
+
+template <typename T>
+    requires(is_record_bytes_v<T>)
+struct record_decoded<T> {
+    using type = std::span<const std::byte>;
+};
+
+template <>
+struct record_decoded<immutable_string> {
+    using type = const immutable_string&;
+};
+
+template <typename T>
+using record_decoded_t = typename record_decoded<std::decay_t<T>>::type;
+
+// The stored type of an argument: named arguments store their value.
+template <typename T>
+struct record_stored {
+    using type = std::decay_t<T>;
+};
+
+template <typename T>
+    requires(record_name_traits<std::decay_t<T>>::is_static_named)
+struct record_stored<T> {
+    using type = std::decay_t<typename record_name_traits<std::decay_t<T>>::value_type>;
+};
+
+template <typename... Args>
+inline constexpr bool record_needs_destroy_v =
+    (std::is_same_v<typename record_stored<Args>::type, immutable_string> || ...);
+
+// record_measure() and record_encode() advance the payload offset identically;
+// record_decode() advances it the same way while reading.
+template <typename T>
+void record_measure(std::size_t& offset, const T& value) noexcept {
+    using U = std::decay_t<T>;
+    if constexpr (record_name_traits<U>::is_static_named) {
+        record_measure(offset, value.value);
+    } else if constexpr (is_named_arg_v<U>) {
+        static_assert(dependent_false_v<U>,
+                      "deferred formatting: name arguments with fl::arg<\"name\">(value) so the name is part of "
+                      "the type");
+    } else if constexpr (std::is_same_v<U, fl::rope>) {
+        offset = record_align_up(offset, alignof(std::uint64_t)) + sizeof(std::uint64_t) + value.size();
+    } else if constexpr (is_record_text_v<U> || is_record_bytes_v<U>) {
+        offset = record_align_up(offset, alignof(std::uint64_t)) + sizeof(std::uint64_t) + record_bytes(value).size();
+    } else {
+        static_assert(std::is_same_v<U, immutable_string> || is_record_value_v<U>,
+                      "deferred formatting: arguments must be numbers, strings, byte spans or fl::immutable_string; "
+                      "specialise fl::enable_deferred_copy for a trivially copyable type that refers to no other "
+                      "object");
+        static_assert(alignof(U) <= record_align, "deferred formatting: over-aligned argument type");
+        offset = record_align_up(offset, alignof(U)) + sizeof(U);
+    }
+}
+
+template <typename T>
+void record_encode(std::byte* payload, std::size_t& offset, const T& value) noexcept {
+    using U = std::decay_t<T>;
+    if constexpr (record_name_traits<U>::is_static_named) {
+        record_encode(payload, offset, value.value);
+    } else if constexpr (is_record_text_v<U> || is_record_bytes_v<U>) {
+        offset = record_align_up(offset, alignof(std::uint64_t));
+        std::byte* length_at = payload + offset;
+        std::byte* text_at = length_at + sizeof(std::uint64_t);
+        std::uint64_t length = 0;
+        if constexpr (std::is_same_v<U, fl::rope>) {
+            value.for_each_chunk([&](std::string_view chunk) {
+                std::memcpy(text_at + length, chunk.data(), chunk.size());
+                length += chunk.size();
+            });
+        } else {
+            const std::string_view text = record_bytes(value);
+            if (!text.empty()) {
+                std::memcpy(text_at, text.data(), text.size());
+            }
+            length = text.size();
+        }
+        std::memcpy(length_at, &length, sizeof(length));
+        offset += sizeof(std::uint64_t) + static_cast<std::size_t>(length);
+    } else if constexpr (std::is_same_v<U, immutable_string>) {
+        offset = record_align_up(offset, alignof(U));
+        ::new (static_cast<void*>(payload + offset)) U(value);
+        offset += sizeof(U);
+    } else {
+        offset = record_align_up(offset, alignof(U));
+        std::memcpy(payload + offset, std::addressof(value), sizeof(U));
+        offset += sizeof(U);
+    }
+}
+
+// Reads back one argument stored as T. Text and bytes are viewed in place and an
+// immutable_string handle is referenced in place, so the payload must outlive
+// the result.
+template <typename T>
+record_decoded_t<T> record_decode(const std::byte* payload, std::size_t& offset) noexcept {
+    using U = typename record_stored<T>::type;
+    if constexpr (is_record_text_v<U>) {
+        offset = record_align_up(offset, alignof(std::uint64_t));
+        std::uint64_t length;
+        std::memcpy(&length, payload + offset, sizeof(length));
+        const char* text = reinterpret_cast<const char*>(payload + offset + sizeof(std::uint64_t));
+        offset += sizeof(std::uint64_t) + static_cast<std::size_t>(length);
+        return std::string_view(text, static_cast<std::size_t>(length));
+    } else if constexpr (is_record_bytes_v<U>) {
+        offset = record_align_up(offset, alignof(std::uint64_t));
+        std::uint64_t length;
+        std::memcpy(&length, payload + offset, sizeof(length));
+        const std::byte* bytes = payload + offset + sizeof(std::uint64_t);
+        offset += sizeof(std::uint64_t) + static_cast<std::size_t>(length);
+        return std::span<const std::byte>(bytes, static_cast<std::size_t>(length));
+    } else if constexpr (std::is_same_v<U, immutable_string>) {
+        offset = record_align_up(offset, alignof(U));
+        const U* stored = std::launder(reinterpret_cast<const U*>(payload + offset));
+        offset += sizeof(U);
+        return *stored;
+    } else {
+        offset = record_align_up(offset, alignof(U));
+        std::array<std::byte, sizeof(U)> bytes;
+        std::memcpy(bytes.data(), payload + offset, sizeof(U));
+        offset += sizeof(U);
+        return std::bit_cast<U>(bytes);
+    }
+}
+
+// Releases the immutable_string handles held by a record.
+template <typename... Args>
+void record_destroy(std::byte* payload, std::size_t offset) noexcept {
+    if constexpr (record_needs_destroy_v<Args...>) {
+        auto destroy_one = [&]<typename T>(std::type_identity<T>) {
+            using U = typename record_stored<T>::type;
+            if constexpr (std::is_same_v<U, immutable_string>) {
+                offset = record_align_up(offset, alignof(U));
+                std::launder(reinterpret_cast<U*>(payload + offset))->~U();
+                offset += sizeof(U);
+            } else {
+                (void)record_decode<T>(payload, offset);
+            }
+        };
+        (destroy_one(std::type_identity<Args>{}), ...);
+    } else {
+        (void)payload;
+        (void)offset;
+    }
+}
+
+// Presents a decoded value to the formatter under its original name, if any.
+template <typename T, typename D>
+constexpr decltype(auto) record_present(const D& value) noexcept {
+    using U = std::decay_t<T>;
+    if constexpr (record_name_traits<U>::is_static_named) {
+        return record_name_traits<U>::wrap(value);
+    } else {
+        return (value);
+    }
+}
+
+// A format string checked at compile time is a literal, so only its address
+// is stored. A runtime format string is copied into the record.
+inline std::size_t record_measure_format(std::string_view text, bool copy) noexcept {
+    return sizeof(const char*) + sizeof(std::uint64_t) + (copy ? text.size() : 0);
+}
+
+inline void record_encode_format(std::byte* payload, std::size_t& offset, std::string_view text,
+                                 bool copy) noexcept {
+    const char* data = text.data();
+    const std::uint64_t length = text.size();
+    if (copy) {
+        char* copied = reinterpret_cast<char*>(payload + offset + sizeof(data) + sizeof(length));
+        if (length != 0) {
+            std::memcpy(copied, text.data(), text.size());
+        }
+        data = copied;
+    }
+    std::memcpy(payload + offset, &data, sizeof(data));
+    std::memcpy(payload + offset + sizeof(data), &length, sizeof(length));
+    offset += record_measure_format(text, copy);
+}
+
+inline std::string_view record_decode_format(const std::byte* payload, std::size_t& offset) noexcept {
+    const char* data;
+    std::uint64_t length;
+    std::memcpy(&data, payload + offset, sizeof(data));
+    std::memcpy(&length, payload + offset + sizeof(data), sizeof(length));
+    offset += sizeof(data) + sizeof(length);
+    if (data == reinterpret_cast<const char*>(payload + offset)) {
+        offset += static_cast<std::size_t>(length);  // Copied into the record.
+    }
+    return std::string_view(data, static_cast<std::size_t>(length));
+}
+
+// Renders a record captured with a format_string: the format text, then the
+// arguments.
+template <typename Sink, typename... Args>
+void render_record(const std::byte* payload, Sink& out) {
+    std::size_t offset = 0;
+    const std::string_view fmt = record_decode_format(payload, offset);
+    const std::tuple<record_decoded_t<Args>...> values{record_decode<Args>(payload, offset)...};
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        vformat_impl(out, fmt, make_format_args(record_present<Args>(std::get<I>(values))...));
+    }(std::index_sequence_for<Args...>{});
+}
+
+// Renders a record captured with a static_format_string: the arguments only.
+template <fixed_string S, typename Sink, typename... Args>
+void render_static_record(const std::byte* payload, Sink& out) {
+    std::size_t offset = 0;
+    const std::tuple<record_decoded_t<Args>...> values{record_decode<Args>(payload, offset)...};
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        format_static_to<S>(out, record_present<Args>(std::get<I>(values))...);
+    }(std::index_sequence_for<Args...>{});
+}
+
+template <typename... Args>
+void destroy_record(std::byte* payload) noexcept {
+    std::size_t offset = 0;
+    (void)record_decode_format(payload, offset);
+    record_destroy<Args...>(payload, offset);
+}
+
+template <typename... Args>
+void destroy_static_record(std::byte* payload) noexcept {
+    record_destroy<Args...>(payload, 0);
+}
+
+}  // namespace detail
+
+// The arguments of one format call, captured into a caller-provided buffer
+// and formatted later by render(). The record refers to the buffer, which must
+// stay alive and unmoved for the record's lifetime; strings and byte spans are
+// copied into it, so the original arguments need not. Move-only: destroying the record
+// releases any immutable_string handles it holds.
+class format_record {
+public:
+    format_record() noexcept = default;
+
+    format_record(format_record&& other) noexcept
+        : _payload(std::exchange(other._payload, nullptr)),
+          _size(std::exchange(other._size, 0)),
+          _render(std::exchange(other._render, nullptr)),
+          _destroy(std::exchange(other._destroy, nullptr)) {}
+
+    format_record& operator=(format_record&& other) noexcept {
+        if (this != &other) {
+            reset();
+            _payload = std::exchange(other._payload, nullptr);
+            _size = std::exchange(other._size, 0);
+            _render = std::exchange(other._render, nullptr);
+            _destroy = std::exchange(other._destroy, nullptr);
+        }
+        return *this;
+    }
+
+    ~format_record() { reset(); }
+
+    // Bytes of buffer capture() needs for these arguments, including slack for
+    // aligning an arbitrary buffer.
+    template <typename... Args>
+    [[nodiscard]] static std::size_t required_size(format_string<Args...> fmt, const Args&... args) noexcept {
+        std::size_t size = detail::record_measure_format(fmt.get(), !fmt.is_checked());
+        (detail::record_measure(size, args), ...);
+        return size + detail::record_align - 1;
+    }
+
+    template <fixed_string S, typename... Args>
+    [[nodiscard]] static std::size_t required_size(static_format_string<S>, const Args&... args) noexcept {
+        std::size_t size = 0;
+        (detail::record_measure(size, args), ...);
+        return size + detail::record_align - 1;
+    }
+
+    // Serialises the arguments into buffer. A literal format string is
+    // checked against the argument types at compile time and stored by
+    // address; a runtime_format() string is copied. Throws
+    // std::overflow_error when the buffer is smaller than required_size().
+    template <typename... Args>
+    [[nodiscard]] static format_record capture(std::span<std::byte> buffer, format_string<Args...> fmt,
+                                               const Args&... args) {
+        const std::string_view text = fmt.get();
+        const bool copy = !fmt.is_checked();
+        std::size_t size = detail::record_measure_format(text, copy);
+        (detail::record_measure(size, args), ...);
+        std::byte* payload = place(buffer, size);
+        std::size_t offset = 0;
+        detail::record_encode_format(payload, offset, text, copy);
+        (detail::record_encode(payload, offset, args), ...);
+        return format_record(payload, size, &render_with<std::decay_t<Args>...>,
+                             detail::record_needs_destroy_v<Args...> ? &detail::destroy_record<std::decay_t<Args>...>
+                                                                     : nullptr);
+    }
+
+    // Serialises the arguments for a static format string ("..."_fmt); only
+    // the arguments are stored, and render() expands the parsed string.
+    template <fixed_string S, typename... Args>
+    [[nodiscard]] static format_record capture(std::span<std::byte> buffer, static_format_string<S>,
+                                               const Args&... args) {
+        std::size_t size = 0;
+        (detail::record_measure(size, args), ...);
+        std::byte* payload = place(buffer, size);
+        std::size_t offset = 0;
+        (detail::record_encode(payload, offset, args), ...);
+        return format_record(payload, size, &render_static_with<S, std::decay_t<Args>...>,
+                             detail::record_needs_destroy_v<Args...>
+                                 ? &detail::destroy_static_record<std::decay_t<Args>...>
+                                 : nullptr);
+    }
+
+    // Formats the captured call into sink. May be called any number of times.
+    template <sinks::character_sink Sink>
+    void render(Sink& sink) const {
+        if (!_render) {
+            return;
+        }
+        if constexpr (std::is_base_of_v<sinks::output_sink, Sink>) {
+            _render(_payload, sink);
+        } else {
+            detail::output_sink_ref<Sink> ref(sink);
+            _render(_payload, ref);
+        }
+    }
+
+    // Bytes of the buffer the record occupies.
+    [[nodiscard]] std::size_t size() const noexcept { return _size; }
+
+    [[nodiscard]] bool empty() const noexcept { return _render == nullptr; }
+
+private:
+    using render_fn = void (*)(const std::byte*, sinks::output_sink&);
+    using destroy_fn = void (*)(std::byte*) noexcept;
+
+    format_record(std::byte* payload, std::size_t size, render_fn render, destroy_fn destroy) noexcept
+        : _payload(payload), _size(size), _render(render), _destroy(destroy) {}
+
+    template <typename... Args>
+    static void render_with(const std::byte* payload, sinks::output_sink& sink) {
+        detail::render_record<sinks::output_sink, Args...>(payload, sink);
+    }
+
+    template <fixed_string S, typename... Args>
+    static void render_static_with(const std::byte* payload, sinks::output_sink& sink) {
+        detail::render_static_record<S, sinks::output_sink, Args...>(payload, sink);
+    }
+
+    static std::byte* place(std::span<std::byte> buffer, std::size_t size) {
+        void* at = buffer.data();
+        std::size_t space = buffer.size();
+        if (!std::align(detail::record_align, size, at, space)) {
+            throw std::overflow_error("fl::format_record: buffer too small");
+        }
+        return static_cast<std::byte*>(at);
+    }
+
+    void reset() noexcept {
+        if (_destroy) {
+            _destroy(_payload);
+        }
+        _payload = nullptr;
+        _size = 0;
+        _render = nullptr;
+        _destroy = nullptr;
+    }
+
+    std::byte* _payload = nullptr;
+    std::size_t _size = 0;
+    render_fn _render = nullptr;
+    destroy_fn _destroy = nullptr;
+};
+
+}  // namespace fl
+
+#endif  // FL_FORMAT_RECORD_HPP
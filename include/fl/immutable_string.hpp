@@ -309,7 +309,7 @@ public:
 private:
     void allocate_and_init(const char* s, size_type len) {
         size_type bytes = sizeof(control_block) + len;
-        void* mem = fl::allocate_bytes(bytes);
+        void* mem = fl::allocate_bytes_aligned(bytes, alignof(control_block));
         if (!mem) throw std::bad_alloc();
 
         _ctrl = static_cast<control_block*>(mem);
@@ -326,7 +326,7 @@ private:
     void destroy_control_block(control_block* cb) {
         cb->hash_computed.~atomic();
         cb->refcount.~atomic();
-        fl::deallocate_bytes(cb, sizeof(control_block) + cb->size);
+        fl::deallocate_bytes_aligned(cb, sizeof(control_block) + cb->size, alignof(control_block));
     }
 };
 
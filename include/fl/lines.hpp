@@ -0,0 +1,280 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_LINES_HPP
+#define FL_LINES_HPP
+
+// Line splitting for large buffers and ropes.
+//
+// Newlines are found a 64-byte block at a time: one vector compare per 32
+// bytes (AVX2) or 16 (SSE2) builds a 64-bit mask of the block's '\n' bytes,
+// and lines are then handed out from the mask, one bit each, without going
+// back to memory until the block is used up. A search per line, as a loop
+// over find('\n', pos) does, pays its setup once per line instead.
+//
+// A line ends at '\n', and a '\r' just before the '\n' is not part of it, so
+// LF and CRLF text split alike. The text after the last '\n' is a line if it
+// is not empty; text that ends in '\n' has no empty line after it.
+
+#include "fl/rope.hpp"
+#include "fl/string.hpp"
+#include "fl/substring_view.hpp"
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace fl {
+
+namespace detail {
+
+// Bit i is set where p[i] == '\n', for the 64 bytes at p.
+[[nodiscard]] inline std::uint64_t newline_mask(const char* p) noexcept {
+#if defined(__AVX2__)
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const auto low = static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), newline)));
+    const auto high = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), newline)));
+    return low | static_cast<std::uint64_t>(high) << 32;
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    const __m128i newline = _mm_set1_epi8('\n');
+    std::uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        mask |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline))))
+                << (16 * i);
+    }
+    return mask;
+#else
+    std::uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i) {
+        mask |= static_cast<std::uint64_t>(p[i] == '\n') << i;
+    }
+    return mask;
+#endif
+}
+
+#if defined(__AVX2__)
+// Whether the 64 bytes at p hold a '\n': one test, where newline_mask() needs
+// two masks and a merge.
+[[nodiscard]] inline bool has_newline(const char* p) noexcept {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i found =
+        _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), newline),
+                        _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), newline));
+    return _mm256_movemask_epi8(found) != 0;
+}
+#endif
+
+// Hands out the '\n' bytes of [first, last) in order, from the mask of one
+// 64-byte block at a time.
+class newline_scanner {
+public:
+    newline_scanner() noexcept = default;
+    newline_scanner(const char* first, const char* last) noexcept : _block(first), _last(last) { _load(); }
+
+    // The next '\n', or last once there are none left.
+    [[nodiscard]] const char* next() noexcept {
+        while (_mask == 0) {
+            if (_last - _block <= 64) {
+                return _last;
+            }
+            _block += 64;
+#if defined(__AVX2__)
+            // Long lines: skip whole blocks without building their masks.
+            while (_last - _block >= 64 && !has_newline(_block)) {
+                _block += 64;
+            }
+#endif
+            _load();
+        }
+        const char* const found = _block + std::countr_zero(_mask);
+        _mask &= _mask - 1;
+        return found;
+    }
+
+private:
+    void _load() noexcept {
+        if (_last - _block >= 64) {
+            _mask = newline_mask(_block);
+            return;
+        }
+        _mask = 0;
+        for (std::ptrdiff_t i = 0; i < _last - _block; ++i) {
+            _mask |= static_cast<std::uint64_t>(_block[i] == '\n') << i;
+        }
+    }
+
+    const char* _block = nullptr;
+    const char* _last = nullptr;
+    std::uint64_t _mask = 0;
+};
+
+// The line from first to the '\n' at newline, without a '\r' before it.
+[[nodiscard]] inline std::string_view line_before(const char* first, const char* newline) noexcept {
+    const std::size_t size = static_cast<std::size_t>(newline - first);
+    return std::string_view(first, size - (size != 0 && newline[-1] == '\r'));
+}
+
+// Calls fn(line); false when fn returns bool and asks to stop.
+template <typename Fn>
+[[nodiscard]] bool emit_line(Fn& fn, std::string_view line) {
+    if constexpr (std::is_same_v<std::invoke_result_t<Fn&, std::string_view>, bool>) {
+        return fn(line);
+    } else {
+        fn(line);
+        return true;
+    }
+}
+
+}  // namespace detail
+
+// Forward range of the lines of text, as std::string_views into it.
+class line_view {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() noexcept = default;
+        iterator(const char* first, const char* last) noexcept
+            : _position(first), _last(last), _scanner(first, last) {
+            _find_line();
+        }
+
+        [[nodiscard]] reference operator*() const noexcept { return _line; }
+        [[nodiscard]] pointer operator->() const noexcept { return &_line; }
+
+        iterator& operator++() noexcept {
+            _position = _next;
+            _find_line();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator before = *this;
+            ++*this;
+            return before;
+        }
+
+        [[nodiscard]] bool operator==(const iterator& other) const noexcept { return _position == other._position; }
+
+    private:
+        void _find_line() noexcept {
+            if (_position == _last) {
+                return;
+            }
+            const char* const newline = _scanner.next();
+            if (newline == _last) {
+                _line = std::string_view(_position, static_cast<std::size_t>(_last - _position));
+                _next = _last;
+            } else {
+                _line = detail::line_before(_position, newline);
+                _next = newline + 1;
+            }
+        }
+
+        const char* _position = nullptr;
+        const char* _next = nullptr;
+        const char* _last = nullptr;
+        std::string_view _line;
+        detail::newline_scanner _scanner;
+    };
+
+    line_view() noexcept = default;
+    // From anything that converts to std::string_view: fl::string,
+    // std::string, a string literal.
+    template <typename Text>
+        requires std::convertible_to<const Text&, std::string_view>
+    line_view(const Text& text) noexcept : _text(text) {}
+
+    template <std::same_as<substring_view> View>
+    line_view(const View& text) noexcept : _text(text.data(), text.size()) {}
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator(_text.data(), _text.data() + _text.size()); }
+    [[nodiscard]] iterator end() const noexcept {
+        return iterator(_text.data() + _text.size(), _text.data() + _text.size());
+    }
+
+    [[nodiscard]] std::string_view bytes() const noexcept { return _text; }
+    [[nodiscard]] bool empty() const noexcept { return _text.empty(); }
+
+private:
+    std::string_view _text;
+};
+
+// The lines of text; see line_view.
+template <typename Text>
+    requires std::convertible_to<const Text&, std::string_view> || std::same_as<Text, substring_view>
+[[nodiscard]] line_view lines(const Text& text) noexcept {
+    return line_view(text);
+}
+
+// Calls fn(std::string_view) for each line of text. If fn returns bool,
+// false stops the iteration.
+template <typename Fn>
+void for_each_line(std::string_view text, Fn&& fn) {
+    const char* p = text.data();
+    const char* const last = p + text.size();
+    detail::newline_scanner scanner(p, last);
+    for (const char* newline; (newline = scanner.next()) != last; p = newline + 1) {
+        if (!detail::emit_line(fn, detail::line_before(p, newline))) {
+            return;
+        }
+    }
+    if (p != last) {
+        (void)detail::emit_line(fn, std::string_view(p, static_cast<std::size_t>(last - p)));
+    }
+}
+
+template <std::same_as<substring_view> View, typename Fn>
+void for_each_line(const View& text, Fn&& fn) {
+    for_each_line(std::string_view(text.data(), text.size()), fn);
+}
+
+// The rope overload visits the leaves in place. A line within one leaf is a
+// view into it; a line that spans leaves is assembled in a buffer first, so
+// the view passed to fn is only valid during the call.
+template <std::same_as<rope> Rope, typename Fn>
+void for_each_line(const Rope& text, Fn&& fn) {
+    std::string spanning;
+    bool stopped = false;
+    text.for_each_chunk([&](std::string_view chunk) {
+        const char* p = chunk.data();
+        const char* const last = p + chunk.size();
+        detail::newline_scanner scanner(p, last);
+        for (const char* newline; (newline = scanner.next()) != last; p = newline + 1) {
+            std::string_view line;
+            if (spanning.empty()) {
+                line = detail::line_before(p, newline);
+            } else {
+                spanning.append(p, newline);
+                line = detail::line_before(spanning.data(), spanning.data() + spanning.size());
+            }
+            if (!detail::emit_line(fn, line)) {
+                stopped = true;
+                return false;
+            }
+            spanning.clear();
+        }
+        spanning.append(p, last);
+        return true;
+    });
+    if (!stopped && !spanning.empty()) {
+        (void)detail::emit_line(fn, std::string_view(spanning));
+    }
+}
+
+}  // namespace fl
+
+#endif  // FL_LINES_HPP
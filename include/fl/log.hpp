@@ -0,0 +1,568 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_LOG_HPP
+#define FL_LOG_HPP
+
+// Asynchronous logging on top of fl::format and fl::sinks.
+//
+// A log call does not format. It copies its arguments into a record in a ring
+// buffer owned by the calling thread: numbers and pointer values as raw
+// bytes, strings and byte spans as copied bytes, and fl::immutable_string as a
+// reference-counted handle (see fl/format_record.hpp). The record starts with
+// the address of a function instantiated for the call's format string and
+// argument types, which serves as the format id. A background thread drains
+// the rings, decodes each record, formats it with the fl formatting engine and
+// writes the lines to a sinks::output_sink.
+//
+// Each ring has exactly one producer (its thread) and one consumer (the
+// logger thread), so the hot path takes no lock and performs no atomic
+// read-modify-write: it reserves space, copies, and publishes with one release
+// store. Lines from one thread keep their order; lines from different threads
+// are interleaved in the order the logger thread visits the rings.
+
+#include "fl/format.hpp"
+#include "fl/format_record.hpp"
+#include "fl/immutable_string.hpp"
+#include "fl/rope.hpp"
+#include "fl/sinks.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fl {
+namespace log {
+
+enum class level : std::uint8_t { trace, debug, info, warn, error, off };
+
+constexpr std::string_view level_name(level lv) noexcept {
+    switch (lv) {
+        case level::trace:
+            return "trace";
+        case level::debug:
+            return "debug";
+        case level::info:
+            return "info";
+        case level::warn:
+            return "warn";
+        case level::error:
+            return "error";
+        default:
+            return "off";
+    }
+}
+
+// What a log call does when its thread's ring has no room for the record.
+enum class overflow_policy : std::uint8_t {
+    block,  // Wait for the logger thread to make room.
+    drop,   // Discard the record and count it in logger::dropped().
+};
+
+struct options {
+    // Bytes of ring buffer per logging thread, rounded up to a power of two.
+    // A record larger than the ring is always dropped.
+    std::size_t ring_capacity = std::size_t{1} << 20;
+    overflow_policy overflow = overflow_policy::block;
+    level min_level = level::info;
+    // Prefix each line with "[level] ".
+    bool level_prefix = true;
+    // How long the logger thread sleeps when every ring is empty.
+    std::chrono::microseconds idle_wait{200};
+};
+
+namespace detail {
+
+using fl::detail::record_align;
+
+// Decodes, formats and destroys one record's payload, appending the message to
+// out. Instantiated per format string and argument types; its address is the
+// record's format id.
+using consume_fn = void (*)(std::byte* payload, sinks::growing_sink& out);
+
+struct record_header {
+    std::uint32_t size;  // Whole record including this header; a multiple of record_align.
+    level lv;
+    consume_fn consume;  // Null for the padding that skips to the start of the ring.
+};
+
+static_assert(sizeof(record_header) <= record_align);
+inline constexpr std::size_t header_size = record_align;
+
+// The argument codec is fl::format_record's. The consume functions format a
+// record and then release the handles it holds, even when formatting throws.
+template <void (*Destroy)(std::byte*) noexcept>
+struct record_release {
+    std::byte* payload;
+    ~record_release() { Destroy(payload); }
+};
+
+template <typename... Args>
+void consume_runtime(std::byte* payload, sinks::growing_sink& out) {
+    const record_release<&fl::detail::destroy_record<Args...>> release{payload};
+    fl::detail::render_record<sinks::growing_sink, Args...>(payload, out);
+}
+
+template <fixed_string S, typename... Args>
+void consume_static(std::byte* payload, sinks::growing_sink& out) {
+    const record_release<&fl::detail::destroy_static_record<Args...>> release{payload};
+    fl::detail::render_static_record<S, sinks::growing_sink, Args...>(payload, out);
+}
+
+// ---------------------------------------------------------------------------
+// Single-producer, single-consumer ring of variable-length records. Positions
+// count bytes since creation and are masked into the buffer; a record never
+// wraps, and the space it would have wrapped over is skipped with a padding
+// record.
+class ring {
+public:
+    explicit ring(std::size_t capacity)
+        : _capacity(std::bit_ceil(std::max(capacity, std::size_t{1024}))),
+          _buffer(new (std::align_val_t{record_align}) std::byte[_capacity]) {
+        // Touch every page now, on the thread's first log call, so that later
+        // calls never take a page fault.
+        std::memset(_buffer, 0, _capacity);
+    }
+
+    ring(const ring&) = delete;
+    ring& operator=(const ring&) = delete;
+
+    ~ring() { ::operator delete[](_buffer, std::align_val_t{record_align}); }
+
+    std::size_t capacity() const noexcept { return _capacity; }
+
+    // Producer: returns space for a record of size bytes, a multiple of
+    // record_align, or nullptr when the ring is full. publish() makes it
+    // visible.
+    std::byte* try_reserve(std::size_t size) noexcept {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        const std::size_t index = tail & (_capacity - 1);
+        const std::size_t pad = index + size > _capacity ? _capacity - index : 0;
+        if (pad + size > _capacity - (tail - _cached_head)) {
+            _cached_head = _head.load(std::memory_order_acquire);
+            if (pad + size > _capacity - (tail - _cached_head)) {
+                return nullptr;
+            }
+        }
+        if (pad != 0) {
+            ::new (static_cast<void*>(_buffer + index)) record_header{static_cast<std::uint32_t>(pad), level::off, nullptr};
+        }
+        _reserved = tail + pad;
+        return _buffer + (_reserved & (_capacity - 1));
+    }
+
+    void publish(std::size_t size) noexcept { _tail.store(_reserved + size, std::memory_order_release); }
+
+    // Consumer: calls fn(header, payload) for every published record, freeing
+    // each one's space as soon as fn returns. Returns the number consumed.
+    template <typename Fn>
+    std::size_t drain(Fn&& fn) {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        const std::size_t tail = _tail.load(std::memory_order_acquire);
+        std::size_t count = 0;
+        while (head != tail) {
+            std::byte* at = _buffer + (head & (_capacity - 1));
+            const record_header header = *std::launder(reinterpret_cast<record_header*>(at));
+            if (header.consume) {
+                fn(header, at + header_size);
+                ++count;
+            }
+            head += header.size;
+            _head.store(head, std::memory_order_release);
+        }
+        return count;
+    }
+
+    bool empty() const noexcept {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    // Set when the producing thread has exited; the ring is released once
+    // drained.
+    void close() noexcept { _closed.store(true, std::memory_order_release); }
+    bool closed() const noexcept { return _closed.load(std::memory_order_acquire); }
+
+    // Set when the logger has stopped; the producing thread forgets the ring.
+    void detach() noexcept { _detached.store(true, std::memory_order_release); }
+    bool detached() const noexcept { return _detached.load(std::memory_order_acquire); }
+
+private:
+    const std::size_t _capacity;
+    std::byte* const _buffer;
+    std::atomic<bool> _closed{false};
+    std::atomic<bool> _detached{false};
+
+    alignas(64) std::atomic<std::size_t> _head{0};  // Written by the consumer.
+
+    alignas(64) std::atomic<std::size_t> _tail{0};  // Written by the producer.
+    std::size_t _cached_head = 0;
+    std::size_t _reserved = 0;
+};
+
+// The rings the current thread logs into, one per logger. The last one used
+// is cached, so a thread logging to one logger finds its ring with a single
+// comparison.
+struct thread_rings {
+    std::uint64_t last_owner = 0;
+    ring* last = nullptr;
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<ring>>> rings;
+
+    ~thread_rings() {
+        for (auto& entry : rings) {
+            entry.second->close();
+        }
+    }
+};
+
+inline thread_rings& current_thread_rings() noexcept {
+    thread_local thread_rings rings;
+    return rings;
+}
+
+inline std::uint64_t next_logger_id() noexcept {
+    static std::atomic<std::uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+// Formats and writes log records on a background thread. Any number of
+// threads may log concurrently; each gets its own ring on first use. The sink
+// is only ever written by the logger thread and must outlive the logger.
+class logger {
+public:
+    explicit logger(sinks::output_sink& sink, options opts = {})
+        : _sink(sink),
+          _id(detail::next_logger_id()),
+          _ring_capacity(opts.ring_capacity),
+          _overflow(opts.overflow),
+          _level_prefix(opts.level_prefix),
+          _idle_wait(opts.idle_wait),
+          _min_level(opts.min_level) {
+        _thread = std::thread([this] { run(); });
+    }
+
+    logger(const logger&) = delete;
+    logger& operator=(const logger&) = delete;
+
+    ~logger() { stop(); }
+
+    [[nodiscard]] bool enabled(level lv) const noexcept {
+        return lv >= _min_level.load(std::memory_order_relaxed);
+    }
+
+    // Changes the minimum level. Has no effect once the logger has stopped.
+    void set_level(level lv) noexcept {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_stopping) {
+            _min_level.store(lv, std::memory_order_relaxed);
+        }
+    }
+
+    // Records a message. The format string is checked against the argument
+    // types at compile time; the arguments are copied, strings and byte spans
+    // included, so they may change or go away as soon as the call returns.
+    template <typename... Args>
+    void log(level lv, format_string<Args...> fmt, Args&&... args) {
+        if (!enabled(lv)) {
+            return;
+        }
+        const std::string_view text = fmt.get();
+        const bool copy_text = !fmt.is_checked();
+        std::size_t payload = fl::detail::record_measure_format(text, copy_text);
+        (fl::detail::record_measure(payload, args), ...);
+        write(lv, &detail::consume_runtime<std::decay_t<Args>...>, payload, [&](std::byte* at) {
+            std::size_t offset = 0;
+            fl::detail::record_encode_format(at, offset, text, copy_text);
+            (fl::detail::record_encode(at, offset, args), ...);
+        });
+    }
+
+    // Records a message with a static format string ("..."_fmt), which the
+    // logger thread renders as expanded straight-line code.
+    template <fixed_string S, typename... Args>
+    void log(level lv, static_format_string<S>, Args&&... args) {
+        if (!enabled(lv)) {
+            return;
+        }
+        std::size_t payload = 0;
+        (fl::detail::record_measure(payload, args), ...);
+        write(lv, &detail::consume_static<S, std::decay_t<Args>...>, payload, [&](std::byte* at) {
+            std::size_t offset = 0;
+            (fl::detail::record_encode(at, offset, args), ...);
+        });
+    }
+
+    template <typename... Args>
+    void trace(format_string<Args...> fmt, Args&&... args) {
+        log(level::trace, fmt, std::forward<Args>(args)...);
+    }
+
+    template <fixed_string S, typename... Args>
+    void trace(static_format_string<S> fmt, Args&&... args) {
+        log(level::trace, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void debug(format_string<Args...> fmt, Args&&... args) {
+        log(level::debug, fmt, std::forward<Args>(args)...);
+    }
+
+    template <fixed_string S, typename... Args>
+    void debug(static_format_string<S> fmt, Args&&... args) {
+        log(level::debug, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void info(format_string<Args...> fmt, Args&&... args) {
+        log(level::info, fmt, std::forward<Args>(args)...);
+    }
+
+    template <fixed_string S, typename... Args>
+    void info(static_format_string<S> fmt, Args&&... args) {
+        log(level::info, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void warn(format_string<Args...> fmt, Args&&... args) {
+        log(level::warn, fmt, std::forward<Args>(args)...);
+    }
+
+    template <fixed_string S, typename... Args>
+    void warn(static_format_string<S> fmt, Args&&... args) {
+        log(level::warn, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void error(format_string<Args...> fmt, Args&&... args) {
+        log(level::error, fmt, std::forward<Args>(args)...);
+    }
+
+    template <fixed_string S, typename... Args>
+    void error(static_format_string<S> fmt, Args&&... args) {
+        log(level::error, fmt, std::forward<Args>(args)...);
+    }
+
+    // Blocks until every record logged before the call by this thread, or by
+    // threads whose calls completed before it, has been written, then flushes
+    // the sink.
+    void flush() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_stopping) {
+            return;
+        }
+        const std::uint64_t ticket = ++_flush_requested;
+        _wake.notify_one();
+        _flushed.wait(lock, [&] { return _flush_done >= ticket || _stopping; });
+    }
+
+    // Writes everything still queued, flushes the sink and joins the logger
+    // thread. Later log calls are discarded. Called by the destructor.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_stopping) {
+                return;
+            }
+            _min_level.store(level::off, std::memory_order_relaxed);
+            _stopping = true;
+        }
+        _wake.notify_one();
+        _thread.join();
+        std::lock_guard<std::mutex> lock(_rings_mutex);
+        for (auto& r : _rings) {
+            r->detach();
+        }
+        _rings.clear();
+        _flushed.notify_all();
+    }
+
+    // Records discarded because a ring was full (with overflow_policy::drop)
+    // or the record was larger than a ring, or because formatting or writing
+    // them failed.
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    template <typename Encode>
+    void write(level lv, detail::consume_fn consume, std::size_t payload, Encode&& encode) {
+        const std::size_t size = fl::detail::record_align_up(detail::header_size + payload, detail::record_align);
+        detail::ring& r = local_ring();
+        if (size > r.capacity()) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::byte* at = r.try_reserve(size);
+        while (!at) {
+            if (_overflow == overflow_policy::drop || !enabled(lv)) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            _wake.notify_one();
+            std::this_thread::yield();
+            at = r.try_reserve(size);
+        }
+        ::new (static_cast<void*>(at)) detail::record_header{static_cast<std::uint32_t>(size), lv, consume};
+        encode(at + detail::header_size);
+        r.publish(size);
+    }
+
+    detail::ring& local_ring() {
+        detail::thread_rings& rings = detail::current_thread_rings();
+        if (rings.last_owner == _id) {
+            return *rings.last;
+        }
+        return attach(rings);
+    }
+
+    detail::ring& attach(detail::thread_rings& rings) {
+        std::erase_if(rings.rings, [](const auto& entry) { return entry.second->detached(); });
+        auto found = std::find_if(rings.rings.begin(), rings.rings.end(),
+                                  [&](const auto& entry) { return entry.first == _id; });
+        if (found == rings.rings.end()) {
+            auto r = std::make_shared<detail::ring>(_ring_capacity);
+            {
+                std::lock_guard<std::mutex> lock(_rings_mutex);
+                _rings.push_back(r);
+                _rings_version.fetch_add(1, std::memory_order_release);
+            }
+            rings.rings.emplace_back(_id, std::move(r));
+            found = rings.rings.end() - 1;
+        }
+        rings.last_owner = _id;
+        rings.last = found->second.get();
+        return *rings.last;
+    }
+
+    // Formats every queued record of r into batch, handing the batch to the
+    // sink whenever it grows past a block.
+    std::size_t drain(detail::ring& r, sinks::growing_sink& batch) {
+        return r.drain([&](const detail::record_header& header, std::byte* payload) {
+            const std::size_t mark = batch.size();
+            try {
+                if (_level_prefix) {
+                    batch.put('[');
+                    const std::string_view name = level_name(header.lv);
+                    batch.write(name.data(), name.size());
+                    batch.write("] ", 2);
+                }
+                header.consume(payload, batch);
+                batch.put('\n');
+            } catch (...) {
+                batch.truncate(mark);
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            ++_batch_records;
+            if (batch.size() >= batch_block) {
+                write_batch(batch);
+            }
+        });
+    }
+
+    void write_batch(sinks::growing_sink& batch) {
+        if (batch.size() != 0) {
+            try {
+                _sink.write(batch.data(), batch.size());
+            } catch (...) {
+                _dropped.fetch_add(_batch_records, std::memory_order_relaxed);
+            }
+        }
+        batch.reset();
+        _batch_records = 0;
+    }
+
+    void run() {
+        std::vector<std::shared_ptr<detail::ring>> rings;
+        std::uint64_t rings_version = 0;
+        sinks::growing_sink batch(batch_block * 2);
+        for (;;) {
+            std::uint64_t ticket;
+            bool stopping;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                ticket = _flush_requested;
+                stopping = _stopping;
+            }
+            if (_rings_version.load(std::memory_order_acquire) != rings_version) {
+                std::lock_guard<std::mutex> lock(_rings_mutex);
+                rings = _rings;
+                rings_version = _rings_version.load(std::memory_order_relaxed);
+            }
+
+            std::size_t consumed = 0;
+            bool released = false;
+            for (auto& r : rings) {
+                consumed += drain(*r, batch);
+                released = released || (r->closed() && r->empty());
+            }
+            write_batch(batch);
+            if (released) {
+                release_closed_rings();
+            }
+
+            if (ticket != _flush_done || (stopping && consumed == 0)) {
+                try {
+                    _sink.flush();
+                } catch (...) {
+                }
+                std::lock_guard<std::mutex> lock(_mutex);
+                _flush_done = ticket;
+                _flushed.notify_all();
+            }
+            if (stopping && consumed == 0) {
+                return;
+            }
+            if (consumed == 0) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait_for(lock, _idle_wait, [&] { return _stopping || _flush_requested != ticket; });
+            }
+        }
+    }
+
+    void release_closed_rings() {
+        std::lock_guard<std::mutex> lock(_rings_mutex);
+        std::erase_if(_rings, [](const auto& r) { return r->closed() && r->empty(); });
+        _rings_version.fetch_add(1, std::memory_order_release);
+    }
+
+    static constexpr std::size_t batch_block = 64 * 1024;
+
+    sinks::output_sink& _sink;
+    const std::uint64_t _id;
+    const std::size_t _ring_capacity;
+    const overflow_policy _overflow;
+    const bool _level_prefix;
+    const std::chrono::microseconds _idle_wait;
+    std::atomic<level> _min_level;
+    std::atomic<std::uint64_t> _dropped{0};
+    std::uint64_t _batch_records = 0;  // Logger thread only.
+
+    std::mutex _rings_mutex;
+    std::vector<std::shared_ptr<detail::ring>> _rings;
+    std::atomic<std::uint64_t> _rings_version{0};
+
+    std::mutex _mutex;  // Guards the flush and stop state below.
+    std::condition_variable _wake;
+    std::condition_variable _flushed;
+    std::uint64_t _flush_requested = 0;
+    std::uint64_t _flush_done = 0;
+    bool _stopping = false;
+
+    std::thread _thread;
+};
+
+}  // namespace log
+}  // namespace fl
+
+#endif  // FL_LOG_HPP
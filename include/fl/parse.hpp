@@ -0,0 +1,563 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_PARSE_HPP
+#define FL_PARSE_HPP
+
+// Conversion of text to numbers, the reverse of number_format.hpp. Accepts
+// the same syntax as std::from_chars in decimal and general format: an
+// optional '-' (signed and floating-point types only), digits, and for
+// floating point an optional fraction, exponent, "inf", "infinity" or "nan".
+// There is no leading whitespace, '+' or locale.
+//
+// Digits are consumed eight at a time with SWAR: one 64-bit load is checked
+// for eight ASCII digits and folded into a value with three multiplies.
+// Floating-point values with at most 19 significant digits are converted
+// with Clinger's exact fast path or the Eisel-Lemire algorithm over the
+// 128-bit power-of-ten table shared with the formatter. The few inputs that
+// neither settles (more digits than fit and an ambiguous rounding, or an
+// exponent beyond the table) are handed to std::from_chars.
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "fl/number_format.hpp"
+#include "fl/substring_view.hpp"
+
+namespace fl {
+
+// Types fl::parse converts to: integers other than bool, float and double.
+template <typename T>
+concept parsable_number = (std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_same_v<T, float> ||
+                          std::is_same_v<T, double>;
+
+// Result of parse_prefix(): the value, the number of characters consumed,
+// and std::errc{} on success, invalid_argument when the text does not start
+// with a number, or result_out_of_range when the number does not fit T.
+template <typename T>
+struct parse_result {
+    T value{};
+    std::size_t size = 0;
+    std::errc error{};
+
+    [[nodiscard]] explicit operator bool() const noexcept { return error == std::errc{}; }
+};
+
+namespace detail {
+
+[[nodiscard]] inline std::uint64_t load_le64(const char* p) noexcept {
+    std::uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big) {
+        value = __builtin_bswap64(value);
+    }
+    return value;
+}
+
+// Marks with its top bit each byte that is not '0'-'9': adding 0x46 carries
+// into the top bit of any byte above '9', and subtracting 0x30 borrows into
+// it for any byte below '0'. Carries and borrows only move upwards, so the
+// lowest marked byte is always the first non-digit.
+[[nodiscard]] constexpr std::uint64_t non_digit_mask(std::uint64_t chunk) noexcept {
+    return ((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) & 0x8080808080808080;
+}
+
+// Value of eight digits, first digit in the lowest byte: adjacent digits,
+// then pairs, then quads are joined with one multiply each.
+[[nodiscard]] constexpr std::uint32_t parse_eight_digits(std::uint64_t chunk) noexcept {
+    chunk = (chunk & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+    chunk = (chunk & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+    return static_cast<std::uint32_t>((chunk & 0x0000FFFF0000FFFF) * 42949672960001 >> 32);
+}
+
+[[nodiscard]] constexpr bool is_digit(char c) noexcept { return static_cast<unsigned char>(c - '0') < 10; }
+
+inline constexpr std::uint32_t small_powers_of_ten[8] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+
+// Accumulates the digits at p into value and advances p past them. While
+// eight bytes remain, each load takes eight digits, or the run of fewer
+// digits that ends the number: shifting them to the top of the word leaves
+// zero bytes in front, which parse as leading zeros. Fewer than eight bytes
+// before last are read with one load ending at last when the bytes from
+// begin allow it. value wraps if there are more than 19 digits.
+inline void accumulate_digits(const char*& p, const char* begin, const char* last, std::uint64_t& value) noexcept {
+    while (last - p >= 8) {
+        const std::uint64_t chunk = load_le64(p);
+        const std::uint64_t mask = non_digit_mask(chunk);
+        if (mask == 0) {
+            value = value * 100000000 + parse_eight_digits(chunk);
+            p += 8;
+            continue;
+        }
+        const int count = std::countr_zero(mask) / 8;
+        if (count != 0) {
+            value = value * small_powers_of_ten[count] + parse_eight_digits(chunk << (64 - 8 * count));
+            p += count;
+        }
+        return;
+    }
+    if (p != last && last - begin >= 8) {
+        // The bytes before p are dropped by the shift; the zero bytes it
+        // brings in above the remainder mark its end.
+        const std::uint64_t chunk = load_le64(last - 8) >> (8 * (8 - (last - p)));
+        const int count = std::countr_zero(non_digit_mask(chunk)) / 8;
+        if (count != 0) {
+            value = value * small_powers_of_ten[count] + parse_eight_digits(chunk << (64 - 8 * count));
+            p += count;
+        }
+        return;
+    }
+    while (p != last && is_digit(*p)) {
+        value = value * 10 + static_cast<unsigned>(*p - '0');
+        ++p;
+    }
+}
+
+template <typename T>
+[[nodiscard]] parse_result<T> parse_integer(const char* first, const char* last) noexcept {
+    parse_result<T> result;
+    const char* p = first;
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if (p != last && *p == '-') {
+            negative = true;
+            ++p;
+        }
+    }
+    const char* const start = p;
+    while (p != last && *p == '0') {
+        ++p;
+    }
+    const char* const digits = p;
+    // Nineteen digits always fit in 64 bits.
+    std::uint64_t value = 0;
+    const char* const safe_end = digits + std::min<std::ptrdiff_t>(last - digits, 19);
+    accumulate_digits(p, first, safe_end, value);
+    bool overflow = false;
+    if (p == safe_end && p != last && is_digit(*p)) {
+        constexpr std::uint64_t max_tenth = std::numeric_limits<std::uint64_t>::max() / 10;
+        const unsigned digit = static_cast<unsigned>(*p - '0');
+        overflow = value > max_tenth || (value == max_tenth && digit > 5);
+        value = value * 10 + digit;
+        for (++p; p != last && is_digit(*p); ++p) {
+            overflow = true;
+        }
+    }
+    if (p == start) {
+        result.error = std::errc::invalid_argument;
+        return result;
+    }
+    result.size = static_cast<std::size_t>(p - first);
+    using U = std::make_unsigned_t<T>;
+    const std::uint64_t limit =
+        static_cast<std::uint64_t>(std::numeric_limits<U>::max() >> (std::is_signed_v<T> ? 1 : 0)) + (negative ? 1 : 0);
+    if (overflow || value > limit) {
+        result.error = std::errc::result_out_of_range;
+        return result;
+    }
+    result.value = negative ? static_cast<T>(U{0} - static_cast<U>(value)) : static_cast<T>(value);
+    return result;
+}
+
+// Binary layout of float and double, and the exponent ranges the fast paths
+// cover (those of fast_float).
+template <typename F>
+struct binary_format;
+
+template <>
+struct binary_format<double> {
+    using bits_type = std::uint64_t;
+    static constexpr int mantissa_bits = 52;
+    static constexpr int minimum_exponent = -1023;
+    static constexpr int infinite_power = 0x7FF;
+    static constexpr int min_round_to_even = -4;
+    static constexpr int max_round_to_even = 23;
+    static constexpr int max_exact_exponent = 22;
+    static constexpr int smallest_power_of_ten = -342;
+    static constexpr int largest_power_of_ten = 308;
+    static constexpr double exact_powers[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+};
+
+template <>
+struct binary_format<float> {
+    using bits_type = std::uint32_t;
+    static constexpr int mantissa_bits = 23;
+    static constexpr int minimum_exponent = -127;
+    static constexpr int infinite_power = 0xFF;
+    static constexpr int min_round_to_even = -17;
+    static constexpr int max_round_to_even = 10;
+    static constexpr int max_exact_exponent = 10;
+    static constexpr int smallest_power_of_ten = -64;
+    static constexpr int largest_power_of_ten = 38;
+    static constexpr float exact_powers[11] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+};
+
+// A decimal number as read from text: significand * 10^exponent, with at
+// most 19 significant digits kept.
+struct parsed_decimal {
+    std::uint64_t significand = 0;
+    std::int64_t exponent = 0;
+    bool negative = false;
+    bool truncated = false;  // Digits beyond the 19th were dropped.
+    const char* end = nullptr;
+};
+
+// Reads [-]digits[.digits][(e|E)[+|-]digits]. Returns false if there is no
+// digit before the exponent. An 'e' without exponent digits is not consumed.
+inline bool parse_decimal(const char* first, const char* last, parsed_decimal& out) noexcept {
+    const char* p = first;
+    out.negative = p != last && *p == '-';
+    p += out.negative ? 1 : 0;
+
+    const char* const integer_start = p;
+    std::uint64_t value = 0;
+    accumulate_digits(p, first, last, value);
+    const char* const integer_end = p;
+    std::int64_t digit_count = integer_end - integer_start;
+    std::int64_t exponent = 0;
+    const char* fraction_start = p;
+    const char* fraction_end = p;
+    if (p != last && *p == '.') {
+        fraction_start = ++p;
+        accumulate_digits(p, first, last, value);
+        fraction_end = p;
+        exponent = fraction_start - fraction_end;
+        digit_count -= exponent;
+    }
+    if (digit_count == 0) {
+        return false;
+    }
+
+    std::int64_t explicit_exponent = 0;
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        const bool negative_exponent = q != last && *q == '-';
+        q += (q != last && (*q == '-' || *q == '+')) ? 1 : 0;
+        if (q != last && is_digit(*q)) {
+            for (; q != last && is_digit(*q); ++q) {
+                // Saturate: such an exponent is out of range either way.
+                if (explicit_exponent < 0x10000000) {
+                    explicit_exponent = explicit_exponent * 10 + (*q - '0');
+                }
+            }
+            explicit_exponent = negative_exponent ? -explicit_exponent : explicit_exponent;
+            p = q;
+        }
+    }
+    out.end = p;
+    exponent += explicit_exponent;
+
+    if (digit_count > 19) {
+        // Leading zeros are not significant.
+        for (const char* z = integer_start; z != fraction_end && (*z == '0' || *z == '.'); ++z) {
+            digit_count -= *z == '0' ? 1 : 0;
+        }
+        if (digit_count > 19) {
+            out.truncated = true;
+            constexpr std::uint64_t min_nineteen_digits = 1000000000000000000;
+            value = 0;
+            const char* d = integer_start;
+            for (; value < min_nineteen_digits && d != integer_end; ++d) {
+                value = value * 10 + static_cast<unsigned>(*d - '0');
+            }
+            if (value >= min_nineteen_digits) {
+                exponent = (integer_end - d) + explicit_exponent;
+            } else {
+                for (d = fraction_start; value < min_nineteen_digits && d != fraction_end; ++d) {
+                    value = value * 10 + static_cast<unsigned>(*d - '0');
+                }
+                exponent = (fraction_start - d) + explicit_exponent;
+            }
+        }
+    }
+    out.significand = value;
+    out.exponent = exponent;
+    return true;
+}
+
+// Result of Eisel-Lemire: the biased exponent and explicit mantissa bits of
+// the nearest binary value, or power2 == -1 if the table cannot decide it.
+struct adjusted_mantissa {
+    std::uint64_t mantissa = 0;
+    int power2 = 0;
+
+    bool operator==(const adjusted_mantissa&) const = default;
+};
+
+// 128-bit approximation of 5^q for Eisel-Lemire. The formatter's table holds
+// floor(x) + 1 for every entry; the algorithm's error analysis wants floor(x)
+// except for -27 <= q < 0, where floor(x) + 1 is already what it expects.
+[[nodiscard]] inline uint128_parts eisel_lemire_power(std::int64_t q) noexcept {
+    uint128_parts power = pow10_significands[q - pow10_significand_min_exponent];
+    if (q >= 0 || q < -27) {
+        power.hi -= power.lo == 0 ? 1 : 0;
+        power.lo -= 1;
+    }
+    return power;
+}
+
+// Nearest binary value to w * 10^q, w != 0, rounding half to even.
+template <typename F>
+[[nodiscard]] adjusted_mantissa eisel_lemire(std::int64_t q, std::uint64_t w) noexcept {
+    using format = binary_format<F>;
+    adjusted_mantissa answer;
+    if (q < format::smallest_power_of_ten) {
+        return answer;
+    }
+    if (q > format::largest_power_of_ten) {
+        answer.power2 = format::infinite_power;
+        return answer;
+    }
+    if (q < pow10_significand_min_exponent) {
+        answer.power2 = -1;
+        return answer;
+    }
+    const int leading_zeros = std::countl_zero(w);
+    w <<= leading_zeros;
+
+    // The mantissa, an extra rounding bit and a bit lost to normalisation
+    // must be exact. Only when the bits below them are all ones can the low
+    // word of the power change the result.
+    constexpr std::uint64_t precision_mask = ~std::uint64_t{0} >> (format::mantissa_bits + 3);
+    const uint128_parts power = eisel_lemire_power(q);
+    uint128_parts product = umul128(w, power.hi);
+    if ((product.hi & precision_mask) == precision_mask) {
+        const uint128_parts low = umul128(w, power.lo);
+        product.lo += low.hi;
+        product.hi += low.hi > product.lo ? 1 : 0;
+    }
+
+    const int upper_bit = static_cast<int>(product.hi >> 63);
+    const int shift = upper_bit + 64 - format::mantissa_bits - 3;
+    answer.mantissa = product.hi >> shift;
+    // floor(log2(10^q)) + 63, via 217706 / 2^16 ~ log2(10).
+    const int power_of_two = static_cast<int>(((152170 + 65536) * q) >> 16) + 63;
+    answer.power2 = power_of_two + upper_bit - leading_zeros - format::minimum_exponent;
+
+    if (answer.power2 <= 0) {
+        // Subnormal, or rounding up to the smallest normal.
+        if (-answer.power2 + 1 >= 64) {
+            answer.mantissa = 0;
+            answer.power2 = 0;
+            return answer;
+        }
+        answer.mantissa >>= -answer.power2 + 1;
+        answer.mantissa += answer.mantissa & 1;
+        answer.mantissa >>= 1;
+        answer.power2 = answer.mantissa < (std::uint64_t{1} << format::mantissa_bits) ? 0 : 1;
+        return answer;
+    }
+
+    // An exact halfway case, possible only for small q, rounds to even.
+    if (product.lo <= 1 && q >= format::min_round_to_even && q <= format::max_round_to_even &&
+        (answer.mantissa & 3) == 1 && (answer.mantissa << shift) == product.hi) {
+        answer.mantissa &= ~std::uint64_t{1};
+    }
+    answer.mantissa += answer.mantissa & 1;
+    answer.mantissa >>= 1;
+    if (answer.mantissa >= (std::uint64_t{2} << format::mantissa_bits)) {
+        answer.mantissa = std::uint64_t{1} << format::mantissa_bits;
+        ++answer.power2;
+    }
+    answer.mantissa &= ~(std::uint64_t{1} << format::mantissa_bits);
+    if (answer.power2 >= format::infinite_power) {
+        answer.power2 = format::infinite_power;
+        answer.mantissa = 0;
+    }
+    return answer;
+}
+
+// Case-insensitive match of the lower-case word at p.
+[[nodiscard]] inline bool starts_with_word(const char* p, const char* last, std::string_view word) noexcept {
+    if (static_cast<std::size_t>(last - p) < word.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < word.size(); ++i) {
+        if ((p[i] | 0x20) != word[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+[[nodiscard]] parse_result<F> parse_float(const char* first, const char* last) noexcept {
+    using format = binary_format<F>;
+    using bits_type = typename format::bits_type;
+    parse_result<F> result;
+    parsed_decimal number;
+    if (!parse_decimal(first, last, number)) {
+        // Only inf, infinity and nan remain; from_chars also reads nan(...).
+        const char* p = first + (first != last && *first == '-' ? 1 : 0);
+        if (starts_with_word(p, last, "inf") || starts_with_word(p, last, "nan")) {
+            const auto [end, ec] = std::from_chars(first, last, result.value);
+            result.size = static_cast<std::size_t>(end - first);
+            result.error = ec;
+            return result;
+        }
+        result.error = std::errc::invalid_argument;
+        return result;
+    }
+    result.size = static_cast<std::size_t>(number.end - first);
+
+    if (number.significand == 0 && !number.truncated) {
+        result.value = number.negative ? -F{0} : F{0};
+        return result;
+    }
+    // Clinger: both the significand and the power of ten are exact, so one
+    // correctly rounded multiply or divide gives the answer.
+    if (!number.truncated && number.exponent >= -format::max_exact_exponent &&
+        number.exponent <= format::max_exact_exponent &&
+        number.significand <= (std::uint64_t{2} << format::mantissa_bits)) {
+        F value = static_cast<F>(number.significand);
+        value = number.exponent < 0 ? value / format::exact_powers[-number.exponent]
+                                    : value * format::exact_powers[number.exponent];
+        result.value = number.negative ? -value : value;
+        return result;
+    }
+
+    adjusted_mantissa am = eisel_lemire<F>(number.exponent, number.significand);
+    if (number.truncated && am.power2 >= 0 && am != eisel_lemire<F>(number.exponent, number.significand + 1)) {
+        am.power2 = -1;
+    }
+    if (am.power2 < 0) {
+        const auto [end, ec] = std::from_chars(first, number.end, result.value);
+        result.error = ec;
+        return result;
+    }
+    if (am.power2 == format::infinite_power || (am.power2 == 0 && am.mantissa == 0)) {
+        result.error = std::errc::result_out_of_range;
+        return result;
+    }
+    const bits_type bits = static_cast<bits_type>(am.mantissa | static_cast<std::uint64_t>(am.power2)
+                                                                      << format::mantissa_bits) |
+                           (number.negative ? bits_type{1} << (sizeof(bits_type) * 8 - 1) : 0);
+    result.value = std::bit_cast<F>(bits);
+    return result;
+}
+
+[[noreturn]] inline void throw_parse_error(std::errc error, std::string_view text) {
+    if (error == std::errc::result_out_of_range) {
+        throw std::out_of_range("fl::parse: value out of range: \"" + std::string(text) + "\"");
+    }
+    throw std::invalid_argument("fl::parse: not a number: \"" + std::string(text) + "\"");
+}
+
+}  // namespace detail
+
+// Parses the number at the start of text and reports how much of it was
+// used, like std::from_chars. Never throws.
+template <parsable_number T>
+[[nodiscard]] parse_result<T> parse_prefix(std::string_view text) noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+        return detail::parse_float<T>(text.data(), text.data() + text.size());
+    } else {
+        return detail::parse_integer<T>(text.data(), text.data() + text.size());
+    }
+}
+
+template <parsable_number T, std::same_as<substring_view> View>
+[[nodiscard]] parse_result<T> parse_prefix(const View& text) noexcept {
+    return parse_prefix<T>(std::string_view(text.data(), text.size()));
+}
+
+// Parses text, which must hold exactly one number. Throws
+// std::invalid_argument if it does not, and std::out_of_range if the value
+// does not fit T.
+template <parsable_number T>
+[[nodiscard]] T parse(std::string_view text) {
+    const parse_result<T> result = parse_prefix<T>(text);
+    if (result.error != std::errc{} || result.size != text.size()) {
+        detail::throw_parse_error(result.error == std::errc{} ? std::errc::invalid_argument : result.error, text);
+    }
+    return result.value;
+}
+
+template <parsable_number T, std::same_as<substring_view> View>
+[[nodiscard]] T parse(const View& text) {
+    return parse<T>(std::string_view(text.data(), text.size()));
+}
+
+// As parse(), returning std::nullopt instead of throwing.
+template <parsable_number T>
+[[nodiscard]] std::optional<T> try_parse(std::string_view text) noexcept {
+    const parse_result<T> result = parse_prefix<T>(text);
+    if (result.error != std::errc{} || result.size != text.size()) {
+        return std::nullopt;
+    }
+    return result.value;
+}
+
+template <parsable_number T, std::same_as<substring_view> View>
+[[nodiscard]] std::optional<T> try_parse(const View& text) noexcept {
+    return try_parse<T>(std::string_view(text.data(), text.size()));
+}
+
+namespace detail {
+
+// Parses the fields of text separated by delimiter in one pass, calling
+// store(value) for each. A delimiter after the last field is allowed, and
+// with '\n' as the delimiter a '\r' before it is skipped. Returns the number
+// of fields.
+template <typename T, typename Store>
+std::size_t parse_fields(std::string_view text, char delimiter, Store&& store) {
+    const char* p = text.data();
+    const char* const last = p + text.size();
+    std::size_t count = 0;
+    while (p != last) {
+        const parse_result<T> result = parse_prefix<T>(std::string_view(p, static_cast<std::size_t>(last - p)));
+        const char* end = p + result.size;
+        if (delimiter == '\n' && end != last && *end == '\r') {
+            ++end;
+        }
+        if (result.error != std::errc{} || (end != last && *end != delimiter)) {
+            const char* field_end = std::find(p, last, delimiter);
+            throw_parse_error(result.error == std::errc{} ? std::errc::invalid_argument : result.error,
+                              std::string_view(p, static_cast<std::size_t>(field_end - p)));
+        }
+        store(result.value, count++);
+        p = end == last ? end : end + 1;
+    }
+    return count;
+}
+
+}  // namespace detail
+
+// Parses a delimited column of numbers, such as "1.5,2,-3e2" or one value
+// per line, appending each to out. A trailing delimiter is allowed; with
+// '\n' as the delimiter, CRLF line ends are accepted. Throws as parse() does
+// for the first bad field, after which out holds the fields before it.
+template <parsable_number T>
+std::size_t parse_column(std::string_view text, char delimiter, std::vector<T>& out) {
+    return detail::parse_fields<T>(text, delimiter, [&](T value, std::size_t) { out.push_back(value); });
+}
+
+// As above, storing into out. Throws std::length_error if the text has more
+// fields than out holds.
+template <parsable_number T>
+std::size_t parse_column(std::string_view text, char delimiter, std::span<T> out) {
+    return detail::parse_fields<T>(text, delimiter, [&](T value, std::size_t index) {
+        if (index == out.size()) {
+            throw std::length_error("fl::parse_column: more fields than output elements");
+        }
+        out[index] = value;
+    });
+}
+
+}  // namespace fl
+
+#endif  // FL_PARSE_HPP
@@ -16,6 +16,7 @@
 #include <compare>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 #include "fl/string.hpp"
 #include "fl/substring_view.hpp"
@@ -438,6 +439,8 @@ public:
     }
 
     rope(const string& str) noexcept;
+    // Adopts the string's storage as the single leaf, without copying.
+    rope(string&& str) noexcept;
     rope(const substring_view& view) noexcept;
 
     rope(const rope& other) noexcept = default;
@@ -662,6 +665,63 @@ public:
         return rope_linear_view(_linear_cache, std::string_view(cache));
     }
 
+    // ========== Chunk Iteration ==========
+
+    // Calls fn(std::string_view) for each leaf in order, without linearising.
+    // When fn returns bool, returning false stops the walk early. Empty leaves
+    // are skipped.
+    //
+    // Complexity: O(n) over the leaves, no allocation for trees no deeper than
+    // kRebalanceDepthThreshold.
+    template <typename Fn>
+    void for_each_chunk(Fn&& fn) const {
+        if (empty()) return;
+        auto visit = [&](const node* n) {
+            const auto& storage = static_cast<const leaf_node*>(n)->storage;
+            if (storage.empty()) return true;
+            const std::string_view chunk(storage.data(), storage.size());
+            if constexpr (std::is_same_v<std::invoke_result_t<Fn&, std::string_view>, bool>) {
+                return fn(chunk);
+            } else {
+                fn(chunk);
+                return true;
+            }
+        };
+        if (_root->is_leaf()) {
+            visit(_root.get());
+            return;
+        }
+
+        // Depth-first, left to right. A concat node pushes its right child
+        // and descends left, so the stack never exceeds the tree depth.
+        const node* inline_stack[kRebalanceDepthThreshold + 1];
+        std::vector<const node*> heap_stack;
+        const bool deep = _root->depth() > kRebalanceDepthThreshold;
+        if (deep) heap_stack.reserve(_root->depth());
+        std::size_t top = 0;
+        const node* curr = _root.get();
+        for (;;) {
+            while (!curr->is_leaf()) {
+                const auto* c = static_cast<const concat_node*>(curr);
+                if (deep) {
+                    heap_stack.push_back(c->right.get());
+                } else {
+                    inline_stack[top++] = c->right.get();
+                }
+                curr = c->left.get();
+            }
+            if (!visit(curr)) return;
+            if (deep) {
+                if (heap_stack.empty()) return;
+                curr = heap_stack.back();
+                heap_stack.pop_back();
+            } else {
+                if (top == 0) return;
+                curr = inline_stack[--top];
+            }
+        }
+    }
+
     // ========== Rebalancing ==========
 
     // Flattens and rebuilds the rope tree as a single leaf node when depth
@@ -752,6 +812,9 @@ inline rope::node_ptr rope::_make_leaf(std::string_view data) noexcept {
 inline rope::rope(const string& str) noexcept
     : rope(std::string_view(str.data(), str.size())) {}
 
+inline rope::rope(string&& str) noexcept
+    : _root(str.empty() ? nullptr : std::allocate_shared<rope::leaf_node>(rope_node_alloc{}, std::move(str))) {}
+
 inline rope::rope(const substring_view& view) noexcept
     : rope(view.data(), view.size()) {}
 
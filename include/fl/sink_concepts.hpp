@@ -0,0 +1,40 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_SINK_CONCEPTS_HPP
+#define FL_SINK_CONCEPTS_HPP
+
+// The concepts every sink-generic kernel is written against. They live apart
+// from fl/sinks.hpp so that headers below fl::string_builder (the escaping
+// kernels) can use them while the sinks themselves build on the builder.
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+namespace fl {
+
+namespace sinks {
+
+// Anything the formatting engine can write to. Only write() is required;
+// the engine uses put(char) for single characters and reserve(n) as a size
+// hint when the sink provides them.
+template <typename S>
+concept character_sink = requires(S& sink, const char* data, std::size_t len) {
+    sink.write(data, len);
+};
+
+// A sink that can hand out its own storage: prepare(n) returns at least n
+// writable characters, or an empty span when it cannot, and commit(k)
+// publishes the first k of them. Number formatting writes straight into it.
+template <typename S>
+concept direct_sink = character_sink<S> && requires(S& sink, std::size_t n) {
+    { sink.prepare(n) } -> std::same_as<std::span<char>>;
+    sink.commit(n);
+};
+
+}  // namespace sinks
+
+}  // namespace fl
+
+#endif  // FL_SINK_CONCEPTS_HPP
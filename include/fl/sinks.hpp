@@ -6,14 +6,35 @@
 
 // Output sink abstractions for directing formatted output to various
 // destinations (memory buffers, files, streams) without allocation overhead.
+//
+// The formatting engine is a template over any type modelling
+// character_sink, so a concrete sink's writes are direct calls that inline
+// rather than virtual dispatch. output_sink remains the runtime-polymorphic
+// base for code that stores or passes sinks by reference; every sink here
+// derives from it and is final, so calls on the concrete type devirtualise.
 
 #include "string.hpp"
+#include "fl/builder.hpp"
+#include "fl/sink_concepts.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <span>
+#include <system_error>
+#include <utility>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 namespace fl {
 
 namespace sinks {
@@ -21,6 +42,11 @@ namespace sinks {
 // Abstract base class for output destinations. Subclasses implement write()
 // to direct formatted output to different targets such as memory buffers,
 // files, or streams.
+//
+// A subclass that owns a buffer can also override prepare() and commit(), so
+// that output_sink models direct_sink: code holding only an output_sink&
+// then formats numbers and escapes text straight into that buffer. The
+// defaults lend nothing, and callers fall back to write().
 class output_sink {
 public:
     virtual ~output_sink() = default;
@@ -30,10 +56,28 @@ public:
     // Flushes any buffered data. The default implementation is a no-op.
     virtual void flush() {}
 
+    // Returns writable storage for at least len characters, or an empty span
+    // when the sink has none to lend. The default implementation lends none.
+    virtual std::span<char> prepare(std::size_t len) {
+        (void)len;
+        return {};
+    }
+
+    // Publishes the first len characters of the span from the last prepare().
+    virtual void commit(std::size_t len) { (void)len; }
+
     void write_char(char ch) {
         write(&ch, 1);
     }
 
+    void put(char ch) {
+        write(&ch, 1);
+    }
+
+    // Hints that about len more characters are coming. The default
+    // implementation is a no-op.
+    virtual void reserve(std::size_t len) { (void)len; }
+
     void write_string(const fl::string& str) {
         write(str.data(), str.size());
     }
@@ -47,19 +91,37 @@ public:
 
 // Writes to a caller-provided fixed-size buffer. Throws std::overflow_error
 // if data would exceed the buffer capacity.
-class buffer_sink : public output_sink {
+class buffer_sink final : public output_sink {
 public:
     buffer_sink(char* buffer, std::size_t capacity) noexcept
         : _buffer(buffer), _capacity(capacity), _written(0) {}
 
     void write(const char* data, std::size_t len) override {
-        if (_written + len > _capacity) {
+        if (len > _capacity - _written) {
             throw std::overflow_error("fl::sinks::buffer_sink: buffer overflow");
         }
         std::memcpy(_buffer + _written, data, len);
         _written += len;
     }
 
+    void put(char ch) {
+        if (_written == _capacity) {
+            throw std::overflow_error("fl::sinks::buffer_sink: buffer overflow");
+        }
+        _buffer[_written++] = ch;
+    }
+
+    // Returns the unused tail of the buffer when it has room for len
+    // characters, otherwise an empty span.
+    std::span<char> prepare(std::size_t len) noexcept override {
+        if (len > _capacity - _written) {
+            return {};
+        }
+        return {_buffer + _written, _capacity - _written};
+    }
+
+    void commit(std::size_t len) noexcept override { _written += len; }
+
     std::size_t written() const noexcept { return _written; }
     std::size_t available() const noexcept { return _capacity - _written; }
 
@@ -83,7 +145,7 @@ private:
 // Writes to a C FILE handle. When constructed with a filename the sink owns
 // the handle and closes it on destruction. When constructed with an existing
 // FILE pointer, ownership is controlled by the caller via the owns flag.
-class file_sink : public output_sink {
+class file_sink final : public output_sink {
 public:
     explicit file_sink(const char* filename, bool append = false)
         : _file(nullptr), _owns_file(true) {
@@ -126,8 +188,152 @@ private:
     bool _owns_file;
 };
 
+#if !defined(_WIN32)
+// Writes to a POSIX file descriptor through its own buffer, bypassing stdio.
+//
+// Small writes are copied into the buffer. A write that does not fit is sent
+// together with the buffered bytes in one writev(), so output reaches the
+// kernel in calls of at least a buffer's size and large writes are never
+// copied. Short writes are resumed, EINTR is retried, and a non-blocking
+// descriptor is waited on with poll(). Failures throw std::system_error
+// carrying errno; the buffered bytes are then discarded.
+//
+// Buffers of 64 KB to 1 MB suit bulk output. flush() empties the buffer to
+// the descriptor; it does not fsync(). The destructor flushes, ignoring
+// errors, and closes the descriptor if the sink owns it.
+class fd_sink final : public output_sink {
+public:
+    static constexpr std::size_t default_buffer_size = 64 * 1024;
+
+    explicit fd_sink(int fd, std::size_t buffer_size = default_buffer_size, bool owns = false)
+        : _fd(fd), _owns_fd(owns), _capacity(std::max<std::size_t>(buffer_size, 1)),
+          _buffer(std::make_unique_for_overwrite<char[]>(_capacity)) {}
+
+    // Opens (creating or truncating, or appending) filename and owns the
+    // descriptor. The buffer is allocated first, so a failed allocation
+    // cannot leak the descriptor.
+    explicit fd_sink(const char* filename, bool append = false, std::size_t buffer_size = default_buffer_size)
+        : fd_sink(-1, buffer_size, false) {
+        _fd = _open(filename, append);
+        _owns_fd = true;
+    }
+
+    fd_sink(const fd_sink&) = delete;
+    fd_sink& operator=(const fd_sink&) = delete;
+
+    ~fd_sink() noexcept override {
+        try {
+            flush();
+        } catch (...) {
+        }
+        if (_owns_fd) {
+            ::close(_fd);
+        }
+    }
+
+    void write(const char* data, std::size_t len) override {
+        if (len <= _capacity - _size) {
+            std::memcpy(_buffer.get() + _size, data, len);
+            _size += len;
+            return;
+        }
+        iovec segments[2] = {{_buffer.get(), _size}, {const_cast<char*>(data), len}};
+        _size = 0;
+        _write_all(segments, 2);
+    }
+
+    void put(char ch) {
+        if (_size == _capacity) {
+            flush();
+        }
+        _buffer[_size++] = ch;
+    }
+
+    // Returns the free tail of the buffer when it can hold len characters,
+    // flushing first if needed; an empty span when len exceeds the buffer.
+    std::span<char> prepare(std::size_t len) override {
+        if (len > _capacity - _size) {
+            if (len > _capacity) {
+                return {};
+            }
+            flush();
+        }
+        return {_buffer.get() + _size, _capacity - _size};
+    }
+
+    void commit(std::size_t len) noexcept override { _size += len; }
+
+    void flush() override {
+        if (_size != 0) {
+            iovec segment{_buffer.get(), _size};
+            _size = 0;
+            _write_all(&segment, 1);
+        }
+    }
+
+    int fd() const noexcept { return _fd; }
+    std::size_t buffer_size() const noexcept { return _capacity; }
+    std::size_t buffered() const noexcept { return _size; }
+
+    // Characters handed to the kernel so far.
+    std::size_t bytes_written() const noexcept { return _written; }
+
+private:
+    static int _open(const char* filename, bool append) {
+        const int fd = ::open(filename, O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    std::string("fl::sinks::fd_sink: cannot open file: ") + filename);
+        }
+        return fd;
+    }
+
+    // Writes every byte of the segments, resuming after short writes.
+    void _write_all(iovec* segments, int count) {
+        while (count != 0) {
+            if (segments->iov_len == 0) {
+                ++segments;
+                --count;
+                continue;
+            }
+            const ssize_t done = count == 1 ? ::write(_fd, segments->iov_base, segments->iov_len)
+                                            : ::writev(_fd, segments, count);
+            if (done < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    pollfd waiter{_fd, POLLOUT, 0};
+                    ::poll(&waiter, 1, -1);
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "fl::sinks::fd_sink: write failed");
+            }
+            _written += static_cast<std::size_t>(done);
+            for (std::size_t left = static_cast<std::size_t>(done); left != 0;) {
+                const std::size_t step = std::min(left, segments->iov_len);
+                segments->iov_base = static_cast<char*>(segments->iov_base) + step;
+                segments->iov_len -= step;
+                left -= step;
+                if (segments->iov_len == 0) {
+                    ++segments;
+                    --count;
+                }
+            }
+        }
+    }
+
+    int _fd;
+    bool _owns_fd;
+    std::size_t _capacity;
+    std::unique_ptr<char[]> _buffer;
+    std::size_t _size = 0;
+    std::size_t _written = 0;
+};
+#endif
+
 // Writes to a std::ostream reference.
-class stream_sink : public output_sink {
+class stream_sink final : public output_sink {
 public:
     explicit stream_sink(std::ostream& stream) noexcept : _stream(stream) {}
 
@@ -143,50 +349,52 @@ private:
     std::ostream& _stream;
 };
 
-// Writes to an automatically growing std::vector<char> buffer. Useful when
-// the total output size is not known in advance.
-class growing_sink : public output_sink {
+// Writes into a buffer that grows as needed. The buffer is an
+// fl::string_builder, so take() hands it to an fl::string without copying,
+// and fl::rope(sink.take()) makes it a rope leaf the same way.
+class growing_sink final : public output_sink {
 public:
-    explicit growing_sink(std::size_t initial_capacity = 256) : _buffer(), _written(0) {
-        _buffer.reserve(initial_capacity);
-    }
+    explicit growing_sink(std::size_t initial_capacity = 256) : _builder(initial_capacity) {}
 
-    void write(const char* data, std::size_t len) override {
-        _buffer.insert(_buffer.end(), data, data + len);
-        _written += len;
-    }
+    void write(const char* data, std::size_t len) override { _builder.append(data, len); }
+
+    void put(char ch) { _builder.append(ch); }
+
+    void reserve(std::size_t len) override { (void)_builder.prepare(len); }
+
+    // Lends all the spare capacity, growing it to at least len characters.
+    std::span<char> prepare(std::size_t len) override { return _builder.prepare(len); }
+
+    void commit(std::size_t len) noexcept override { _builder.commit(len); }
 
     // Null-terminates the buffer without affecting the reported size.
-    void null_terminate() {
-        if (_buffer.size() <= _written) {
-            _buffer.resize(_written + 1);
-        }
-        _buffer[_written] = '\0';
-    }
+    void null_terminate() { _builder.prepare(1)[0] = '\0'; }
 
-    fl::string to_fl_string() const {
-        return fl::string(_buffer.data(), _buffer.size());
-    }
+    // Copies the output; the sink keeps it.
+    fl::string to_fl_string() const { return fl::string(_builder.data(), _builder.size()); }
 
-    const std::vector<char>& buffer() const noexcept { return _buffer; }
-    std::vector<char>& buffer() noexcept { return _buffer; }
+    // Moves the output into an fl::string and leaves the sink empty, without
+    // a buffer. Output too long for the small-string buffer is not copied.
+    [[nodiscard]] fl::string take() noexcept { return std::exchange(_builder, fl::string_builder()).build(); }
 
-    std::size_t size() const noexcept { return _written; }
-    const char* data() const noexcept { return _buffer.data(); }
+    // Discards everything written after the first len characters.
+    void truncate(std::size_t len) noexcept { _builder.truncate(len); }
 
-    void reset() noexcept {
-        _buffer.clear();
-        _written = 0;
-    }
+    const fl::string_builder& builder() const noexcept { return _builder; }
+    fl::string_builder& builder() noexcept { return _builder; }
+
+    std::size_t size() const noexcept { return _builder.size(); }
+    const char* data() const noexcept { return _builder.data(); }
+
+    void reset() noexcept { _builder.clear(); }
 
 private:
-    std::vector<char> _buffer;
-    std::size_t _written;
+    fl::string_builder _builder;
 };
 
 // Discards all output. Useful for benchmarking formatting overhead without
 // any I/O cost.
-class null_sink : public output_sink {
+class null_sink final : public output_sink {
 public:
     null_sink() noexcept : _written(0) {}
 
@@ -195,6 +403,11 @@ public:
         _written += len;
     }
 
+    void put(char ch) noexcept {
+        (void)ch;
+        ++_written;
+    }
+
     std::size_t bytes_written() const noexcept { return _written; }
 
     void reset() noexcept { _written = 0; }
@@ -205,7 +418,7 @@ private:
 
 // Fans out writes to multiple sinks simultaneously, allowing output to be
 // directed to several destinations at once.
-class multi_sink : public output_sink {
+class multi_sink final : public output_sink {
 public:
     multi_sink() : _sinks() {}
 
@@ -242,6 +455,13 @@ inline std::shared_ptr<sinks::file_sink> make_file_sink(const char* filename, bo
     return std::make_shared<sinks::file_sink>(filename, append);
 }
 
+#if !defined(_WIN32)
+inline std::shared_ptr<sinks::fd_sink> make_fd_sink(const char* filename, bool append = false,
+                                                    std::size_t buffer_size = sinks::fd_sink::default_buffer_size) {
+    return std::make_shared<sinks::fd_sink>(filename, append, buffer_size);
+}
+#endif
+
 inline std::shared_ptr<sinks::stream_sink> make_stream_sink(std::ostream& stream) noexcept {
     return std::make_shared<sinks::stream_sink>(stream);
 }
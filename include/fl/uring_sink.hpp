@@ -0,0 +1,467 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_URING_SINK_HPP
+#define FL_URING_SINK_HPP
+
+// A file sink that writes through io_uring (Linux 5.6 or later), so the
+// writing thread queues each full buffer and carries on instead of waiting
+// in write().
+//
+// The sink owns queue_depth + 1 buffers, registered with the ring when the
+// kernel allows it. One is filled while up to queue_depth full ones are
+// being written; a buffer is reused, in turn, once its write has completed.
+// Writes to a regular file go to explicit offsets, so several can be in
+// flight and still land in order. Pipes, sockets and O_APPEND descriptors
+// have one write in flight at a time.
+//
+// The ring is set up with raw system calls; liburing is not needed. When
+// io_uring is unavailable at run time (an older kernel, io_uring disabled by
+// sysctl or a seccomp filter), or options.io_uring is false, the sink writes
+// through an fd_sink instead, with the same results.
+//
+// Not included by fl.hpp.
+
+#include "fl/sinks.hpp"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace fl {
+namespace sinks {
+
+struct uring_options {
+    // Bytes per buffer.
+    std::size_t buffer_size = 256 * 1024;
+    // Full buffers being written at once.
+    unsigned queue_depth = 4;
+    // Set to false to use write() even where io_uring is available.
+    bool io_uring = true;
+};
+
+// Writes to a POSIX file descriptor through io_uring, falling back to an
+// fd_sink. Failures throw std::system_error carrying the error code; the
+// bytes of the failed write are then discarded. flush() waits for every
+// write to complete; it does not fsync(). The destructor flushes, ignoring
+// errors, and closes the descriptor if the sink owns it.
+class uring_sink final : public output_sink {
+public:
+    explicit uring_sink(int fd, uring_options opts = {}, bool owns = false)
+        : _fd(fd),
+          _owns_fd(owns),
+          _capacity(std::clamp<std::size_t>(opts.buffer_size, 1, std::size_t{1} << 30)),
+          _depth(std::clamp(opts.queue_depth, 1u, 256u)) {
+        try {
+            if (!opts.io_uring || !_setup()) {
+                _teardown();
+                _fallback = std::make_unique<fd_sink>(fd, _capacity);
+            }
+        } catch (...) {
+            // The destructor will not run; an owned descriptor, such as one
+            // the filename constructor opened, is closed here.
+            if (owns) {
+                ::close(fd);
+            }
+            throw;
+        }
+    }
+
+    // Opens (creating or truncating, or appending) filename and owns the
+    // descriptor. Appending seeks to the end once rather than using
+    // O_APPEND, so several writes can be in flight.
+    explicit uring_sink(const char* filename, bool append = false, uring_options opts = {})
+        : uring_sink(_open(filename, append), opts, true) {}
+
+    uring_sink(const uring_sink&) = delete;
+    uring_sink& operator=(const uring_sink&) = delete;
+
+    ~uring_sink() noexcept override {
+        try {
+            flush();
+        } catch (...) {
+        }
+        try {
+            while (_in_flight != 0) {
+                _reap(true);
+            }
+        } catch (...) {
+        }
+        _fallback.reset();
+        _teardown();
+        if (_owns_fd) {
+            ::close(_fd);
+        }
+    }
+
+    void write(const char* data, std::size_t len) override {
+        if (_fallback) {
+            _fallback->write(data, len);
+            return;
+        }
+        while (len > _capacity - _size) {
+            const std::size_t part = _capacity - _size;
+            std::memcpy(_buffer(_current) + _size, data, part);
+            _size += part;
+            data += part;
+            len -= part;
+            _submit_current();
+        }
+        std::memcpy(_buffer(_current) + _size, data, len);
+        _size += len;
+    }
+
+    void put(char ch) {
+        if (_fallback) {
+            _fallback->put(ch);
+            return;
+        }
+        if (_size == _capacity) {
+            _submit_current();
+        }
+        _buffer(_current)[_size++] = ch;
+    }
+
+    // Returns the free tail of the current buffer when it can hold len
+    // characters, queueing the buffer first if needed; an empty span when len
+    // exceeds the buffer.
+    std::span<char> prepare(std::size_t len) override {
+        if (_fallback) {
+            return _fallback->prepare(len);
+        }
+        if (len > _capacity - _size) {
+            if (len > _capacity) {
+                return {};
+            }
+            _submit_current();
+        }
+        return {_buffer(_current) + _size, _capacity - _size};
+    }
+
+    void commit(std::size_t len) noexcept override {
+        if (_fallback) {
+            _fallback->commit(len);
+            return;
+        }
+        _size += len;
+    }
+
+    // Queues the current buffer and waits for every write to complete.
+    void flush() override {
+        if (_fallback) {
+            _fallback->flush();
+            return;
+        }
+        if (_size != 0) {
+            _submit_current();
+        }
+        while (_in_flight != 0) {
+            _reap(true);
+        }
+        _throw_error();
+        if (!_serial) {
+            // Writes at explicit offsets leave the descriptor's position
+            // alone; move it past them for anyone writing to it next.
+            ::lseek(_fd, static_cast<off_t>(_offset), SEEK_SET);
+        }
+    }
+
+    // Whether writes go through io_uring rather than the write() fallback.
+    bool uses_io_uring() const noexcept { return !_fallback; }
+    // Whether the buffers are registered with the ring (IORING_OP_WRITE_FIXED).
+    bool registered_buffers() const noexcept { return _registered; }
+
+    int fd() const noexcept { return _fd; }
+    std::size_t buffer_size() const noexcept { return _capacity; }
+
+    // Characters the kernel has completed writing so far.
+    std::size_t bytes_written() const noexcept {
+        return _fallback ? _fallback->bytes_written() : _written;
+    }
+
+private:
+    struct slot {
+        std::uint64_t offset = 0;
+        std::size_t size = 0;
+        std::size_t done = 0;
+        bool in_flight = false;
+    };
+
+    static int _open(const char* filename, bool append) {
+        const int fd = ::open(filename, O_WRONLY | O_CREAT | O_CLOEXEC | (append ? 0 : O_TRUNC), 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    std::string("fl::sinks::uring_sink: cannot open file: ") + filename);
+        }
+        if (append) {
+            ::lseek(fd, 0, SEEK_END);
+        }
+        return fd;
+    }
+
+    template <typename T>
+    static std::atomic_ref<T> _shared(T* at) noexcept {
+        return std::atomic_ref<T>(*at);
+    }
+
+    // Creates and maps the ring and registers the buffers. False when
+    // io_uring cannot be used, leaving the caller to fall back.
+    bool _setup() {
+        io_uring_params params{};
+        const long ring = ::syscall(__NR_io_uring_setup, _depth, &params);
+        if (ring < 0) {
+            return false;
+        }
+        _ring_fd = static_cast<int>(ring);
+        // The destructor does not run when the constructor throws, so an
+        // allocation failing below must release the ring here.
+        struct teardown_guard {
+            uring_sink* sink;
+            ~teardown_guard() {
+                if (sink) {
+                    sink->_teardown();
+                }
+            }
+        } guard{this};
+        // IORING_FEAT_RW_CUR_POS arrived in 5.6 together with IORING_OP_WRITE.
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            return false;
+        }
+        _sq_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+        _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+        }
+        _sq_ring = _map(_sq_size, IORING_OFF_SQ_RING);
+        _cq_ring = single ? _sq_ring : _map(_cq_size, IORING_OFF_CQ_RING);
+        _sqe_size = params.sq_entries * sizeof(io_uring_sqe);
+        _sqes = static_cast<io_uring_sqe*>(_map(_sqe_size, IORING_OFF_SQES));
+        if (!_sq_ring || !_cq_ring || !_sqes) {
+            return false;
+        }
+        char* const sq = static_cast<char*>(_sq_ring);
+        char* const cq = static_cast<char*>(_cq_ring);
+        _sq_tail = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.tail);
+        _sq_mask = *reinterpret_cast<std::uint32_t*>(sq + params.sq_off.ring_mask);
+        _sq_array = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.array);
+        _cq_head = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.head);
+        _cq_tail = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.tail);
+        _cq_mask = *reinterpret_cast<std::uint32_t*>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        _storage = std::make_unique_for_overwrite<char[]>(_capacity * (_depth + 1));
+        _slots.resize(_depth + 1);
+        std::vector<iovec> buffers(_depth + 1);
+        for (std::size_t i = 0; i <= _depth; ++i) {
+            buffers[i] = {_buffer(i), _capacity};
+        }
+        // Registration pins the pages; older kernels count that against
+        // RLIMIT_MEMLOCK and may refuse, in which case plain writes are used.
+        _registered = ::syscall(__NR_io_uring_register, _ring_fd, IORING_REGISTER_BUFFERS, buffers.data(),
+                                static_cast<unsigned>(buffers.size())) == 0;
+
+        // One write at a time where offsets cannot be chosen.
+        const off_t position = ::lseek(_fd, 0, SEEK_CUR);
+        const int flags = ::fcntl(_fd, F_GETFL);
+        _serial = position < 0 || flags < 0 || (flags & O_APPEND) != 0;
+        _offset = _serial ? 0 : static_cast<std::uint64_t>(position);
+        guard.sink = nullptr;
+        return true;
+    }
+
+    void* _map(std::size_t size, std::uint64_t offset) const noexcept {
+        void* const at = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                                static_cast<off_t>(offset));
+        return at == MAP_FAILED ? nullptr : at;
+    }
+
+    void _teardown() noexcept {
+        if (_sqes) {
+            ::munmap(_sqes, _sqe_size);
+        }
+        if (_cq_ring && _cq_ring != _sq_ring) {
+            ::munmap(_cq_ring, _cq_size);
+        }
+        if (_sq_ring) {
+            ::munmap(_sq_ring, _sq_size);
+        }
+        _sqes = nullptr;
+        _sq_ring = _cq_ring = nullptr;
+        if (_ring_fd >= 0) {
+            ::close(_ring_fd);
+            _ring_fd = -1;
+        }
+    }
+
+    char* _buffer(std::size_t index) const noexcept { return _storage.get() + index * _capacity; }
+
+    // Queues the current buffer and moves on to the next, waiting for its
+    // earlier write to complete if it is still in flight. In serial mode the
+    // previous write must complete before this one is queued.
+    void _submit_current() {
+        while (_serial && _in_flight != 0) {
+            _reap(true);
+        }
+        _slots[_current] = {_offset, _size, 0, true};
+        try {
+            _submit(_current);
+        } catch (...) {
+            // Not queued: the bytes stay in the current buffer for a retry.
+            _slots[_current].in_flight = false;
+            throw;
+        }
+        _offset += _size;
+        _size = 0;
+        ++_in_flight;
+        _current = _current == _depth ? 0 : _current + 1;
+        while (_slots[_current].in_flight) {
+            _reap(true);
+        }
+        _throw_error();
+    }
+
+    // Throws the first write error recorded by _reap(), once.
+    void _throw_error() {
+        if (_error != 0) {
+            const int error = std::exchange(_error, 0);
+            throw std::system_error(error, std::generic_category(), "fl::sinks::uring_sink: write failed");
+        }
+    }
+
+    // Queues the unwritten rest of buffer index. If io_uring_enter() fails
+    // nothing was submitted, so the entry is taken back before rethrowing.
+    void _submit(std::size_t index) {
+        const slot& s = _slots[index];
+        const std::uint32_t tail = *_sq_tail;
+        const std::uint32_t at = tail & _sq_mask;
+        io_uring_sqe& entry = _sqes[at];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.opcode = _registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        entry.fd = _fd;
+        entry.addr = reinterpret_cast<std::uint64_t>(_buffer(index) + s.done);
+        entry.len = static_cast<std::uint32_t>(s.size - s.done);
+        entry.off = _serial ? ~std::uint64_t{0} : s.offset + s.done;
+        entry.buf_index = static_cast<std::uint16_t>(_registered ? index : 0);
+        entry.user_data = index;
+        _sq_array[at] = at;
+        _shared(_sq_tail).store(tail + 1, std::memory_order_release);
+        try {
+            _enter(1, 0, 0);
+        } catch (...) {
+            _shared(_sq_tail).store(tail, std::memory_order_release);
+            throw;
+        }
+    }
+
+    void _enter(unsigned submit, unsigned wait, unsigned flags) {
+        while (::syscall(__NR_io_uring_enter, _ring_fd, submit, wait, flags, nullptr, 0) < 0) {
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(), "fl::sinks::uring_sink: io_uring_enter failed");
+            }
+        }
+    }
+
+    // Handles the completions posted so far, first waiting for one when wait
+    // is set. A short write is queued again for the rest of its buffer; a
+    // failed one is recorded for _throw_error() and its buffer freed.
+    void _reap(bool wait) {
+        std::uint32_t head = *_cq_head;
+        std::uint32_t tail = _shared(_cq_tail).load(std::memory_order_acquire);
+        if (head == tail && wait) {
+            _enter(0, 1, IORING_ENTER_GETEVENTS);
+            tail = _shared(_cq_tail).load(std::memory_order_acquire);
+        }
+        std::vector<std::size_t> resubmit;
+        for (; head != tail; ++head) {
+            const io_uring_cqe& completion = _cqes[head & _cq_mask];
+            const auto index = static_cast<std::size_t>(completion.user_data);
+            slot& s = _slots[index];
+            if (completion.res < 0 || (completion.res == 0 && s.size != s.done)) {
+                _error = _error != 0 ? _error : (completion.res < 0 ? -completion.res : EIO);
+                s.in_flight = false;
+                --_in_flight;
+                continue;
+            }
+            s.done += static_cast<std::size_t>(completion.res);
+            _written += static_cast<std::size_t>(completion.res);
+            if (s.done < s.size) {
+                resubmit.push_back(index);
+            } else {
+                s.in_flight = false;
+                --_in_flight;
+            }
+        }
+        _shared(_cq_head).store(head, std::memory_order_release);
+        for (std::size_t i = 0; i < resubmit.size(); ++i) {
+            try {
+                _submit(resubmit[i]);
+            } catch (...) {
+                // The rest of these writes is lost; they are no longer in
+                // flight, so the destructor does not wait for them.
+                for (; i < resubmit.size(); ++i) {
+                    _slots[resubmit[i]].in_flight = false;
+                    --_in_flight;
+                }
+                throw;
+            }
+        }
+    }
+
+    int _fd;
+    bool _owns_fd;
+    std::size_t _capacity;
+    unsigned _depth;
+    std::unique_ptr<fd_sink> _fallback;
+
+    int _ring_fd = -1;
+    void* _sq_ring = nullptr;
+    void* _cq_ring = nullptr;
+    io_uring_sqe* _sqes = nullptr;
+    std::size_t _sq_size = 0;
+    std::size_t _cq_size = 0;
+    std::size_t _sqe_size = 0;
+    std::uint32_t* _sq_tail = nullptr;
+    std::uint32_t* _sq_array = nullptr;
+    std::uint32_t _sq_mask = 0;
+    std::uint32_t* _cq_head = nullptr;
+    std::uint32_t* _cq_tail = nullptr;
+    std::uint32_t _cq_mask = 0;
+    io_uring_cqe* _cqes = nullptr;
+    bool _registered = false;
+    bool _serial = false;
+
+    std::unique_ptr<char[]> _storage;
+    std::vector<slot> _slots;
+    std::size_t _current = 0;
+    std::size_t _size = 0;
+    std::size_t _in_flight = 0;
+    std::uint64_t _offset = 0;
+    std::size_t _written = 0;
+    int _error = 0;
+};
+
+}  // namespace sinks
+}  // namespace fl
+
+#endif  // defined(__linux__)
+
+#endif  // FL_URING_SINK_HPP
@@ -0,0 +1,908 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_UTF8_HPP
+#define FL_UTF8_HPP
+
+// UTF-8 validation, code point counting and iteration over fl::string,
+// substring_view and rope chunks.
+//
+// Validation follows the lookup algorithm of Keiser and Lemire (simdutf):
+// every byte is classified by three 16-entry table shuffles, on the high
+// and low nibbles of the previous byte and the high nibble of the current
+// one, whose AND is non-zero exactly for a two-byte error (overlong form,
+// surrogate, value above U+10FFFF, missing or surplus continuation). A
+// second check marks the bytes that must be the third or fourth of a
+// sequence. Blocks of pure ASCII skip both steps. With AVX2 a block is 32
+// bytes, with SSSE3 two 16-byte halves; other targets use a byte-wise state
+// machine. Well-formed means RFC 3629: shortest form, no surrogates, at most
+// U+10FFFF.
+
+#include "fl/rope.hpp"
+#include "fl/sinks.hpp"
+#include "fl/string.hpp"
+#include "fl/substring_view.hpp"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSSE3__) && !defined(__AVX2__)
+#include <tmmintrin.h>
+#endif
+
+namespace fl {
+
+namespace detail {
+
+// For a lead byte, the number of continuation bytes that follow it and the
+// range allowed for the first of them, which excludes overlong forms,
+// surrogates and values above U+10FFFF. Returns false for a byte that
+// cannot start a multi-byte sequence.
+[[nodiscard]] constexpr bool utf8_lead_info(unsigned char lead, int& continuations, unsigned char& lower,
+                                            unsigned char& upper) noexcept {
+    lower = 0x80;
+    upper = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        continuations = 1;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        continuations = 2;
+        lower = lead == 0xE0 ? 0xA0 : 0x80;
+        upper = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        continuations = 3;
+        lower = lead == 0xF0 ? 0x90 : 0x80;
+        upper = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Length of the well-formed sequence at p (1 to 4), 0 if the bytes at p do
+// not start one, or -1 if they start one that last cuts short.
+[[nodiscard]] inline int utf8_sequence_length(const char* p, const char* last) noexcept {
+    const unsigned char lead = static_cast<unsigned char>(*p);
+    if (lead < 0x80) {
+        return 1;
+    }
+    int continuations = 0;
+    unsigned char lower = 0;
+    unsigned char upper = 0;
+    if (!utf8_lead_info(lead, continuations, lower, upper)) {
+        return 0;
+    }
+    for (int i = 1; i <= continuations; ++i) {
+        if (p + i == last) {
+            return -1;
+        }
+        const unsigned char c = static_cast<unsigned char>(p[i]);
+        if (c < lower || c > upper) {
+            return 0;
+        }
+        lower = 0x80;
+        upper = 0xBF;
+    }
+    return continuations + 1;
+}
+
+// Code point of the well-formed sequence of the given length at p.
+[[nodiscard]] inline char32_t utf8_decode(const char* p, int length) noexcept {
+    const auto byte = [p](int i) { return static_cast<char32_t>(static_cast<unsigned char>(p[i])); };
+    switch (length) {
+    case 1:
+        return byte(0);
+    case 2:
+        return (byte(0) & 0x1F) << 6 | (byte(1) & 0x3F);
+    case 3:
+        return (byte(0) & 0x0F) << 12 | (byte(1) & 0x3F) << 6 | (byte(2) & 0x3F);
+    default:
+        return (byte(0) & 0x07) << 18 | (byte(1) & 0x3F) << 12 | (byte(2) & 0x3F) << 6 | (byte(3) & 0x3F);
+    }
+}
+
+// Start of the first ill-formed or truncated sequence in [p, last), or last.
+// Runs of ASCII are skipped eight bytes at a time.
+[[nodiscard]] inline const char* utf8_find_invalid_scalar(const char* p, const char* last) noexcept {
+    while (p != last) {
+        if (last - p >= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if ((word & 0x8080808080808080) == 0) {
+                p += 8;
+                continue;
+            }
+        }
+        const int length = utf8_sequence_length(p, last);
+        if (length <= 0) {
+            return p;
+        }
+        p += length;
+    }
+    return last;
+}
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+// Error classes of the lookup algorithm. Each table entry holds the errors
+// its nibble is compatible with; a byte pair is in error when all three
+// lookups agree on at least one class.
+inline constexpr std::uint8_t utf8_too_short = 1 << 0;     // Lead not followed by a continuation.
+inline constexpr std::uint8_t utf8_too_long = 1 << 1;      // ASCII followed by a continuation.
+inline constexpr std::uint8_t utf8_overlong_3 = 1 << 2;    // E0 80..9F
+inline constexpr std::uint8_t utf8_too_large = 1 << 3;     // F4 90..BF, F5..FF
+inline constexpr std::uint8_t utf8_surrogate = 1 << 4;     // ED A0..BF
+inline constexpr std::uint8_t utf8_overlong_2 = 1 << 5;    // C0, C1
+inline constexpr std::uint8_t utf8_too_large_1000 = 1 << 6;
+inline constexpr std::uint8_t utf8_overlong_4 = 1 << 6;    // F0 80..8F
+inline constexpr std::uint8_t utf8_two_continuations = 1 << 7;
+inline constexpr std::uint8_t utf8_carry = utf8_too_short | utf8_too_long | utf8_two_continuations;
+
+// Indexed by the high nibble of the previous byte.
+alignas(16) inline constexpr std::uint8_t utf8_byte_1_high[16] = {
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+    utf8_two_continuations, utf8_two_continuations, utf8_two_continuations, utf8_two_continuations,
+    utf8_too_short | utf8_overlong_2,
+    utf8_too_short,
+    utf8_too_short | utf8_overlong_3 | utf8_surrogate,
+    utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4,
+};
+
+// Indexed by the low nibble of the previous byte.
+alignas(16) inline constexpr std::uint8_t utf8_byte_1_low[16] = {
+    utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4,
+    utf8_carry | utf8_overlong_2,
+    utf8_carry,
+    utf8_carry,
+    utf8_carry | utf8_too_large,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+};
+
+// Indexed by the high nibble of the current byte.
+alignas(16) inline constexpr std::uint8_t utf8_byte_2_high[16] = {
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+    utf8_too_long | utf8_overlong_2 | utf8_two_continuations | utf8_overlong_3 | utf8_too_large_1000 | utf8_overlong_4,
+    utf8_too_long | utf8_overlong_2 | utf8_two_continuations | utf8_overlong_3 | utf8_too_large,
+    utf8_too_long | utf8_overlong_2 | utf8_two_continuations | utf8_surrogate | utf8_too_large,
+    utf8_too_long | utf8_overlong_2 | utf8_two_continuations | utf8_surrogate | utf8_too_large,
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+};
+
+// A block ends inside a sequence when one of its last three bytes is a lead
+// byte with more continuations than the block has room for. Subtracting
+// these limits with saturation leaves non-zero bytes exactly there; the
+// 16-byte form uses the second half.
+alignas(32) inline constexpr std::uint8_t utf8_incomplete_limits[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+#endif
+
+// Validates a stream of 32-byte blocks. has_errors() reports an error seen so
+// far; valid() also requires that the last block did not end inside a
+// sequence.
+#if defined(__AVX2__)
+struct utf8_checker {
+    __m256i error = _mm256_setzero_si256();
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+
+    void check(const char* block) noexcept {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, prev_incomplete);
+            prev_incomplete = _mm256_setzero_si256();
+        } else {
+            const auto table = [](const std::uint8_t* values) {
+                return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(values)));
+            };
+            // The input shifted back by one to three bytes, the gap filled
+            // from the end of the previous block.
+            const __m256i carried = _mm256_permute2x128_si256(prev_input, input, 0x21);
+            const __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+            const __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+            const __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+            const __m256i special = _mm256_and_si256(
+                _mm256_and_si256(
+                    _mm256_shuffle_epi8(table(utf8_byte_1_high),
+                                        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                    _mm256_shuffle_epi8(table(utf8_byte_1_low), _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(table(utf8_byte_2_high), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+            // Bytes two after a three- or four-byte lead, or three after a
+            // four-byte lead, must be continuations. The table lookups flag
+            // a continuation after a continuation, so the two marks cancel
+            // exactly where the sequence expects one.
+            const __m256i must_continue =
+                _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+            error = _mm256_or_si256(
+                error, _mm256_xor_si256(_mm256_and_si256(must_continue, _mm256_set1_epi8(static_cast<char>(0x80))),
+                                        special));
+            prev_incomplete = _mm256_subs_epu8(
+                input, _mm256_load_si256(reinterpret_cast<const __m256i*>(utf8_incomplete_limits)));
+        }
+        prev_input = input;
+    }
+
+    [[nodiscard]] bool has_errors() const noexcept { return !_mm256_testz_si256(error, error); }
+
+    [[nodiscard]] bool valid() const noexcept {
+        const __m256i any = _mm256_or_si256(error, prev_incomplete);
+        return _mm256_testz_si256(any, any);
+    }
+};
+#elif defined(__SSSE3__)
+struct utf8_checker {
+    __m128i error = _mm_setzero_si128();
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+
+    void check(const char* block) noexcept {
+        check_half(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)));
+        check_half(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)));
+    }
+
+    // The 16-byte form of the AVX2 checker above.
+    void check_half(__m128i input) noexcept {
+        if (_mm_movemask_epi8(input) == 0) {
+            error = _mm_or_si128(error, prev_incomplete);
+            prev_incomplete = _mm_setzero_si128();
+        } else {
+            const auto table = [](const std::uint8_t* values) {
+                return _mm_load_si128(reinterpret_cast<const __m128i*>(values));
+            };
+            const __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+            const __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+            const __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            const __m128i special = _mm_and_si128(
+                _mm_and_si128(
+                    _mm_shuffle_epi8(table(utf8_byte_1_high), _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                    _mm_shuffle_epi8(table(utf8_byte_1_low), _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(table(utf8_byte_2_high), _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+            const __m128i must_continue =
+                _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                             _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+            error = _mm_or_si128(
+                error, _mm_xor_si128(_mm_and_si128(must_continue, _mm_set1_epi8(static_cast<char>(0x80))), special));
+            prev_incomplete = _mm_subs_epu8(input, table(utf8_incomplete_limits + 16));
+        }
+        prev_input = input;
+    }
+
+    [[nodiscard]] bool has_errors() const noexcept {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF;
+    }
+
+    [[nodiscard]] bool valid() const noexcept {
+        const __m128i any = _mm_or_si128(error, prev_incomplete);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xFFFF;
+    }
+};
+#else
+struct utf8_checker {
+    bool failed = false;
+    int remaining = 0;  // Continuation bytes still expected.
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+
+    void check(const char* block) noexcept {
+        for (int i = 0; i < 32; ++i) {
+            const unsigned char c = static_cast<unsigned char>(block[i]);
+            if (remaining != 0) {
+                failed = failed || c < lower || c > upper;
+                lower = 0x80;
+                upper = 0xBF;
+                --remaining;
+            } else if (c >= 0x80) {
+                failed = failed || !utf8_lead_info(c, remaining, lower, upper);
+            }
+        }
+    }
+
+    [[nodiscard]] bool has_errors() const noexcept { return failed; }
+    [[nodiscard]] bool valid() const noexcept { return !failed && remaining == 0; }
+};
+#endif
+
+// Counts the code points of [p, last), plus the four-byte lead bytes when
+// FourByteLeads is set: the UTF-16 length, as each of those becomes a
+// surrogate pair. Per-byte counters are decremented (a match compares as
+// -1) for up to 127 blocks, then summed into 64-bit lanes.
+template <bool FourByteLeads>
+[[nodiscard]] std::size_t utf8_count_units(const char* p, const char* last) noexcept {
+    std::size_t count = 0;
+#if defined(__AVX2__)
+    while (last - p >= 32) {
+        const std::ptrdiff_t blocks = std::min<std::ptrdiff_t>((last - p) / 32, 127);
+        __m256i counts = _mm256_setzero_si256();
+        for (std::ptrdiff_t i = 0; i < blocks; ++i, p += 32) {
+            const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            counts = _mm256_sub_epi8(counts, _mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65)));
+            if constexpr (FourByteLeads) {
+                const __m256i four = _mm256_max_epu8(input, _mm256_set1_epi8(static_cast<char>(0xF0)));
+                counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(four, input));
+            }
+        }
+        const __m256i sums = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+        count += static_cast<std::size_t>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                                          _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    while (last - p >= 16) {
+        const std::ptrdiff_t blocks = std::min<std::ptrdiff_t>((last - p) / 16, 127);
+        __m128i counts = _mm_setzero_si128();
+        for (std::ptrdiff_t i = 0; i < blocks; ++i, p += 16) {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(input, _mm_set1_epi8(-65)));
+            if constexpr (FourByteLeads) {
+                const __m128i four = _mm_max_epu8(input, _mm_set1_epi8(static_cast<char>(0xF0)));
+                counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(four, input));
+            }
+        }
+        const __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+        count += static_cast<std::size_t>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+    }
+#endif
+    for (; p != last; ++p) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        count += ((c & 0xC0) != 0x80 ? 1 : 0) + (FourByteLeads && c >= 0xF0 ? 1 : 0);
+    }
+    return count;
+}
+
+}  // namespace detail
+
+namespace utf8 {
+
+// Incremental validator for text that arrives in pieces, such as network
+// reads or rope leaves: a sequence may be split across update() calls.
+// finish() reports whether everything since construction (or the previous
+// finish()) was well-formed UTF-8, and resets the validator.
+class validator {
+public:
+    void update(std::string_view chunk) noexcept {
+        const char* p = chunk.data();
+        const char* const last = p + chunk.size();
+        if (_staged_size != 0) {
+            const std::size_t take = std::min(sizeof(_staged) - _staged_size, chunk.size());
+            std::memcpy(_staged + _staged_size, p, take);
+            _staged_size += take;
+            p += take;
+            if (_staged_size != sizeof(_staged)) {
+                return;
+            }
+            _checker.check(_staged);
+            _staged_size = 0;
+        }
+        for (; last - p >= 32; p += 32) {
+            _checker.check(p);
+        }
+        if (p != last) {
+            _staged_size = static_cast<std::size_t>(last - p);
+            std::memcpy(_staged, p, _staged_size);
+        }
+    }
+
+    [[nodiscard]] bool finish() noexcept {
+        if (_staged_size != 0) {
+            // ASCII padding completes no sequence, so a truncated one still fails.
+            std::memset(_staged + _staged_size, ' ', sizeof(_staged) - _staged_size);
+            _checker.check(_staged);
+        }
+        const bool valid = _checker.valid();
+        *this = validator();
+        return valid;
+    }
+
+private:
+    detail::utf8_checker _checker;
+    char _staged[32];
+    std::size_t _staged_size = 0;
+};
+
+// True if text is well-formed UTF-8.
+[[nodiscard]] inline bool validate(std::string_view text) noexcept {
+    validator checker;
+    checker.update(text);
+    return checker.finish();
+}
+
+template <std::same_as<substring_view> View>
+[[nodiscard]] bool validate(const View& text) noexcept {
+    return validate(std::string_view(text.data(), text.size()));
+}
+
+// Validates the rope leaf by leaf, without linearising it.
+template <std::same_as<rope> Rope>
+[[nodiscard]] bool validate(const Rope& text) noexcept {
+    validator checker;
+    text.for_each_chunk([&](std::string_view chunk) { checker.update(chunk); });
+    return checker.finish();
+}
+
+// Offset of the first byte of the first ill-formed or truncated sequence,
+// or npos if text is well-formed. The blocks before the error are checked
+// with the vector kernel; the exact position is found by a scalar pass from
+// the last code point boundary before the failing block.
+[[nodiscard]] inline std::size_t find_invalid(std::string_view text) noexcept {
+    const char* const first = text.data();
+    const char* const last = first + text.size();
+    const char* p = first;
+#if defined(__AVX2__) || defined(__SSSE3__)
+    detail::utf8_checker checker;
+    for (; last - p >= 32; p += 32) {
+        checker.check(p);
+        if (checker.has_errors()) {
+            break;
+        }
+    }
+    // The blocks before p were clean, so a sequence that p splits starts at
+    // most three bytes before it.
+    for (int back = 1; back <= 3 && p - back >= first; ++back) {
+        const unsigned char c = static_cast<unsigned char>(p[-back]);
+        if ((c & 0xC0) != 0x80) {
+            p -= c >= 0xC0 && (c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : 2) > back ? back : 0;
+            break;
+        }
+    }
+#endif
+    const char* const invalid = detail::utf8_find_invalid_scalar(p, last);
+    return invalid == last ? std::string_view::npos : static_cast<std::size_t>(invalid - first);
+}
+
+// Number of code points in well-formed text: the bytes that are not
+// continuation bytes (10xxxxxx). Ill-formed text gives a count between the
+// number of valid sequences and the byte count.
+[[nodiscard]] inline std::size_t count_codepoints(std::string_view text) noexcept {
+    return detail::utf8_count_units<false>(text.data(), text.data() + text.size());
+}
+
+template <std::same_as<substring_view> View>
+[[nodiscard]] std::size_t count_codepoints(const View& text) noexcept {
+    return count_codepoints(std::string_view(text.data(), text.size()));
+}
+
+template <std::same_as<rope> Rope>
+[[nodiscard]] std::size_t count_codepoints(const Rope& text) noexcept {
+    std::size_t count = 0;
+    text.for_each_chunk([&](std::string_view chunk) { count += count_codepoints(chunk); });
+    return count;
+}
+
+// The largest code point boundary not after pos, stepping back over at most
+// three continuation bytes; text.size() if pos is past the end. Truncating
+// at the result never splits a sequence of well-formed text.
+[[nodiscard]] inline std::size_t find_codepoint_boundary(std::string_view text, std::size_t pos) noexcept {
+    if (pos >= text.size()) {
+        return text.size();
+    }
+    for (int back = 0; back < 3 && pos != 0 && (static_cast<unsigned char>(text[pos]) & 0xC0) == 0x80; ++back) {
+        --pos;
+    }
+    return pos;
+}
+
+// Calls fn(char32_t) for each code point of the rope, decoding sequences
+// that span leaves. Each ill-formed byte is passed as U+FFFD.
+template <typename Fn>
+void for_each_codepoint(const rope& text, Fn&& fn) {
+    // The start of a sequence cut off by the end of a leaf, completed from
+    // the leaves after it.
+    char pending[8];
+    std::size_t pending_size = 0;
+    auto decode_run = [&](const char*& p, const char* last, bool final) {
+        while (p != last) {
+            const int length = detail::utf8_sequence_length(p, last);
+            if (length < 0 && !final) {
+                return;
+            }
+            fn(length > 0 ? detail::utf8_decode(p, length) : U'\uFFFD');
+            p += length > 0 ? length : 1;
+        }
+    };
+    text.for_each_chunk([&](std::string_view chunk) {
+        const char* p = chunk.data();
+        const char* const last = p + chunk.size();
+        if (pending_size != 0) {
+            const std::size_t take = std::min<std::size_t>(chunk.size(), 4 - pending_size);
+            std::memcpy(pending + pending_size, p, take);
+            const char* q = pending;
+            const int length = detail::utf8_sequence_length(q, pending + pending_size + take);
+            if (length < 0) {
+                // Still cut short: the leaf was too small to finish it.
+                pending_size += take;
+                return;
+            }
+            fn(length > 0 ? detail::utf8_decode(q, length) : U'\uFFFD');
+            const std::size_t used = length > 0 ? static_cast<std::size_t>(length) : 1;
+            if (used < pending_size) {
+                // An ill-formed lead: the bytes after it are decoded afresh.
+                std::memmove(pending, pending + used, pending_size - used);
+                pending_size -= used;
+                const char* rest = pending;
+                decode_run(rest, pending + pending_size, true);
+                pending_size = 0;
+            } else {
+                p += used - pending_size;
+                pending_size = 0;
+            }
+        }
+        decode_run(p, last, false);
+        if (p != last) {
+            pending_size = static_cast<std::size_t>(last - p);
+            std::memcpy(pending, p, pending_size);
+        }
+    });
+    const char* rest = pending;
+    decode_run(rest, pending + pending_size, true);
+}
+
+}  // namespace utf8
+
+// Forward range of the code points (char32_t) of UTF-8 text. Each byte that
+// does not start a well-formed sequence yields U+FFFD, so iteration is safe
+// on unvalidated input.
+class utf8_view {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = char32_t;
+
+        iterator() noexcept = default;
+        iterator(const char* position, const char* last) noexcept : _position(position), _last(last) {}
+
+        [[nodiscard]] char32_t operator*() const noexcept {
+            const int length = detail::utf8_sequence_length(_position, _last);
+            return length > 0 ? detail::utf8_decode(_position, length) : U'\uFFFD';
+        }
+
+        iterator& operator++() noexcept {
+            const int length = detail::utf8_sequence_length(_position, _last);
+            _position += length > 0 ? length : 1;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            iterator before = *this;
+            ++*this;
+            return before;
+        }
+
+        // The first byte of the current code point.
+        [[nodiscard]] const char* base() const noexcept { return _position; }
+
+        [[nodiscard]] bool operator==(const iterator& other) const noexcept { return _position == other._position; }
+
+    private:
+        const char* _position = nullptr;
+        const char* _last = nullptr;
+    };
+
+    utf8_view() noexcept = default;
+    // From anything that converts to std::string_view: fl::string,
+    // std::string, a string literal.
+    template <typename Text>
+        requires std::convertible_to<const Text&, std::string_view>
+    utf8_view(const Text& text) noexcept : _text(text) {}
+
+    template <std::same_as<substring_view> View>
+    utf8_view(const View& text) noexcept : _text(text.data(), text.size()) {}
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator(_text.data(), _text.data() + _text.size()); }
+    [[nodiscard]] iterator end() const noexcept {
+        return iterator(_text.data() + _text.size(), _text.data() + _text.size());
+    }
+
+    [[nodiscard]] std::string_view bytes() const noexcept { return _text; }
+    [[nodiscard]] bool empty() const noexcept { return _text.empty(); }
+    [[nodiscard]] bool valid() const noexcept { return utf8::validate(_text); }
+    [[nodiscard]] std::size_t count() const noexcept { return utf8::count_codepoints(_text); }
+
+private:
+    std::string_view _text;
+};
+
+// ========== Transcoding ==========
+
+namespace detail {
+
+// Decodes well-formed UTF-8 in [p, last) into UTF-16 at out and returns the
+// end of the output. Blocks of ASCII are widened with one vector step; the
+// rest is decoded a sequence at a time, a block's worth before the next
+// ASCII check so CJK text does not pay for a failed check per character.
+inline char16_t* utf8_to_utf16_unchecked(const char* p, const char* last, char16_t* out) noexcept {
+    while (p != last) {
+#if defined(__AVX2__)
+        if (last - p >= 32) {
+            const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            if (_mm256_movemask_epi8(input) == 0) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                                    _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16),
+                                    _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input, 1)));
+                p += 32;
+                out += 32;
+                continue;
+            }
+        }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        if (last - p >= 16) {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            if (_mm_movemask_epi8(input) == 0) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(input, _mm_setzero_si128()));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(input, _mm_setzero_si128()));
+                p += 16;
+                out += 16;
+                continue;
+            }
+        }
+#endif
+        const char* const stop = p + std::min<std::ptrdiff_t>(last - p, 16);
+        while (p < stop) {
+            const unsigned char lead = static_cast<unsigned char>(*p);
+            const int length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+            const char32_t cp = utf8_decode(p, length);
+            if (cp < 0x10000) {
+                *out++ = static_cast<char16_t>(cp);
+            } else {
+                *out++ = static_cast<char16_t>(0xD7C0 + (cp >> 10));
+                *out++ = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+            }
+            p += length;
+        }
+    }
+    return out;
+}
+
+// As above, into UTF-32.
+inline char32_t* utf8_to_utf32_unchecked(const char* p, const char* last, char32_t* out) noexcept {
+    while (p != last) {
+#if defined(__AVX2__)
+        if (last - p >= 32) {
+            const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            if (_mm256_movemask_epi8(input) == 0) {
+                for (int i = 0; i < 4; ++i, p += 8, out += 8) {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                                        _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+                }
+                continue;
+            }
+        }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        if (last - p >= 16) {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            if (_mm_movemask_epi8(input) == 0) {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i low = _mm_unpacklo_epi8(input, zero);
+                const __m128i high = _mm_unpackhi_epi8(input, zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(low, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(low, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(high, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(high, zero));
+                p += 16;
+                out += 16;
+                continue;
+            }
+        }
+#endif
+        const char* const stop = p + std::min<std::ptrdiff_t>(last - p, 16);
+        while (p < stop) {
+            const unsigned char lead = static_cast<unsigned char>(*p);
+            const int length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+            *out++ = utf8_decode(p, length);
+            p += length;
+        }
+    }
+    return out;
+}
+
+// UTF-8 length of [p, last) if its surrogates are paired: one byte per unit,
+// plus one from U+0080 and another from U+0800, less one for each surrogate
+// (a pair of units is four bytes, not six). Per-lane 16-bit counters gain at
+// most two per block, so they are summed every 16383 blocks.
+[[nodiscard]] inline std::size_t utf16_to_utf8_length(const char16_t* p, const char16_t* last) noexcept {
+    std::size_t length = static_cast<std::size_t>(last - p);
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    while (last - p >= 8) {
+        const std::ptrdiff_t blocks = std::min<std::ptrdiff_t>((last - p) / 8, 16383);
+        __m128i counts = _mm_setzero_si128();
+        const __m128i zero = _mm_setzero_si128();
+        for (std::ptrdiff_t i = 0; i < blocks; ++i, p += 8) {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i high_bits = _mm_and_si128(input, _mm_set1_epi16(static_cast<short>(0xF800)));
+            const __m128i below_80 =
+                _mm_cmpeq_epi16(_mm_and_si128(input, _mm_set1_epi16(static_cast<short>(0xFF80))), zero);
+            const __m128i below_800 = _mm_cmpeq_epi16(high_bits, zero);
+            const __m128i surrogate = _mm_cmpeq_epi16(high_bits, _mm_set1_epi16(static_cast<short>(0xD800)));
+            // Each compare is -1 where true: add two, then take back the
+            // units below each threshold and the surrogates.
+            counts = _mm_add_epi16(counts, _mm_set1_epi16(2));
+            counts = _mm_add_epi16(counts, _mm_add_epi16(_mm_add_epi16(below_80, below_800), surrogate));
+        }
+        const __m128i sums = _mm_madd_epi16(counts, _mm_set1_epi16(1));
+        alignas(16) std::int32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sums);
+        length += static_cast<std::size_t>(lanes[0]) + static_cast<std::size_t>(lanes[1]) +
+                  static_cast<std::size_t>(lanes[2]) + static_cast<std::size_t>(lanes[3]);
+    }
+#endif
+    for (; p != last; ++p) {
+        const char16_t unit = *p;
+        length += (unit >= 0x80 ? 1 : 0) + (unit >= 0x800 ? 1 : 0) - ((unit & 0xF800) == 0xD800 ? 1 : 0);
+    }
+    return length;
+}
+
+[[noreturn]] inline void throw_unpaired_surrogate(std::size_t offset) {
+    throw std::invalid_argument("fl::utf16_to_utf8: unpaired surrogate at offset " + std::to_string(offset));
+}
+
+// Encodes [p, last) as UTF-8 at out, which has room for
+// utf16_to_utf8_length(), and returns the end of the output. Blocks of
+// ASCII are narrowed with one pack. Throws std::invalid_argument at an
+// unpaired surrogate, reporting its offset from first.
+inline char* utf16_to_utf8_to(const char16_t* first, const char16_t* p, const char16_t* last, char* out) {
+    while (p != last) {
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        if (last - p >= 16) {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8));
+            const __m128i non_ascii =
+                _mm_and_si128(_mm_or_si128(low, high), _mm_set1_epi16(static_cast<short>(0xFF80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) == 0xFFFF) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(low, high));
+                p += 16;
+                out += 16;
+                continue;
+            }
+        }
+#endif
+        const char16_t* const stop = p + std::min<std::ptrdiff_t>(last - p, 16);
+        while (p < stop) {
+            const char32_t unit = *p++;
+            if (unit < 0x80) {
+                *out++ = static_cast<char>(unit);
+            } else if (unit < 0x800) {
+                *out++ = static_cast<char>(0xC0 | unit >> 6);
+                *out++ = static_cast<char>(0x80 | (unit & 0x3F));
+            } else if ((unit & 0xF800) != 0xD800) {
+                *out++ = static_cast<char>(0xE0 | unit >> 12);
+                *out++ = static_cast<char>(0x80 | (unit >> 6 & 0x3F));
+                *out++ = static_cast<char>(0x80 | (unit & 0x3F));
+            } else {
+                if (unit >= 0xDC00 || p == last || (*p & 0xFC00) != 0xDC00) {
+                    throw_unpaired_surrogate(static_cast<std::size_t>(p - 1 - first));
+                }
+                const char32_t cp = 0x10000 + ((unit - 0xD800) << 10) + (*p++ - 0xDC00);
+                *out++ = static_cast<char>(0xF0 | cp >> 18);
+                *out++ = static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+                *out++ = static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+                *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+    }
+    return out;
+}
+
+// Throws std::invalid_argument naming function unless text is well-formed.
+inline void require_utf8(std::string_view text, const char* function) {
+    const std::size_t invalid = utf8::find_invalid(text);
+    if (invalid != std::string_view::npos) {
+        throw std::invalid_argument(std::string(function) + ": invalid UTF-8 at offset " + std::to_string(invalid));
+    }
+}
+
+}  // namespace detail
+
+namespace utf8 {
+
+// Output lengths of the conversions below for well-formed input, each in one
+// vector pass. The UTF-8 length of UTF-16 text counts an unpaired surrogate
+// as two bytes.
+[[nodiscard]] inline std::size_t utf16_length_from_utf8(std::string_view text) noexcept {
+    return detail::utf8_count_units<true>(text.data(), text.data() + text.size());
+}
+
+[[nodiscard]] inline std::size_t utf32_length_from_utf8(std::string_view text) noexcept {
+    return count_codepoints(text);
+}
+
+[[nodiscard]] inline std::size_t utf8_length_from_utf16(std::u16string_view text) noexcept {
+    return detail::utf16_to_utf8_length(text.data(), text.data() + text.size());
+}
+
+}  // namespace utf8
+
+// Converts UTF-8 to UTF-16, allocating the result once at its exact length.
+// Throws std::invalid_argument, with the offset, if text is not well-formed.
+[[nodiscard]] inline std::u16string utf8_to_utf16(std::string_view text) {
+    detail::require_utf8(text, "fl::utf8_to_utf16");
+    std::u16string result(utf8::utf16_length_from_utf8(text), u'\0');
+    detail::utf8_to_utf16_unchecked(text.data(), text.data() + text.size(), result.data());
+    return result;
+}
+
+template <std::same_as<substring_view> View>
+[[nodiscard]] std::u16string utf8_to_utf16(const View& text) {
+    return utf8_to_utf16(std::string_view(text.data(), text.size()));
+}
+
+// Converts UTF-8 to UTF-32 code points, as utf8_to_utf16() does.
+[[nodiscard]] inline std::u32string utf8_to_utf32(std::string_view text) {
+    detail::require_utf8(text, "fl::utf8_to_utf32");
+    std::u32string result(utf8::utf32_length_from_utf8(text), U'\0');
+    detail::utf8_to_utf32_unchecked(text.data(), text.data() + text.size(), result.data());
+    return result;
+}
+
+template <std::same_as<substring_view> View>
+[[nodiscard]] std::u32string utf8_to_utf32(const View& text) {
+    return utf8_to_utf32(std::string_view(text.data(), text.size()));
+}
+
+// Writes UTF-16 text as UTF-8. A direct_sink is sized once and written in
+// place; any other sink receives the output in chunks of at most 1 KB.
+// Throws std::invalid_argument, with the offset, at an unpaired surrogate,
+// after which the sink may hold part of the output.
+template <sinks::character_sink Sink>
+void utf16_to_utf8(Sink& sink, std::u16string_view text) {
+    const char16_t* const first = text.data();
+    const char16_t* const last = first + text.size();
+    if constexpr (sinks::direct_sink<Sink>) {
+        const std::size_t size = utf8::utf8_length_from_utf16(text);
+        const std::span<char> space = sink.prepare(size);
+        if (space.size() >= size) {
+            sink.commit(static_cast<std::size_t>(detail::utf16_to_utf8_to(first, first, last, space.data()) -
+                                                 space.data()));
+            return;
+        }
+    }
+    char buffer[1024];
+    for (const char16_t* p = first; p != last;) {
+        const char16_t* stop = p + std::min<std::ptrdiff_t>(last - p, 256);
+        // Keep a surrogate pair within one chunk.
+        if (stop != last && (stop[-1] & 0xFC00) == 0xD800 && stop - p > 1) {
+            --stop;
+        }
+        const char* const out = detail::utf16_to_utf8_to(first, p, stop, buffer);
+        sink.write(buffer, static_cast<std::size_t>(out - buffer));
+        p = stop;
+    }
+}
+
+// Converts UTF-16 to UTF-8 in an fl::string allocated at its exact length.
+[[nodiscard]] inline fl::string utf16_to_utf8(std::u16string_view text) {
+    fl::string result(utf8::utf8_length_from_utf16(text), '\0');
+    detail::utf16_to_utf8_to(text.data(), text.data(), text.data() + text.size(), result.data());
+    return result;
+}
+
+}  // namespace fl
+
+#endif  // FL_UTF8_HPP
@@ -0,0 +1,325 @@
+// Copyright (c) 2026 Jayden Emmanuel.
+// Licensed under the FL License. See LICENSE.txt for details.
+
+#ifndef FL_WHITESPACE_HPP
+#define FL_WHITESPACE_HPP
+
+// Whitespace trimming and normalisation for std::string_view, fl::string and
+// fl::substring_view.
+//
+// Whitespace is the C locale's isspace() set: ' ', '\t', '\n', '\v', '\f'
+// and '\r'. Bytes are classified a block at a time (32 with AVX2, 16 with
+// SSE2), so trimming long padding or scanning for runs costs one compare per
+// block rather than one find_first_not_of() probe per byte.
+// collapse_whitespace() packs each 16-byte block with a byte shuffle (SSSE3),
+// dropping every whitespace byte that follows another in one step.
+
+#include "fl/escape.hpp"
+#include "fl/sinks.hpp"
+#include "fl/string.hpp"
+#include "fl/substring_view.hpp"
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#if defined(__SSSE3__) && !defined(__AVX2__)
+#include <tmmintrin.h>
+#endif
+
+namespace fl {
+
+namespace detail {
+
+[[nodiscard]] constexpr bool is_ascii_space(unsigned char c) noexcept {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Bytes that are not whitespace, in the find_byte_class() form.
+struct non_space_class {
+    static bool test(unsigned char c) noexcept { return !is_ascii_space(c); }
+#if defined(__AVX2__)
+    // '\t' to '\r' are tested as (v - 9) <= 4, unsigned.
+    static __m256i spaces(__m256i block) noexcept {
+        const __m256i control = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+        return _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+                               _mm256_cmpeq_epi8(_mm256_min_epu8(control, _mm256_set1_epi8(4)), control));
+    }
+    static unsigned mask(__m256i block) noexcept {
+        return ~static_cast<unsigned>(_mm256_movemask_epi8(spaces(block)));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    static __m128i spaces(__m128i block) noexcept {
+        const __m128i control = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+        return _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                            _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control));
+    }
+    static unsigned mask(__m128i block) noexcept {
+        return ~static_cast<unsigned>(_mm_movemask_epi8(spaces(block))) & 0xFFFFu;
+    }
+#endif
+};
+
+// Returns one past the last byte in [first, last) that belongs to Class, or
+// first: find_byte_class() scanning backwards.
+template <typename Class>
+[[nodiscard]] inline const char* find_last_byte_class(const char* first, const char* last) noexcept {
+#if defined(__AVX2__)
+    while (last - first >= 32) {
+        const unsigned mask = Class::mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(last - 32)));
+        if (mask != 0) {
+            return last - 32 + std::bit_width(mask);
+        }
+        last -= 32;
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    while (last - first >= 16) {
+        const unsigned mask = Class::mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(last - 16)));
+        if (mask != 0) {
+            return last - 16 + std::bit_width(mask);
+        }
+        last -= 16;
+    }
+#endif
+    while (last != first && !Class::test(static_cast<unsigned char>(last[-1]))) {
+        --last;
+    }
+    return last;
+}
+
+[[nodiscard]] inline const char* skip_leading_space(const char* first, const char* last) noexcept {
+    // Most text starts with a non-space byte; answer that without a block load.
+    if (first == last || !is_ascii_space(static_cast<unsigned char>(*first))) {
+        return first;
+    }
+    return find_byte_class<non_space_class>(first + 1, last);
+}
+
+[[nodiscard]] inline const char* skip_trailing_space(const char* first, const char* last) noexcept {
+    if (first == last || !is_ascii_space(static_cast<unsigned char>(last[-1]))) {
+        return last;
+    }
+    return find_last_byte_class<non_space_class>(first, last - 1);
+}
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+// For each 8-bit keep mask, the _mm_shuffle_epi8 indices that move the kept
+// bytes of an 8-byte group to its front, in order.
+inline constexpr std::array<std::uint64_t, 256> left_pack_indices = [] {
+    std::array<std::uint64_t, 256> table{};
+    for (unsigned keep = 0; keep < 256; ++keep) {
+        std::uint64_t indices = 0;
+        unsigned out = 0;
+        for (unsigned i = 0; i < 8; ++i) {
+            if (keep & (1u << i)) {
+                indices |= static_cast<std::uint64_t>(i) << (8 * out++);
+            }
+        }
+        table[keep] = indices;
+    }
+    return table;
+}();
+
+// Writes the 16 bytes of block whose bit is set in keep to out, packed, and
+// returns the end of the output. Stores 16 bytes in all, so out must have
+// room for them.
+[[nodiscard]] inline char* left_pack(char* out, __m128i block, unsigned keep) noexcept {
+    const unsigned low = keep & 0xFF;
+    const unsigned high = keep >> 8;
+    const __m128i indices = _mm_set_epi64x(static_cast<long long>(left_pack_indices[high] + 0x0808080808080808ull),
+                                           static_cast<long long>(left_pack_indices[low]));
+    const __m128i packed = _mm_shuffle_epi8(block, indices);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+    out += std::popcount(low);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_srli_si128(packed, 8));
+    return out + std::popcount(high);
+}
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+// Collapses one 16-byte block; in_run says whether the byte before it was
+// whitespace.
+[[nodiscard]] inline char* collapse_space_block(char* out, const char* p, bool& in_run) noexcept {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i spaces = non_space_class::spaces(block);
+    const unsigned space_mask = static_cast<unsigned>(_mm_movemask_epi8(spaces));
+    const unsigned repeated = space_mask & ((space_mask << 1) | static_cast<unsigned>(in_run)) & 0xFFFFu;
+    in_run = (space_mask & 0x8000u) != 0;
+    const __m128i normalised =
+        _mm_or_si128(_mm_andnot_si128(spaces, block), _mm_and_si128(spaces, _mm_set1_epi8(' ')));
+    if (repeated == 0) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), normalised);
+        return out + 16;
+    }
+#if defined(__SSSE3__) || defined(__AVX2__)
+    return left_pack(out, normalised, ~repeated & 0xFFFFu);
+#else
+    alignas(16) char bytes[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(bytes), normalised);
+    for (unsigned i = 0; i < 16; ++i) {
+        *out = bytes[i];
+        out += (repeated >> i & 1) ^ 1;
+    }
+    return out;
+#endif
+}
+#endif
+
+// Copies [p, last) to out with each run of whitespace replaced by one ' ',
+// and returns the end of the output. in_run carries whether the byte before
+// p was whitespace, so text can be processed in pieces. out may point into
+// the input at or before p (the output never runs ahead of the input, and
+// each block is loaded before it is stored); otherwise it needs room for
+// last - p bytes.
+[[nodiscard]] inline char* collapse_space_to(char* out, const char* p, const char* last, bool& in_run) noexcept {
+#if defined(__AVX2__)
+    // Blocks with single ' ' separators only, the usual case in prose and
+    // logs, are copied whole.
+    while (last - p >= 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const unsigned space_mask = static_cast<unsigned>(_mm256_movemask_epi8(non_space_class::spaces(block)));
+        const unsigned blanks =
+            static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '))));
+        if ((space_mask & ((space_mask << 1) | static_cast<unsigned>(in_run))) == 0 && space_mask == blanks) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), block);
+            in_run = (space_mask >> 31) != 0;
+            out += 32;
+            p += 32;
+            continue;
+        }
+        out = collapse_space_block(out, p, in_run);
+        out = collapse_space_block(out, p + 16, in_run);
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    for (; last - p >= 16; p += 16) {
+        out = collapse_space_block(out, p, in_run);
+    }
+#endif
+    for (; p != last; ++p) {
+        if (is_ascii_space(static_cast<unsigned char>(*p))) {
+            if (!in_run) {
+                *out++ = ' ';
+            }
+            in_run = true;
+        } else {
+            *out++ = *p;
+            in_run = false;
+        }
+    }
+    return out;
+}
+
+}  // namespace detail
+
+// ========== Views ==========
+
+// Returns text without leading and trailing whitespace. An all-whitespace
+// text gives an empty view.
+[[nodiscard]] inline std::string_view trim_view(std::string_view text) noexcept {
+    const char* const first = detail::skip_leading_space(text.data(), text.data() + text.size());
+    const char* const last = detail::skip_trailing_space(first, text.data() + text.size());
+    return std::string_view(first, static_cast<std::size_t>(last - first));
+}
+
+[[nodiscard]] inline std::string_view ltrim_view(std::string_view text) noexcept {
+    const char* const first = detail::skip_leading_space(text.data(), text.data() + text.size());
+    return std::string_view(first, static_cast<std::size_t>(text.data() + text.size() - first));
+}
+
+[[nodiscard]] inline std::string_view rtrim_view(std::string_view text) noexcept {
+    const char* const last = detail::skip_trailing_space(text.data(), text.data() + text.size());
+    return std::string_view(text.data(), static_cast<std::size_t>(last - text.data()));
+}
+
+// The substring_view overloads return a view sharing text's owner.
+template <std::same_as<substring_view> View>
+[[nodiscard]] substring_view trim_view(const View& text) noexcept {
+    const std::string_view inner = trim_view(std::string_view(text.data(), text.size()));
+    return text.substr(static_cast<std::size_t>(inner.data() - text.data()), inner.size());
+}
+
+template <std::same_as<substring_view> View>
+[[nodiscard]] substring_view ltrim_view(const View& text) noexcept {
+    const std::string_view inner = ltrim_view(std::string_view(text.data(), text.size()));
+    return text.substr(static_cast<std::size_t>(inner.data() - text.data()));
+}
+
+template <std::same_as<substring_view> View>
+[[nodiscard]] substring_view rtrim_view(const View& text) noexcept {
+    return text.substr(0, rtrim_view(std::string_view(text.data(), text.size())).size());
+}
+
+// ========== In Place ==========
+
+// Removes leading and trailing whitespace from s; returns s.
+inline string& trim(string& s) noexcept {
+    const std::string_view text(s);
+    const std::string_view inner = trim_view(text);
+    s.resize(static_cast<std::size_t>(inner.data() - text.data()) + inner.size());
+    s.erase(0, static_cast<std::size_t>(inner.data() - text.data()));
+    return s;
+}
+
+inline string& ltrim(string& s) noexcept {
+    const std::string_view text(s);
+    s.erase(0, static_cast<std::size_t>(ltrim_view(text).data() - text.data()));
+    return s;
+}
+
+inline string& rtrim(string& s) noexcept {
+    s.resize(rtrim_view(std::string_view(s)).size());
+    return s;
+}
+
+// ========== Normalisation ==========
+
+// Trims s and replaces each run of whitespace inside it with a single ' ', in
+// one pass over s's own buffer; returns s.
+inline string& collapse_whitespace(string& s) noexcept {
+    const std::string_view text(s);
+    const std::string_view inner = trim_view(text);
+    bool in_run = false;
+    char* const data = s.data();
+    const char* const first = data + (inner.data() - text.data());
+    const char* const out = detail::collapse_space_to(data, first, first + inner.size(), in_run);
+    s.resize(static_cast<std::size_t>(out - data));
+    return s;
+}
+
+// Writes text to sink as collapse_whitespace(string&) would leave it. A
+// direct_sink is written in place; any other sink receives the output in
+// chunks of at most 256 bytes.
+template <sinks::character_sink Sink>
+void collapse_whitespace(Sink& sink, std::string_view text) {
+    const std::string_view inner = trim_view(text);
+    const char* p = inner.data();
+    const char* const last = p + inner.size();
+    bool in_run = false;
+    if constexpr (sinks::direct_sink<Sink>) {
+        const std::span<char> space = sink.prepare(inner.size());
+        if (space.size() >= inner.size()) {
+            const char* const out = detail::collapse_space_to(space.data(), p, last, in_run);
+            sink.commit(static_cast<std::size_t>(out - space.data()));
+            return;
+        }
+    }
+    char buffer[detail::escape_chunk];
+    while (p != last) {
+        const char* const stop = p + std::min(detail::escape_chunk, static_cast<std::size_t>(last - p));
+        const char* const out = detail::collapse_space_to(buffer, p, stop, in_run);
+        sink.write(buffer, static_cast<std::size_t>(out - buffer));
+        p = stop;
+    }
+}
+
+}  // namespace fl
+
+#endif  // FL_WHITESPACE_HPP
@@ -0,0 +1,272 @@
+#include <fl.hpp>
+#include <fl/async_sink.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+// Collects what the background thread writes; writes wait while the gate is
+// closed, and optionally fail.
+struct recording_sink final : fl::sinks::output_sink {
+    std::string text;
+    std::vector<std::size_t> writes;
+    std::size_t flushes = 0;
+    std::atomic<std::size_t> write_count{0};
+    std::atomic<bool> open{true};
+    bool fail = false;
+
+    void write(const char* data, std::size_t len) override {
+        while (!open.load()) {
+            std::this_thread::yield();
+        }
+        if (fail) {
+            throw std::runtime_error("recording_sink: write failed");
+        }
+        text.append(data, len);
+        writes.push_back(len);
+        ++write_count;
+    }
+
+    void flush() override { ++flushes; }
+};
+
+// Whether every "<thread> <n>\n" line is present, whole, and in order per
+// thread.
+static bool lines_in_order(std::string_view text, int threads, int per_thread) {
+    std::vector<int> next(static_cast<std::size_t>(threads), 0);
+    bool ok = true;
+    fl::for_each_line(text, [&](std::string_view line) {
+        const std::size_t space = line.find(' ');
+        const int thread = std::stoi(std::string(line.substr(0, space)));
+        const int n = std::stoi(std::string(line.substr(space + 1)));
+        ok = ok && space != std::string_view::npos && n == next[static_cast<std::size_t>(thread)]++;
+    });
+    for (const int count : next) {
+        ok = ok && count == per_thread;
+    }
+    return ok;
+}
+
+int main() {
+    // One thread: blocks, flush, close.
+    {
+        recording_sink target;
+        {
+            fl::sinks::async_options opts;
+            opts.block_size = 64;
+            fl::sinks::async_sink sink(target, opts);
+            sink.write("hello ", 6);
+            fl::format_to(sink, "{} {:.1f}\n", 42, 2.5);
+            sink.flush();
+            TEST(target.text == "hello 42 2.5\n" && target.flushes == 1, "async_sink: flush writes a partial block");
+
+            const std::string line(40, 'x');
+            sink.write(line.data(), line.size());
+            sink.write(line.data(), line.size());
+            const std::string large(150, 'y');
+            sink.write(large.data(), large.size());
+            sink.flush();
+            bool bounded = true;
+            for (const std::size_t size : target.writes) {
+                bounded = bounded && size <= 64;
+            }
+            TEST(target.text == "hello 42 2.5\n" + line + line + large && bounded,
+                 "async_sink: writes fill blocks of at most block_size");
+            sink.write("tail", 4);
+        }
+        TEST(target.text.ends_with("yyytail") && target.flushes == 3, "async_sink: destructor writes and flushes");
+    }
+
+    // A write never straddles two blocks unless it is larger than one.
+    {
+        recording_sink target;
+        {
+            fl::sinks::async_options opts;
+            opts.block_size = 100;
+            fl::sinks::async_sink sink(target, opts);
+            for (int i = 0; i < 50; ++i) {
+                sink.write("0123456789abcdefghijklmnopqrstu\n", 32);
+            }
+        }
+        bool whole = target.writes.size() >= 2;
+        for (const std::size_t size : target.writes) {
+            whole = whole && size % 32 == 0;
+        }
+        TEST(whole && target.text.size() == 50 * 32, "async_sink: a write is not split across blocks");
+    }
+
+    // Many threads; every line arrives whole and in per-thread order,
+    // including the partial blocks of threads that have already exited.
+    {
+        constexpr int kThreads = 4;
+        constexpr int kLines = 20000;
+        recording_sink target;
+        fl::sinks::async_options opts;
+        opts.block_size = 4096;
+        opts.queue_blocks = 4;
+        fl::sinks::async_sink sink(target, opts);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < kThreads; ++t) {
+            writers.emplace_back([&, t] {
+                for (int i = 0; i < kLines; ++i) {
+                    char line[32];
+                    const auto result = fl::format_to_n(line, sizeof(line), "{} {}\n", t, i);
+                    sink.write(line, result.size);
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        sink.flush();
+        TEST(lines_in_order(target.text, kThreads, kLines) && sink.bytes_dropped() == 0,
+             "async_sink: concurrent writers, backpressure::block");
+    }
+
+    // backpressure::drop with the wrapped sink stalled: full blocks beyond
+    // the queue are discarded and counted; nothing is lost silently.
+    {
+        recording_sink target;
+        target.open = false;
+        fl::sinks::async_options opts;
+        opts.block_size = 256;
+        opts.queue_blocks = 2;
+        opts.policy = fl::sinks::backpressure::drop;
+        fl::sinks::async_sink sink(target, opts);
+        const std::string line(64, 'd');
+        for (int i = 0; i < 200; ++i) {
+            sink.write(line.data(), line.size());
+        }
+        TEST(sink.queue_full_count() > 0 && sink.bytes_dropped() > 0, "async_sink: backpressure::drop discards");
+        target.open = true;
+        sink.flush();
+        TEST(target.text.size() + sink.bytes_dropped() == 200 * 64 && target.text.size() % 256 == 0,
+             "async_sink: written and dropped bytes account for every write");
+    }
+
+    // backpressure::grow with the wrapped sink stalled: the queue grows.
+    {
+        recording_sink target;
+        target.open = false;
+        fl::sinks::async_options opts;
+        opts.block_size = 256;
+        opts.queue_blocks = 1;
+        opts.policy = fl::sinks::backpressure::grow;
+        fl::sinks::async_sink sink(target, opts);
+        const std::string line(64, 'g');
+        for (int i = 0; i < 200; ++i) {
+            sink.write(line.data(), line.size());
+        }
+        target.open = true;
+        sink.flush();
+        TEST(sink.queue_full_count() > 0 && sink.bytes_dropped() == 0 && target.text.size() == 200 * 64,
+             "async_sink: backpressure::grow keeps everything");
+    }
+
+    // A thread's partial block reaches the sink without a flush once the
+    // background thread next wakes.
+    {
+        recording_sink target;
+        fl::sinks::async_options opts;
+        opts.flush_interval = std::chrono::milliseconds(5);
+        fl::sinks::async_sink sink(target, opts);
+        std::thread([&] { sink.write("quiet\n", 6); }).join();
+        sink.write("main\n", 5);
+        for (int i = 0; i < 2000 && target.write_count < 2; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const bool written_unflushed = target.write_count >= 2;
+        sink.flush();
+        TEST(written_unflushed && target.text.find("quiet\n") != std::string::npos &&
+                 target.text.find("main\n") != std::string::npos,
+             "async_sink: idle partial blocks are written after flush_interval");
+    }
+
+    // Errors from the wrapped sink come back from flush(); writes after
+    // close() are dropped.
+    {
+        recording_sink target;
+        target.fail = true;
+        fl::sinks::async_sink sink(target);
+        sink.write("lost", 4);
+        bool rethrown = false;
+        try {
+            sink.flush();
+        } catch (const std::runtime_error& e) {
+            rethrown = std::string_view(e.what()) == "recording_sink: write failed";
+        }
+        TEST(rethrown && sink.bytes_dropped() == 4, "async_sink: flush rethrows the wrapped sink's error");
+        target.fail = false;
+        sink.write("kept", 4);
+        sink.close();
+        sink.write("late", 4);
+        sink.flush();
+        TEST(target.text == "kept" && sink.bytes_dropped() == 8, "async_sink: writes after close are dropped");
+    }
+
+    // Writes racing close() are either written or counted as dropped.
+    for (int round = 0; round < 20; ++round) {
+        recording_sink target;
+        fl::sinks::async_options opts;
+        opts.block_size = 64;
+        fl::sinks::async_sink sink(target, opts);
+        constexpr int kThreads = 4;
+        constexpr int kLines = 500;
+        std::atomic<int> started{0};
+        std::atomic<std::size_t> total{0};
+        std::vector<std::thread> writers;
+        for (int t = 0; t < kThreads; ++t) {
+            writers.emplace_back([&, t] {
+                ++started;
+                for (int i = 0; i < kLines; ++i) {
+                    char line[32];
+                    const auto result = fl::format_to_n(line, sizeof(line), "{} {}\n", t, i);
+                    sink.write(line, result.size);
+                    total += result.size;
+                }
+            });
+        }
+        while (started < kThreads) {
+            std::this_thread::yield();
+        }
+        sink.close();
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        TEST(target.text.size() + sink.bytes_dropped() == total, "async_sink: writes racing close are accounted for");
+    }
+
+    // Two sinks written by the same thread keep separate blocks.
+    {
+        recording_sink first_target;
+        recording_sink second_target;
+        fl::sinks::async_sink first(first_target);
+        {
+            fl::sinks::async_sink second(second_target);
+            first.write("a", 1);
+            second.write("b", 1);
+            first.write("c", 1);
+        }
+        fl::sinks::async_sink third(second_target);
+        third.write("d", 1);
+        first.flush();
+        third.flush();
+        TEST(first_target.text == "ac" && second_target.text == "bd", "async_sink: one slot per sink and thread");
+    }
+
+    std::cout << "\nAll async_sink tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <fl.hpp>
+#include <fl/encoding.hpp>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+using namespace fl::literals;
+
+// A sink with write() only, so the kernels take their chunked path.
+struct string_sink {
+    std::string text;
+    void write(const char* data, std::size_t len) { text.append(data, len); }
+};
+
+// Runs fn into a write-only sink, a growing_sink and a string_builder, and
+// checks that all three agree.
+template <typename Fn>
+static std::string through_sinks(Fn&& fn, bool& same) {
+    string_sink plain;
+    fn(plain);
+    fl::sinks::growing_sink direct;
+    fn(direct);
+    fl::string_builder builder;
+    fn(builder);
+    same = plain.text == std::string(direct.data(), direct.size()) &&
+           plain.text == std::string(builder.data(), builder.size());
+    return plain.text;
+}
+
+template <typename Fn>
+static bool throws_invalid(Fn&& fn) {
+    try {
+        fn();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+// Every byte value, repeated to the given length.
+static std::string byte_pattern(std::size_t size) {
+    std::string bytes(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<char>(i * 7 + i / 256);
+    }
+    return bytes;
+}
+
+int main() {
+    // Base64 against the RFC 4648 test vectors.
+    {
+        bool same = false;
+        const std::pair<std::string_view, std::string_view> vectors[] = {
+            {"", ""},           {"f", "Zg=="},         {"fo", "Zm8="},         {"foo", "Zm9v"},
+            {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+        };
+        bool all = true;
+        for (const auto& [plain, encoded] : vectors) {
+            all = all && through_sinks([&](auto& sink) { fl::base64_encode(sink, plain); }, same) == encoded && same;
+            all = all && std::string_view(fl::base64_encode(plain)) == encoded &&
+                  fl::base64_encoded_size(plain.size()) == encoded.size();
+            all = all && through_sinks([&](auto& sink) { fl::base64_decode(sink, encoded); }, same) == plain && same;
+        }
+        TEST(all, "base64: RFC 4648 vectors");
+
+        const std::string binary = "\xfb\xff\xfe";
+        TEST(fl::base64_encode(binary) == "+//+", "base64: standard alphabet");
+        TEST(fl::base64_encode(binary, fl::base64_alphabet::url) == "-__-", "base64: url alphabet");
+        TEST(fl::base64_encode("f", fl::base64_alphabet::url) == "Zg" &&
+                 fl::base64_encoded_size(1, fl::base64_alphabet::url) == 2,
+             "base64: url alphabet unpadded");
+        TEST(fl::base64_decode("Zg") == "f" && fl::base64_decode("Zm8", fl::base64_alphabet::url) == "fo",
+             "base64: padding optional");
+    }
+
+    // Long inputs cover the vector blocks, their tails and the chunk
+    // boundaries of write-only sinks, at every length mod the block size.
+    {
+        bool same = false;
+        bool all = true;
+        for (std::size_t size : {1u, 11u, 12u, 13u, 23u, 24u, 25u, 47u, 48u, 95u, 767u, 768u, 769u, 5000u}) {
+            const std::string bytes = byte_pattern(size);
+            for (auto alphabet : {fl::base64_alphabet::standard, fl::base64_alphabet::url}) {
+                const std::string encoded =
+                    through_sinks([&](auto& sink) { fl::base64_encode(sink, bytes, alphabet); }, same);
+                all = all && same && encoded.size() == fl::base64_encoded_size(size, alphabet);
+                all = all && std::string_view(fl::base64_encode(bytes, alphabet)) == encoded;
+                all = all && fl::base64_decoded_size(encoded) == size;
+                all = all &&
+                      through_sinks([&](auto& sink) { fl::base64_decode(sink, encoded, alphabet); }, same) == bytes &&
+                      same;
+            }
+        }
+        TEST(all, "base64: round trip at every block position");
+    }
+
+    // Malformed base64.
+    {
+        fl::sinks::growing_sink out;
+        TEST(throws_invalid([&] { fl::base64_decode(out, "Zm9v!mFy"); }), "base64_decode: invalid character");
+        TEST(throws_invalid([&] { (void)fl::base64_decode("Zm9vY"); }), "base64_decode: length 1 mod 4");
+        TEST(throws_invalid([&] { (void)fl::base64_decode("Zg="); }), "base64_decode: short padded group");
+        TEST(throws_invalid([&] { (void)fl::base64_decode("Z==="); }), "base64_decode: three padding bytes");
+        TEST(throws_invalid([&] { (void)fl::base64_decode("Zg==Zg=="); }), "base64_decode: padding inside");
+        TEST(throws_invalid([&] { (void)fl::base64_decode("-__-"); }), "base64_decode: url digits, standard alphabet");
+        std::string long_text = fl::base64_encode(byte_pattern(300)).c_str();
+        long_text[200] = '*';
+        TEST(throws_invalid([&] { (void)fl::base64_decode(long_text); }), "base64_decode: invalid in vector block");
+    }
+
+    // Hex.
+    {
+        bool same = false;
+        const std::string bytes = byte_pattern(1000);
+        std::string expected;
+        for (const char c : bytes) {
+            expected += fl::detail::lower_hex_digits[static_cast<unsigned char>(c) >> 4];
+            expected += fl::detail::lower_hex_digits[static_cast<unsigned char>(c) & 0xF];
+        }
+        TEST(through_sinks([&](auto& sink) { fl::hex_encode(sink, bytes); }, same) == expected && same,
+             "hex_encode: lower case");
+        TEST(fl::hex_encode("\x01\xab\xff", fl::hex_case::upper) == "01ABFF", "hex_encode: upper case");
+        TEST(std::string_view(fl::hex_encode(bytes)) == expected, "hex_encode: fl::string");
+
+        bool all = true;
+        for (std::size_t size = 0; size < 80; ++size) {
+            const std::string part = bytes.substr(0, size);
+            const std::string digits = fl::hex_encode(part, fl::hex_case::upper).c_str();
+            all = all && through_sinks([&](auto& sink) { fl::hex_decode(sink, digits); }, same) == part && same;
+        }
+        TEST(all, "hex: round trip at every length");
+        TEST(fl::hex_decode("DeadBEEF") == "\xde\xad\xbe\xef", "hex_decode: mixed case");
+
+        TEST(throws_invalid([&] { (void)fl::hex_decode("abc"); }), "hex_decode: odd length");
+        TEST(throws_invalid([&] { (void)fl::hex_decode("0g"); }), "hex_decode: invalid digit");
+        std::string long_digits = expected;
+        long_digits[100] = 'x';
+        TEST(throws_invalid([&] { (void)fl::hex_decode(long_digits); }), "hex_decode: invalid in vector block");
+    }
+
+    // Byte spans in the formatter.
+    {
+        const std::array<std::byte, 4> hash = {std::byte{0xde}, std::byte{0xad}, std::byte{0xbe}, std::byte{0xef}};
+        const std::span<const std::byte> bytes(hash);
+        TEST(fl::format("{}", bytes) == "deadbeef", "format: byte span default");
+        TEST(fl::format("{:X}", bytes) == "DEADBEEF", "format: {:X}");
+        TEST(fl::format("{:#x}", bytes) == "0xdeadbeef", "format: {:#x}");
+        TEST(fl::format("[{:>10.2x}]", bytes) == "[      dead]", "format: precision and width");
+        TEST(fl::format("sha={:x}"_fmt, bytes) == "sha=deadbeef", "format: static path");
+
+        const std::vector<unsigned char> raw = {0x00, 0x7f, 0x80};
+        TEST(fl::format("{:x}", std::span<const unsigned char>(raw)) == "007f80", "format: unsigned char span");
+        std::array<std::byte, 2> mutable_bytes = {std::byte{1}, std::byte{2}};
+        TEST(fl::format("{:x}", std::span<std::byte>(mutable_bytes)) == "0102", "format: mutable byte span");
+
+        fl::string_builder builder;
+        fl::format_to(builder, "{:x}", bytes);
+        TEST(std::string_view(builder.data(), builder.size()) == "deadbeef", "format: into string_builder");
+
+        bool threw = false;
+        try {
+            (void)fl::format(fl::runtime_format("{:d}"), bytes);
+        } catch (const fl::format_error&) {
+            threw = true;
+        }
+        TEST(threw, "format: {:d} rejected for byte spans");
+    }
+
+    std::cout << "\nAll encoding tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include <fl.hpp>
+#include <fl/escape.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+using namespace fl::literals;
+
+// A sink with write() only, so the kernels take their run-by-run path.
+struct string_sink {
+    std::string text;
+    void write(const char* data, std::size_t len) { text.append(data, len); }
+};
+
+template <typename Fn>
+static std::string through_sinks(Fn&& fn, bool& same) {
+    string_sink plain;
+    fn(plain);
+    fl::sinks::growing_sink direct;
+    fn(direct);
+    same = plain.text == std::string(direct.data(), direct.size());
+    return plain.text;
+}
+
+template <typename Fn>
+static bool throws_invalid(Fn&& fn) {
+    try {
+        fn();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    // JSON escaping.
+    {
+        bool same = false;
+        const std::string input = std::string("say \"hi\"\\\n\t\x01\x1f end ") + "\xc3\xa9";
+        const std::string expected = "say \\\"hi\\\"\\\\\\n\\t\\u0001\\u001f end \xc3\xa9";
+        const std::string out = through_sinks([&](auto& sink) { fl::json_escape(sink, input); }, same);
+        TEST(out == expected && same, "json_escape: specials and UTF-8");
+        TEST(fl::json_escaped_size(input) == expected.size(), "json_escaped_size: exact");
+
+        // Long inputs exercise the vector blocks and their tails, with the
+        // special byte at every position.
+        bool all = true;
+        for (std::size_t at = 0; at < 70; ++at) {
+            std::string text(70, 'a');
+            text[at] = '"';
+            std::string want(70, 'a');
+            want.replace(at, 1, "\\\"");
+            const std::string got = through_sinks([&](auto& sink) { fl::json_escape(sink, text); }, same);
+            all = all && got == want && same && fl::json_escaped_size(text) == 71;
+        }
+        TEST(all, "json_escape: every block position");
+
+        std::string clean(1000, 'x');
+        TEST(through_sinks([&](auto& sink) { fl::json_escape(sink, clean); }, same) == clean && same,
+             "json_escape: clean text copied");
+        TEST(through_sinks([&](auto& sink) { fl::json_escape(sink, ""); }, same).empty(), "json_escape: empty");
+    }
+
+    // JSON unescaping.
+    {
+        bool same = false;
+        const std::string input = "a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\u0041\\u00e9\\u20AC\\ud83d\\ude00";
+        const std::string expected = "a\"b\\c/d\b\f\n\r\tA\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+        TEST(through_sinks([&](auto& sink) { fl::json_unescape(sink, input); }, same) == expected && same,
+             "json_unescape: escapes and surrogate pairs");
+
+        std::string long_text(100, 'z');
+        long_text += "\\n";
+        long_text += std::string(40, 'y');
+        TEST(through_sinks([&](auto& sink) { fl::json_unescape(sink, long_text); }, same) ==
+                     std::string(100, 'z') + "\n" + std::string(40, 'y') &&
+                 same,
+             "json_unescape: long runs");
+
+        const std::string round = "tab\there \"quoted\" \\ \x02 \xe2\x82\xac";
+        fl::sinks::growing_sink escaped;
+        fl::json_escape(escaped, round);
+        TEST(through_sinks([&](auto& sink) { fl::json_unescape(sink, std::string_view(escaped.data(), escaped.size())); },
+                           same) == round,
+             "json: round trip");
+
+        fl::sinks::growing_sink out;
+        TEST(throws_invalid([&] { fl::json_unescape(out, "bad \\x"); }), "json_unescape: unknown escape");
+        TEST(throws_invalid([&] { fl::json_unescape(out, "cut \\"); }), "json_unescape: trailing backslash");
+        TEST(throws_invalid([&] { fl::json_unescape(out, "\\u12"); }), "json_unescape: short \\u");
+        TEST(throws_invalid([&] { fl::json_unescape(out, "\\u12g4"); }), "json_unescape: bad hex");
+        TEST(throws_invalid([&] { fl::json_unescape(out, "\\ud83d x"); }), "json_unescape: lone high surrogate");
+        TEST(throws_invalid([&] { fl::json_unescape(out, "\\ude00"); }), "json_unescape: lone low surrogate");
+    }
+
+    // HTML and XML escaping.
+    {
+        bool same = false;
+        const std::string input = "<a href=\"x?a=1&b='2'\">caf\xc3\xa9 > tea</a>";
+        const std::string html = "&lt;a href=&quot;x?a=1&amp;b=&#39;2&#39;&quot;&gt;caf\xc3\xa9 &gt; tea&lt;/a&gt;";
+        const std::string xml = "&lt;a href=&quot;x?a=1&amp;b=&apos;2&apos;&quot;&gt;caf\xc3\xa9 &gt; tea&lt;/a&gt;";
+        TEST(through_sinks([&](auto& sink) { fl::html_escape(sink, input); }, same) == html && same,
+             "html_escape: entities");
+        TEST(through_sinks([&](auto& sink) { fl::xml_escape(sink, input); }, same) == xml && same,
+             "xml_escape: &apos;");
+        TEST(fl::html_escaped_size(input) == html.size() && fl::xml_escaped_size(input) == xml.size(),
+             "markup: escaped sizes exact");
+
+        bool all = true;
+        for (std::size_t at = 0; at < 70; ++at) {
+            std::string text(70, 'p');
+            text[at] = '&';
+            std::string want(70, 'p');
+            want.replace(at, 1, "&amp;");
+            all = all && through_sinks([&](auto& sink) { fl::xml_escape(sink, text); }, same) == want && same;
+        }
+        TEST(all, "xml_escape: every block position");
+
+        // Dense input crosses the chunk boundary of write-only sinks.
+        const std::string dense(1000, '<');
+        std::string dense_want;
+        for (int i = 0; i < 1000; ++i) {
+            dense_want += "&lt;";
+        }
+        TEST(through_sinks([&](auto& sink) { fl::html_escape(sink, dense); }, same) == dense_want && same,
+             "html_escape: dense input");
+    }
+
+    // URL percent-encoding.
+    {
+        bool same = false;
+        const std::string input = "a b/c?d=e&f=g~h_i-j.k+caf\xc3\xa9%";
+        const std::string encoded = "a%20b%2Fc%3Fd%3De%26f%3Dg~h_i-j.k%2Bcaf%C3%A9%25";
+        TEST(through_sinks([&](auto& sink) { fl::url_encode(sink, input); }, same) == encoded && same,
+             "url_encode: reserved and non-ASCII bytes");
+        TEST(fl::url_encoded_size(input) == encoded.size(), "url_encoded_size: exact");
+
+        std::string all_bytes;
+        for (int c = 0; c < 256; ++c) {
+            all_bytes += static_cast<char>(c);
+        }
+        fl::sinks::growing_sink out;
+        fl::url_encode(out, all_bytes);
+        const std::string all_encoded(out.data(), out.size());
+        TEST(all_encoded.size() == 66 + 190 * 3, "url_encode: 66 unreserved bytes");
+        TEST(through_sinks([&](auto& sink) { fl::url_decode(sink, all_encoded); }, same) == all_bytes && same,
+             "url_decode: round trip of every byte");
+        TEST(through_sinks([&](auto& sink) { fl::url_decode(sink, "a+b%2fc%2F"); }, same) == "a+b/c/" && same,
+             "url_decode: '+' kept, either hex case");
+
+        TEST(throws_invalid([&] { fl::url_decode(out, "100%"); }), "url_decode: truncated");
+        TEST(throws_invalid([&] { fl::url_decode(out, "%4"); }), "url_decode: one digit");
+        TEST(throws_invalid([&] { fl::url_decode(out, "%zz"); }), "url_decode: bad hex");
+    }
+
+    // string_builder is a direct sink, so every kernel can write into it.
+    {
+        fl::string_builder builder;
+        builder.append("<p>");
+        fl::html_escape(builder, "Tom & Jerry");
+        builder.append("</p>?q=");
+        fl::url_encode(builder, "a b");
+        TEST(std::string_view(builder.data(), builder.size()) == "<p>Tom &amp; Jerry</p>?q=a%20b",
+             "string_builder: html_escape and url_encode");
+        fl::string_builder exact;
+        fl::xml_escape(exact, std::string(100, '"'));
+        TEST(exact.size() == 600 && exact.capacity() >= 600, "string_builder: escaped in one step");
+    }
+
+    // string_builder and the {:j} specifier.
+    {
+        fl::string_builder builder;
+        builder.append("{\"msg\":\"").append_json_escaped("line\n\"q\"").append("\"}");
+        TEST(std::string_view(builder.data(), builder.size()) == "{\"msg\":\"line\\n\\\"q\\\"\"}",
+             "string_builder: append_json_escaped");
+
+        TEST(fl::format("\"{:j}\"", "a\"b\n") == "\"a\\\"b\\n\"", "format: {:j}");
+        TEST(fl::format("[{:>8j}]", "a\"b") == "[    a\\\"b]", "format: {:j} width counts escaped output");
+        TEST(fl::format("[{:.2j}]", "\"\"\"") == "[\\\"\\\"]", "format: {:j} precision counts input");
+        TEST(fl::format("{0:j}|{0}"_fmt, fl::string("x\ty")) == "x\\ty|x\ty", "format: {:j} static path");
+        TEST(fl::format(fl::runtime_format("{:j}"), std::string("\\")) == "\\\\", "format: {:j} runtime path");
+        const fl::rope rope = fl::rope{std::string_view(std::string(20, 'a') + "\"")} +
+                              fl::rope{std::string_view(std::string(20, '\n'))};
+        std::string rope_escaped = std::string(20, 'a') + "\\\"";
+        for (int i = 0; i < 20; ++i) {
+            rope_escaped += "\\n";
+        }
+        TEST(fl::format("{:j}", rope) == rope_escaped, "format: {:j} rope");
+        TEST(fl::format("{:>63j}", rope) == " " + rope_escaped && fl::format("{:>62j}", rope) == rope_escaped,
+             "format: {:j} rope width counts escaped output");
+        bool threw = false;
+        try {
+            (void)fl::format(fl::runtime_format("{:j}"), 42);
+        } catch (const fl::format_error&) {
+            threw = true;
+        }
+        TEST(threw, "format: {:j} rejected for numbers");
+    }
+
+    std::cout << "\nAll escape tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,438 @@
+#include <fl.hpp>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+using namespace fl::literals;
+
+// Formats into a stack buffer and yields the result as a std::string. A macro
+// rather than a function so literal format strings stay constant expressions.
+#define FORMATTED(...) ([&] { \
+        char buffer[512]; \
+        fl::buffer_sink sink(buffer, sizeof(buffer)); \
+        fl::format_to(sink, __VA_ARGS__); \
+        return std::string(buffer, sink.written()); \
+    }())
+
+// Returns true when formatting the runtime string throws fl::format_error.
+template <typename... Args>
+static bool throws_format_error(std::string_view fmt, Args&&... args) {
+    try {
+        char buffer[512];
+        fl::buffer_sink sink(buffer, sizeof(buffer));
+        fl::format_to(sink, fl::runtime_format(fmt), std::forward<Args>(args)...);
+    } catch (const fl::format_error&) {
+        return true;
+    }
+    return false;
+}
+
+// A user sink with only write(): satisfies fl::sinks::character_sink without
+// deriving from output_sink.
+struct collecting_sink {
+    std::string text;
+    std::size_t writes = 0;
+    void write(const char* data, std::size_t len) {
+        text.append(data, len);
+        ++writes;
+    }
+};
+
+// A user sink that lends its storage, so numbers are formatted in place.
+struct direct_buffer_sink {
+    char storage[128];
+    std::size_t size = 0;
+    std::size_t prepared = 0;
+    void write(const char* data, std::size_t len) {
+        std::memcpy(storage + size, data, len);
+        size += len;
+    }
+    std::span<char> prepare(std::size_t len) {
+        ++prepared;
+        if (len > sizeof(storage) - size) {
+            return {};
+        }
+        return {storage + size, sizeof(storage) - size};
+    }
+    void commit(std::size_t len) { size += len; }
+};
+
+// A user type with its own specification: "{}" prints "(x, y)", "{:p}" adds
+// a "pt" prefix.
+struct point {
+    int x;
+    int y;
+};
+
+template <>
+struct fl::formatter<point> {
+    bool prefixed = false;
+
+    constexpr const char* parse(const char* first, const char* last) {
+        if (first != last && *first == 'p') {
+            prefixed = true;
+            ++first;
+        }
+        return first;
+    }
+
+    template <typename Sink>
+    void format(const point& p, Sink& sink) const {
+        fl::format_to(sink, "{}({}, {})", prefixed ? "pt" : "", p.x, p.y);
+    }
+};
+
+// A formatter written against the polymorphic sink only.
+struct tag {
+    const char* name;
+};
+
+template <>
+struct fl::formatter<tag> : fl::formatter<std::string_view> {
+    void format(const tag& t, fl::sinks::output_sink& sink) const {
+        fl::formatter<std::string_view>::format(t.name, sink);
+    }
+};
+
+enum class level : int { debug = 10, error = 40 };
+
+int main() {
+    // Compile-time checked format strings.
+    {
+        TEST(FORMATTED("plain text") == "plain text", "checked: literal only");
+        TEST(FORMATTED("{} + {} = {}", 1, 2, 3) == "1 + 2 = 3", "checked: sequential integers");
+        TEST(FORMATTED("{{{}}}", 7) == "{7}", "checked: escaped braces");
+        TEST(FORMATTED("User {:0>6d} -- {:*^20s}", 42, "Alice") ==
+                 "User 000042 -- ********Alice*******", "checked: fill, align, width");
+        TEST(FORMATTED("{:#x} {:#b} {:#o}", 255, 5, 64) == "0xff 0b101 0100", "checked: base prefixes");
+        TEST(FORMATTED("{:+}", 42) == "+42", "checked: sign");
+        TEST(FORMATTED("{:.2f}", 3.14159) == "3.14", "checked: float precision");
+        TEST(FORMATTED("{} {}", true, 'x') == "true x", "checked: bool and char");
+        TEST(FORMATTED("[{}]", fl::string("flstring")) == "[flstring]", "checked: fl::string argument");
+        TEST(FORMATTED("{:.3}", "abcdef") == "abc", "checked: string precision truncates");
+    }
+
+    // Static format strings expand at compile time and match the checked path.
+    {
+        TEST(FORMATTED("{} + {} = {}"_fmt, 1, 2, 3) == "1 + 2 = 3", "static: sequential integers");
+        TEST(FORMATTED("{{{}}}"_fmt, 7) == "{7}", "static: escaped braces");
+        TEST(FORMATTED("User {:0>6d} -- {:*^20s}"_fmt, 42, "Alice") ==
+                 "User 000042 -- ********Alice*******", "static: fill, align, width");
+        TEST(FORMATTED("{:8.3f}|"_fmt, 2.5) == "   2.500|", "static: float spec");
+        TEST(FORMATTED("no placeholders"_fmt) == "no placeholders", "static: literal only");
+    }
+
+    // Runtime format strings are parsed per call and report errors by throwing.
+    {
+        std::string fmt = "{}-{:>4}";
+        TEST(FORMATTED(fl::runtime_format(fmt), 1, 2) == "1-   2", "runtime: basic formatting");
+        TEST(throws_format_error("{} {}", 1), "runtime: missing argument throws");
+        TEST(throws_format_error("{", 1), "runtime: unmatched '{' throws");
+        TEST(throws_format_error("}", 1), "runtime: unmatched '}' throws");
+        TEST(throws_format_error("{:q}", 1), "runtime: invalid specifier throws");
+        TEST(throws_format_error("{:.2}", 1), "runtime: precision on integer throws");
+        TEST(throws_format_error("{:x}", "text"), "runtime: integer type on string throws");
+        TEST(throws_format_error("{:d}", 1.5), "runtime: integer type on float throws");
+        TEST(!throws_format_error("{:x}", 255), "runtime: valid specifier does not throw");
+    }
+
+    // Type-erased arguments and the non-template engine.
+    {
+        int value = -17;
+        unsigned long long big = 18446744073709551615ull;
+        fl::string name("erased");
+        std::string_view view("view");
+        auto store = fl::make_format_args(value, big, 2.5, name, view, true, 'c');
+        fl::format_args args(store);
+        TEST(args.size() == 7, "erased: argument count");
+        TEST(args.get(0).kind() == fl::format_arg::type::int64, "erased: signed widens to int64");
+        TEST(args.get(1).kind() == fl::format_arg::type::uint64, "erased: unsigned widens to uint64");
+        TEST(args.get(3).kind() == fl::format_arg::type::string, "erased: fl::string becomes a view");
+        TEST(!args.get(7), "erased: out-of-range index is none");
+
+        char buffer[256];
+        fl::buffer_sink sink(buffer, sizeof(buffer));
+        fl::vformat_to(sink, "{} {} {} {} {} {} {}", args);
+        TEST(std::string(buffer, sink.written()) == "-17 18446744073709551615 2.5 erased view true c",
+             "erased: vformat_to formats every tag");
+
+        fl::buffer_sink too_few(buffer, sizeof(buffer));
+        bool threw = false;
+        try {
+            fl::vformat_to(too_few, "{} {}", fl::make_format_args(1));
+        } catch (const fl::format_error&) {
+            threw = true;
+        }
+        TEST(threw, "erased: missing argument throws");
+    }
+
+    // Pointers format as hexadecimal addresses.
+    {
+        const void* p = reinterpret_cast<const void*>(std::uintptr_t{0x1f40});
+        TEST(FORMATTED("{}", p) == "0x1f40", "pointer: hexadecimal address");
+        TEST(FORMATTED("{}", nullptr) == "0x0", "pointer: null");
+        TEST(FORMATTED("[{:>8}]", p) == "[  0x1f40]", "pointer: width");
+    }
+
+    // Characters and booleans stay text under a width; integer types opt in.
+    {
+        TEST(FORMATTED("[{:<3}]", 'x') == "[x  ]", "char: padded as text");
+        TEST(FORMATTED("{:d} {:x}", 'A', 'A') == "65 41", "char: integer presentation");
+        TEST(FORMATTED("[{:>6}]", true) == "[  true]", "bool: padded as text");
+        TEST(FORMATTED("[{:>3c}] [{:s}]", 'x', false) == "[  x] [false]", "char and bool: c and s types");
+        if constexpr (std::is_signed_v<char>) {
+            TEST(FORMATTED("{:d}", char(-1)) == "-1", "char: signed value");
+        }
+        TEST(fl::format("{:d} {:c}", 'A', 'B') == "65 B" && fl::format("{:d}", true) == "1",
+             "char and bool: erased arguments");
+        TEST(throws_format_error("{:s}", 'x') && throws_format_error("{:c}", true) &&
+                 throws_format_error("{:+c}", 'x'),
+             "char and bool: wrong text type rejected");
+    }
+
+    // fl::format and the string destinations size the output before writing.
+    {
+        TEST(fl::formatted_size("{}-{:>6}", 42, "ab") == 9, "size: counts without writing");
+        TEST(fl::formatted_size("{}:{}"_fmt, 7, 0.5) == 5, "size: static format string");
+
+        const fl::string small = fl::format("{} + {} = {}", 1, 2, 3);
+        TEST(std::string_view(small) == "1 + 2 = 3", "format: small result");
+        TEST(small.capacity() < 32, "format: small result stays in SSO");
+
+        const fl::string large = fl::format("{:*>100}|{}", "x", 1.25);
+        TEST(large.size() == 105 && large[99] == 'x' && std::string_view(large).substr(100) == "|1.25",
+             "format: large result");
+        TEST(large.capacity() == fl::string(large.size(), ' ').capacity(), "format: one exact-size heap block");
+        const fl::string longer = fl::format("{:->400}{}", "|", 7);
+        TEST(longer.size() == 401 && longer[398] == '-' && std::string_view(longer).substr(399) == "|7",
+             "format: result larger than the probe buffer");
+        TEST(longer.capacity() == fl::string(longer.size(), ' ').capacity(), "format: second pass fills one block");
+        TEST(std::string_view(fl::format("{}/{}"_fmt, "a", 'b')) == "a/b", "format: static format string");
+        TEST(fl::format("").empty(), "format: empty result");
+
+        fl::string appended("id=");
+        fl::format_to(appended, "{:0>4x}", 255u);
+        TEST(std::string_view(appended) == "id=00ff", "format_to: appends to fl::string");
+
+
+        fl::string_builder builder;
+        builder.append("t=");
+        fl::format_to(builder, "{:.1f}s", 2.25);
+        fl::format_to(builder, " n={}", -3);
+        fl::format_to(builder, "{:.>300}", "!");
+        const fl::string built = std::move(builder).build();
+        TEST(built.size() == 311 && std::string_view(built).substr(0, 11) == "t=2.2s n=-3" && built[310] == '!',
+             "format_to: appends to string_builder");
+        fl::format_to(appended, "{:_<300}", ';');
+        TEST(appended.size() == 307 && appended[7] == ';' && appended[306] == '_', "format_to: long append to fl::string");
+
+        char buffer[8];
+        const auto full = fl::format_to_n(buffer, sizeof(buffer), "{}", 1234);
+        TEST(full.size == 4 && full.out == buffer + 4 && std::string_view(buffer, 4) == "1234",
+             "format_to_n: fits");
+        const auto cut = fl::format_to_n(buffer, sizeof(buffer), "{}-{}", "abcdef", "ghij");
+        TEST(cut.size == 11 && cut.out == buffer + sizeof(buffer) &&
+             std::string_view(buffer, sizeof(buffer)) == "abcdef-g",
+             "format_to_n: truncates and reports the full size");
+        const auto none = fl::format_to_n(buffer, 0, "{}", 5);
+        TEST(none.size == 1 && none.out == buffer, "format_to_n: zero capacity");
+    }
+
+    // Any type with write() is a sink; one with prepare()/commit() is written
+    // in place.
+    {
+        static_assert(fl::sinks::direct_sink<fl::sinks::buffer_sink>);
+        static_assert(fl::sinks::character_sink<collecting_sink>);
+        static_assert(!fl::sinks::direct_sink<collecting_sink>);
+        static_assert(fl::sinks::direct_sink<direct_buffer_sink>);
+
+        collecting_sink text;
+        fl::format_to(text, "x={} y={:>4} {}", 12, 3.5, "end");
+        TEST(text.text == "x=12 y= 3.5 end", "sink concept: user sink with write() only");
+        fl::format_to(text, "|{}|"_fmt, -1);
+        TEST(text.text == "x=12 y= 3.5 end|-1|", "sink concept: static format string");
+        const std::size_t writes = text.writes;
+        fl::format_to(text, "literal text only");
+        TEST(text.writes == writes + 1, "sink concept: literal run is one write");
+        fl::vformat_to(text, "{}", fl::make_format_args('!'));
+        TEST(text.text.back() == '!', "sink concept: vformat_to over a user sink");
+
+        direct_buffer_sink direct;
+        fl::format_to(direct, "{} {} {}", 1234567u, -2.5, "s");
+        TEST(std::string_view(direct.storage, direct.size) == "1234567 -2.5 s", "sink concept: direct sink");
+        TEST(direct.prepared == 2, "sink concept: numbers formatted in place");
+    }
+
+    // fl::formatter<T> specialisations and the built-in string formatters.
+    {
+        const point p{3, -4};
+        TEST(FORMATTED("{}", p) == "(3, -4)", "formatter: checked literal");
+        TEST(FORMATTED("{:p}|{}", p, 1) == "pt(3, -4)|1", "formatter: own specification");
+        TEST(FORMATTED("<{:p}>"_fmt, p) == "<pt(3, -4)>", "formatter: static format string");
+        TEST(FORMATTED(fl::runtime_format("{} {:p}"), p, p) == "(3, -4) pt(3, -4)", "formatter: runtime string");
+        TEST(throws_format_error("{:q}", p), "formatter: rejected specification throws");
+        TEST(std::string_view(fl::format("{}", p)) == "(3, -4)", "formatter: fl::format");
+
+        collecting_sink user;
+        fl::format_to(user, "{:p} {:>5}", p, tag{"t"});
+        TEST(user.text == "pt(3, -4)     t", "formatter: user sink");
+        fl::vformat_to(user, "[{:^5}]", fl::make_format_args(tag{"ab"}));
+        TEST(user.text == "pt(3, -4)     t[  ab ]", "formatter: output_sink-only formatter through the adapter");
+
+        TEST(FORMATTED("{} {:>3}", level::error, level::debug) == "40  10", "enum: underlying value");
+        TEST(FORMATTED("{:x}", level::error) == "28", "enum: integer presentation");
+
+        TEST(FORMATTED("[{:6}]", "ab") == "[ab    ]", "string: left-aligned by default");
+        TEST(FORMATTED("[{:6}]", 42) == "[    42]", "integer: right-aligned by default");
+        TEST(FORMATTED("[{:8}]", reinterpret_cast<const void*>(std::uintptr_t{0xab})) == "[    0xab]",
+             "pointer: right-aligned by default");
+
+        const std::string std_string("std");
+        const fl::immutable_string immutable("imm");
+        const fl::substring_view sub("substring", 3);
+        TEST(FORMATTED("{} {:>4} {:.2}", std_string, immutable, sub) == "std  imm su", "string types: contiguous");
+        TEST(FORMATTED("{:*^7}"_fmt, fl::immutable_string_view("iv")) == "***iv**", "string types: static path");
+
+        const std::string piece_a(9000, 'a');
+        const std::string piece_b(9000, 'b');
+        fl::rope r{std::string_view(piece_a)};
+        r += fl::rope{std::string_view(piece_b)};
+        r += fl::rope("tail");
+        TEST(r.depth() > 1, "rope: several leaves");
+        std::size_t chunks = 0;
+        r.for_each_chunk([&](std::string_view) { ++chunks; });
+        TEST(chunks >= 2, "rope: for_each_chunk visits each leaf");
+
+        const fl::string whole = fl::format("{}", r);
+        TEST(whole.size() == 18004 && whole[8999] == 'a' && whole[9000] == 'b' &&
+             std::string_view(whole).substr(18000) == "tail", "rope: formatted chunk by chunk");
+        TEST(std::string_view(fl::format("{:.9003}", r)).substr(8998) == "aabbb", "rope: precision stops mid-rope");
+        const fl::rope small("xy");
+        TEST(FORMATTED("[{:-^6}]", small) == "[--xy--]", "rope: width and fill");
+        TEST(FORMATTED("[{:>4}]"_fmt, small) == "[  xy]", "rope: static format string");
+        TEST(throws_format_error("{:d}", small), "rope: integer type rejected");
+    }
+
+    // Padding is written as bulk fills, in place on direct sinks.
+    {
+        collecting_sink text;
+        fl::format_to(text, "{:*>150}|{:-<70}|{:_^131}", 7, "s", 'c');
+        TEST(text.text.size() == 150 + 1 + 70 + 1 + 131 && text.text.find_first_not_of('*') == 149 &&
+             text.text.substr(150, 3) == "|s-" && text.text.back() == '_' && text.text[222 + 65] == 'c',
+             "fill: long runs through write()");
+        TEST(text.writes <= 16, "fill: runs are written in blocks");
+
+        direct_buffer_sink direct;
+        fl::format_to(direct, "{:.>100}", 1.5);
+        TEST(direct.size == 100 && direct.storage[96] == '.' && std::string_view(direct.storage + 97, 3) == "1.5",
+             "fill: direct sink filled in place");
+
+        char small[10];
+        const auto cut = fl::format_to_n(small, sizeof(small), "{:#>40}", 1);
+        TEST(cut.size == 40 && std::string_view(small, sizeof(small)) == "##########", "fill: truncated run");
+        TEST(fl::formatted_size("{:>1000}", 'x') == 1000, "fill: counted without writing");
+    }
+
+    // Compile-time validation accepts the same grammar in constant evaluation.
+    {
+        constexpr fl::format_string<int, const char*> checked("{:>5}: {:<8s}");
+        TEST(checked.is_checked(), "checked: validated at compile time");
+        TEST(checked.get() == "{:>5}: {:<8s}", "checked: view preserved");
+    }
+
+    // Positional and named arguments.
+    {
+        TEST(FORMATTED("{1} {0}", "world", "hello") == "hello world", "positional: reordered");
+        TEST(FORMATTED("{0}{0}{1:>3}", 'a', 7) == "aa  7", "positional: repeated index with spec");
+        TEST(FORMATTED("{1} {0}"_fmt, 1, 2) == "2 1", "positional: static");
+        TEST(FORMATTED(fl::runtime_format("{2}-{1}-{0}"), 1, 2, 3) == "3-2-1", "positional: runtime");
+
+        TEST(FORMATTED("{user} has {n} items", fl::arg("user", "alice"), fl::arg("n", 3)) ==
+                 "alice has 3 items", "named: runtime names");
+        TEST(FORMATTED("{n:>4}|{user:.3}", fl::arg<"user">("alice"), fl::arg<"n">(3)) == "   3|ali",
+             "named: static names with specs");
+        TEST(FORMATTED("{user}/{}"_fmt, fl::arg<"user">("bob")) == "bob/bob", "named: static format string");
+        TEST(FORMATTED("{id:#x} {}"_fmt, fl::arg("id", 255)) == "0xff 255", "named: deferred lookup");
+        TEST(FORMATTED("{p:p}", fl::arg("p", point{1, 2})) == "pt(1, 2)", "named: custom formatter");
+        TEST(FORMATTED(fl::runtime_format("{b}{a}"), fl::arg<"a">(1), fl::arg("b", 2)) == "21",
+             "named: runtime format string");
+        TEST(fl::format("{x}-{y}", fl::arg("x", 1.5), fl::arg("y", true)) == "1.5-true", "named: fl::format");
+
+        TEST(throws_format_error("{0} {}", 1, 2), "positional: manual then automatic throws");
+        TEST(throws_format_error("{} {1}", 1, 2), "positional: automatic then manual throws");
+        TEST(throws_format_error("{2}", 1, 2), "positional: index out of range throws");
+        TEST(throws_format_error("{missing}", fl::arg("present", 1)), "named: unknown name throws");
+        TEST(throws_format_error("{n:s}", fl::arg("n", 1)), "named: spec checked against the value");
+        TEST(throws_format_error("{0x}", 1), "positional: trailing characters throw");
+
+        bool threw = false;
+        try {
+            (void)FORMATTED("{other}"_fmt, fl::arg("name", 1));
+        } catch (const fl::format_error&) {
+            threw = true;
+        }
+        TEST(threw, "named: deferred lookup miss throws");
+    }
+
+    // Compiled formats parse a runtime string once and render it many times.
+    {
+        std::string text = "{}: {:>5}|{name:.2f}";
+        const fl::compiled_format compiled(text);
+        text.assign(text.size(), '?');  // The compiled format owns its text.
+        TEST(compiled.segment_count() == 3, "compiled: one segment per placeholder");
+        TEST(std::string_view(compiled.literal(1).data(), compiled.literal(1).size()) == ": ",
+             "compiled: literal is a slice of the source");
+        TEST(FORMATTED(compiled, "a", 7, fl::arg("name", 1.0)) == "a:     7|1.00", "compiled: render");
+        TEST(FORMATTED(compiled, "b", 12345, fl::arg<"name">(2.5)) == "b: 12345|2.50", "compiled: render again");
+
+        collecting_sink user;
+        fl::format_to(user, compiled, 'c', 1, fl::arg("name", 0.125));
+        TEST(user.text == "c:     1|0.12", "compiled: user sink");
+
+        const fl::compiled_format copy = compiled;
+        TEST(copy.source().data() == compiled.source().data(), "compiled: copies share the text");
+        TEST(fl::format(copy, 1, 2, fl::arg("name", 3.0)) == "1:     2|3.00", "compiled: fl::format");
+        TEST(fl::formatted_size(copy, 1, 2, fl::arg("name", 3.0)) == 13, "compiled: formatted_size");
+
+        const fl::compiled_format positional(std::string_view("{1}{0}{1}"));
+        TEST(FORMATTED(positional, 'a', 'b') == "bab", "compiled: positional");
+        TEST(FORMATTED(fl::compiled_format(std::string_view(""))).empty(), "compiled: empty");
+
+        auto compile_throws = [](std::string_view fmt) {
+            try {
+                fl::compiled_format bad(fmt);
+            } catch (const fl::format_error&) {
+                return true;
+            }
+            return false;
+        };
+        TEST(compile_throws("{"), "compiled: unmatched brace throws at construction");
+        TEST(compile_throws("{0} {}"), "compiled: mixed indexing throws at construction");
+
+        auto render_throws = [](const fl::compiled_format& fmt, auto&&... args) {
+            try {
+                (void)fl::format(fmt, args...);
+            } catch (const fl::format_error&) {
+                return true;
+            }
+            return false;
+        };
+        TEST(render_throws(compiled, 1, 2), "compiled: missing argument throws");
+        TEST(render_throws(compiled, 1, 2, fl::arg("other", 3.0)), "compiled: unknown name throws");
+        TEST(render_throws(compiled, 1, "x", fl::arg("name", 3.0)) == false, "compiled: width on text is fine");
+        TEST(render_throws(compiled, 1, 2, fl::arg("name", 3)), "compiled: spec checked against the type");
+    }
+
+    std::cout << "\nAll format tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <fl.hpp>
+#include <fl/format_record.hpp>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+using namespace fl::literals;
+
+template <typename Sink>
+static std::string rendered(const fl::format_record& record) {
+    Sink sink;
+    record.render(sink);
+    return std::string(sink.data(), sink.size());
+}
+
+struct point {
+    int x;
+    int y;
+};
+
+template <>
+inline constexpr bool fl::enable_deferred_copy<point> = true;
+
+template <>
+struct fl::formatter<point> {
+    constexpr const char* parse(const char* first, const char*) { return first; }
+
+    template <typename Sink>
+    void format(const point& p, Sink& sink) const {
+        fl::format_to(sink, "({}, {})", p.x, p.y);
+    }
+};
+
+int main() {
+    // Capture now, render later, with the same output as fl::format.
+    {
+        alignas(16) std::array<std::byte, 256> buffer;
+        std::string name = "alice";
+        auto record = fl::format_record::capture(buffer, "user={} id={:>4} ratio={:.2f} hex={:#x} at {}", name, 42,
+                                                 0.125, 255u, point{3, 4});
+        name = "changed";  // Strings are copied into the buffer.
+        const std::string expected = "user=alice id=  42 ratio=0.12 hex=0xff at (3, 4)";
+        TEST(rendered<fl::sinks::growing_sink>(record) == expected, "capture: render matches format");
+        TEST(rendered<fl::sinks::growing_sink>(record) == expected, "capture: render is repeatable");
+        TEST(record.size() <= buffer.size() && !record.empty(), "capture: size");
+    }
+
+    // Static format strings store only the arguments.
+    {
+        alignas(16) std::array<std::byte, 128> buffer;
+        auto record = fl::format_record::capture(buffer, "{:>6}|{}|{n}"_fmt, "right", fl::substring_view("sub"),
+                                                 fl::arg<"n">(7));
+        TEST(rendered<fl::sinks::growing_sink>(record) == " right|sub|7", "static: named and positional");
+        TEST(fl::format_record::required_size("{}"_fmt, 1) == sizeof(int) + 15, "static: no format text stored");
+    }
+
+    // Runtime format strings are copied with the arguments.
+    {
+        std::vector<std::byte> buffer(128);
+        std::string pattern = "runtime {} {}";
+        auto record = fl::format_record::capture(buffer, fl::runtime_format(pattern), 'x', 1.5);
+        pattern = "overwritten";
+        TEST(rendered<fl::sinks::growing_sink>(record) == "runtime x 1.5", "runtime: format text copied");
+    }
+
+    // immutable_string is held by reference count, not copied: the record
+    // keeps the text alive after the original handle is gone.
+    {
+        alignas(16) std::array<std::byte, 128> buffer;
+        fl::format_record record;
+        {
+            const fl::immutable_string shared(std::string(100, 's'));
+            record = fl::format_record::capture(buffer, "[{:.5}]", shared);
+            TEST(record.size() < 100, "immutable: handle stored, not text");
+        }
+        fl::format_record moved = std::move(record);
+        TEST(record.empty() && rendered<fl::sinks::growing_sink>(record).empty(), "immutable: moved-from is empty");
+        TEST(rendered<fl::sinks::growing_sink>(moved) == "[sssss]", "immutable: rendered after original released");
+    }
+
+    // Byte spans are copied: the record renders after their storage is gone.
+    {
+        alignas(16) std::array<std::byte, 128> buffer;
+        fl::format_record record;
+        {
+            std::vector<std::byte> digest{std::byte{0xde}, std::byte{0xad}, std::byte{0xbe}, std::byte{0xef}};
+            const std::vector<unsigned char> tail{0x01, 0x02};
+            record = fl::format_record::capture(buffer, "{:x}/{:#X}/{}", std::span<const std::byte>(digest),
+                                                std::span<const unsigned char, 2>(tail.data(), 2),
+                                                std::span<std::byte>(digest).first(1));
+            digest.assign(4, std::byte{0});
+        }
+        TEST(rendered<fl::sinks::growing_sink>(record) == "deadbeef/0X0102/de", "bytes: rendered after storage freed");
+    }
+
+    // Any character sink can receive the output.
+    {
+        alignas(16) std::array<std::byte, 64> buffer;
+        auto record = fl::format_record::capture(buffer, "{}-{}", 1, 2);
+        char out[8];
+        fl::sinks::buffer_sink sink(out, sizeof(out));
+        record.render(sink);
+        TEST(std::string(out, sink.written()) == "1-2", "sinks: buffer_sink");
+        fl::sinks::null_sink discard;
+        record.render(discard);
+        TEST(true, "sinks: null_sink");
+    }
+
+    // A buffer that is too small is rejected before anything is written.
+    {
+        const fl::immutable_string shared("s");
+        std::array<std::byte, 8> small;
+        bool threw = false;
+        try {
+            (void)fl::format_record::capture(small, "{} {}", shared, 1);
+        } catch (const std::overflow_error&) {
+            threw = true;
+        }
+        TEST(threw, "errors: buffer too small");
+        const std::size_t needed = fl::format_record::required_size("{} {}", shared, 1);
+        std::vector<std::byte> exact(needed + 1);
+        auto record = fl::format_record::capture(std::span<std::byte>(exact.data() + 1, needed), "{} {}",
+                                                 shared, 1);
+        TEST(rendered<fl::sinks::growing_sink>(record) == "s 1", "errors: required_size covers any alignment");
+    }
+
+    std::cout << "\nAll format_record tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <fl.hpp>
+#include <fl/lines.hpp>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+using lines_t = std::vector<std::string>;
+
+static lines_t reference_lines(std::string_view text) {
+    lines_t out;
+    std::size_t start = 0;
+    while (start < text.size()) {
+        std::size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            out.emplace_back(text.substr(start));
+            break;
+        }
+        std::string_view line = text.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        out.emplace_back(line);
+        start = end + 1;
+    }
+    return out;
+}
+
+static lines_t collect(const fl::line_view& view) {
+    lines_t out;
+    for (const std::string_view line : view) {
+        out.emplace_back(line);
+    }
+    return out;
+}
+
+template <typename Text>
+static lines_t collect_each(const Text& text) {
+    lines_t out;
+    fl::for_each_line(text, [&](std::string_view line) { out.emplace_back(line); });
+    return out;
+}
+
+int main() {
+    // Basic splitting.
+    {
+        TEST(collect(fl::lines("a\nb\r\nc")) == (lines_t{"a", "b", "c"}),
+             "lines: LF, CRLF and a last line without one");
+        TEST(collect(fl::lines("a\n")) == (lines_t{"a"}), "lines: no empty line after a final newline");
+        TEST(collect(fl::lines("\n\r\n\n")) == (lines_t{"", "", ""}), "lines: empty lines");
+        TEST(collect(fl::lines("")).empty() && fl::lines("").begin() == fl::lines("").end(), "lines: empty text");
+        TEST(collect(fl::lines("a\rb\r")) == (lines_t{"a\rb\r"}), "lines: a lone CR is not a line break");
+
+        const std::string text = "first\nsecond\n";
+        const std::string_view first = *fl::lines(text).begin();
+        TEST(first.data() == text.data() && first.size() == 5, "lines: views into the text");
+
+        const fl::string owned("x\r\ny");
+        const fl::substring_view part(owned, 0, 3);
+        TEST(collect(fl::lines(owned)) == (lines_t{"x", "y"}) && collect(fl::lines(part)) == (lines_t{"x"}),
+             "lines: fl::string and substring_view");
+        TEST(collect_each(part) == (lines_t{"x"}), "for_each_line: substring_view");
+
+        const fl::line_view view = fl::lines("1\n2\n3\n4");
+        TEST(std::distance(view.begin(), view.end()) == 4, "lines: forward range");
+
+        std::size_t seen = 0;
+        fl::for_each_line(std::string_view("a\nb\nc\n"), [&](std::string_view) { return ++seen < 2; });
+        TEST(seen == 2, "for_each_line: returning false stops");
+    }
+
+    // Random text at many lengths, so newlines land in every position of a
+    // 64-byte block and in the tail.
+    {
+        std::mt19937 rng(41);
+        const std::string alphabet = "ab\r\n";
+        bool all = true;
+        for (int round = 0; round < 3000 && all; ++round) {
+            std::string text(static_cast<std::size_t>(rng() % 300), 'a');
+            const unsigned newline_odds = 2 + rng() % 60;
+            for (char& c : text) {
+                const unsigned pick = rng() % newline_odds;
+                c = pick == 0 ? '\n' : pick == 1 ? '\r' : alphabet[rng() % 2];
+            }
+            const lines_t expected = reference_lines(text);
+            all = all && collect(fl::lines(text)) == expected && collect_each(std::string_view(text)) == expected;
+        }
+        TEST(all, "lines / for_each_line: random text matches the reference");
+    }
+
+    // Ropes: lines spanning leaves, including a CRLF split between them.
+    {
+        // Adjacent leaves are merged up to 8 KB, so each piece is longer
+        // than half of that.
+        const std::string pieces[] = {"alpha\n" + std::string(4200, 'x') + "be", "ta" + std::string(4200, 'y') + "\r",
+                                      "\n" + std::string(4200, 'z') + "\n", "\n" + std::string(4200, 'w')};
+        fl::rope rope;
+        for (const std::string& piece : pieces) {
+            rope = rope + fl::rope(std::string_view(piece));
+        }
+        std::size_t leaves = 0;
+        rope.for_each_chunk([&](std::string_view) { ++leaves; });
+        const lines_t expected = {"alpha", std::string(4200, 'x') + "beta" + std::string(4200, 'y'),
+                                  std::string(4200, 'z'), "", std::string(4200, 'w')};
+        TEST(leaves == 4 && collect_each(rope) == expected, "for_each_line: rope lines across leaves, split CRLF");
+
+        std::mt19937 rng(43);
+        bool all = true;
+        for (int round = 0; round < 200 && all; ++round) {
+            std::string text(static_cast<std::size_t>(rng() % 40000), 'a');
+            const unsigned newline_odds = 2 + rng() % 6000;
+            for (char& c : text) {
+                const unsigned pick = rng() % newline_odds;
+                c = pick == 0 ? '\n' : pick == 1 ? '\r' : 'x';
+            }
+            fl::rope chunked;
+            for (std::size_t at = 0; at < text.size();) {
+                const std::size_t size = std::min<std::size_t>(4100 + rng() % 4000, text.size() - at);
+                chunked = chunked + fl::rope(std::string_view(text).substr(at, size));
+                at += size;
+            }
+            all = all && collect_each(chunked) == reference_lines(text);
+        }
+        TEST(all, "for_each_line: random ropes match the reference");
+
+        std::size_t seen = 0;
+        fl::for_each_line(rope, [&](std::string_view) { return ++seen < 3; });
+        TEST(seen == 3, "for_each_line: rope stops early");
+    }
+
+    std::cout << "\nAll lines tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include <fl.hpp>
+#include <fl/log.hpp>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+using namespace fl::literals;
+
+static std::string text_of(const fl::sinks::growing_sink& sink) {
+    return std::string(sink.data(), sink.size());
+}
+
+static std::size_t count_lines(std::string_view text) {
+    std::size_t lines = 0;
+    for (char c : text) {
+        lines += c == '\n';
+    }
+    return lines;
+}
+
+struct point {
+    int x;
+    int y;
+};
+
+template <>
+inline constexpr bool fl::enable_deferred_copy<point> = true;
+
+template <>
+struct fl::formatter<point> {
+    constexpr const char* parse(const char* first, const char*) { return first; }
+
+    template <typename Sink>
+    void format(const point& p, Sink& sink) const {
+        fl::format_to(sink, "({}, {})", p.x, p.y);
+    }
+};
+
+// A sink whose every write fails.
+class failing_sink final : public fl::sinks::output_sink {
+public:
+    void write(const char*, std::size_t) override { throw std::runtime_error("disk full"); }
+};
+
+int main() {
+    // Records are formatted on the logger thread with the fl engine.
+    {
+        fl::sinks::growing_sink out;
+        fl::log::logger log(out);
+        std::string name = "alice";
+        log.info("user={} id={:>4} ratio={:.2f} at {}", name, 42, 0.125, point{3, 4});
+        name = "changed";  // Arguments are copied by the call.
+        log.warn("{n}: {}"_fmt, fl::arg<"n">(7), fl::immutable_string("shared"));
+        {
+            std::string pattern = "runtime {}";
+            log.error(fl::runtime_format(pattern), 'x');
+            pattern = "overwritten";
+        }
+        log.flush();
+        TEST(text_of(out) ==
+                 "[info] user=alice id=  42 ratio=0.12 at (3, 4)\n"
+                 "[warn] 7: 7\n"
+                 "[error] runtime x\n",
+             "log: records formatted in order");
+    }
+
+    // Levels below the minimum are skipped at the call site.
+    {
+        fl::sinks::growing_sink out;
+        fl::log::options opts;
+        opts.min_level = fl::log::level::warn;
+        opts.level_prefix = false;
+        fl::log::logger log(out, opts);
+        TEST(!log.enabled(fl::log::level::info) && log.enabled(fl::log::level::error), "level: enabled()");
+        log.info("hidden");
+        log.error("shown {}", 1);
+        log.set_level(fl::log::level::trace);
+        log.trace("trace {}", 2);
+        log.flush();
+        TEST(text_of(out) == "shown 1\ntrace 2\n", "level: filter and set_level");
+    }
+
+    // Text arguments of every kind are copied; ropes without flattening.
+    {
+        fl::sinks::growing_sink out;
+        fl::log::options opts;
+        opts.level_prefix = false;
+        fl::log::logger log(out, opts);
+        const fl::rope rope = fl::rope{std::string_view(std::string(9000, 'a'))} +
+                              fl::rope{std::string_view(std::string(9000, 'b'))};
+        log.info("{}|{}|{}|{:.3}", fl::string("fl"), std::string_view("view"), fl::substring_view("sub"), rope);
+        log.info("{}", rope);
+        log.flush();
+        const std::string text = text_of(out);
+        TEST(text.substr(0, 15) == "fl|view|sub|aaa", "text: string types copied");
+        TEST(text.size() == 16 + 18001 && text.compare(16 + 8995, 10, "aaaaabbbbb") == 0, "text: rope copied");
+    }
+
+    // Byte spans are copied as their bytes.
+    {
+        fl::sinks::growing_sink out;
+        fl::log::options opts;
+        opts.level_prefix = false;
+        fl::log::logger log(out, opts);
+        {
+            const std::vector<std::byte> digest{std::byte{0xca}, std::byte{0xfe}};
+            log.info("sha={:x}", std::span<const std::byte>(digest));
+        }
+        log.flush();
+        TEST(text_of(out) == "sha=cafe\n", "bytes: copied into the record");
+    }
+
+    // Each thread logs into its own ring; lines from one thread keep their order.
+    {
+        fl::sinks::growing_sink out;
+        fl::log::options opts;
+        opts.level_prefix = false;
+        opts.ring_capacity = 4096;  // Small enough that producers wait for room.
+        fl::log::logger log(out, opts);
+        constexpr int threads = 4;
+        constexpr int lines_each = 2000;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&log, t] {
+                for (int i = 0; i < lines_each; ++i) {
+                    log.info("{} {}", t, i);
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        log.flush();
+        const std::string text = text_of(out);
+        TEST(count_lines(text) == threads * lines_each, "threads: every line written");
+        int next[threads] = {};
+        bool ordered = true;
+        std::size_t pos = 0;
+        while (pos < text.size()) {
+            const std::size_t end = text.find('\n', pos);
+            const std::size_t space = text.find(' ', pos);
+            const int t = std::stoi(text.substr(pos, space - pos));
+            const int i = std::stoi(text.substr(space + 1, end - space - 1));
+            ordered = ordered && i == next[t]++;
+            pos = end + 1;
+        }
+        TEST(ordered, "threads: per-thread order kept");
+        TEST(log.dropped() == 0, "threads: blocking policy drops nothing");
+    }
+
+    // Overflow handling.
+    {
+        fl::sinks::growing_sink out;
+        fl::log::options opts;
+        opts.ring_capacity = 1024;
+        opts.overflow = fl::log::overflow_policy::drop;
+        fl::log::logger log(out, opts);
+        log.info("{}", std::string(2000, 'x'));
+        log.flush();
+        TEST(log.dropped() == 1 && out.size() == 0, "overflow: record larger than the ring is dropped");
+    }
+
+    // Stopping writes everything queued; later calls are discarded.
+    {
+        fl::sinks::growing_sink out;
+        {
+            fl::log::logger log(out);
+            for (int i = 0; i < 100; ++i) {
+                log.info("{}", i);
+            }
+        }
+        TEST(count_lines(text_of(out)) == 100, "stop: destructor drains");
+
+        fl::sinks::growing_sink after;
+        fl::log::logger log(after);
+        log.stop();
+        log.info("late {}", 1);
+        log.flush();
+        TEST(after.size() == 0, "stop: later calls discarded");
+    }
+
+    // Failures on the logger thread are counted rather than thrown.
+    {
+        failing_sink broken;
+        fl::log::logger log(broken);
+        log.info("a {}", 1);
+        log.info("b {}", 2);
+        log.flush();
+        TEST(log.dropped() == 2, "errors: failed writes counted as dropped");
+    }
+
+    std::cout << "\nAll log tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <fl.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+using fl::detail::float_formatter;
+using fl::detail::integer_formatter;
+
+// Reference conversion through std::to_chars.
+template <typename T>
+static std::string reference(T value, int base = 10) {
+    char buffer[80];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, base);
+    return std::string(buffer, result.ptr);
+}
+
+static std::string decimal(int64_t value) {
+    char buffer[integer_formatter::max_decimal_chars];
+    return std::string(buffer, integer_formatter::format_int64(buffer, sizeof(buffer), value));
+}
+
+static std::string decimal(uint64_t value) {
+    char buffer[integer_formatter::max_decimal_chars];
+    return std::string(buffer, integer_formatter::format_uint64(buffer, sizeof(buffer), value));
+}
+
+static std::string pow2(uint64_t value, unsigned shift) {
+    char buffer[integer_formatter::max_chars];
+    return std::string(buffer, integer_formatter::write_pow2(buffer, value, shift));
+}
+
+template <typename Float>
+static std::string shortest(Float value) {
+    char buffer[float_formatter::max_shortest_chars];
+    return std::string(buffer, float_formatter::format_shortest(buffer, value));
+}
+
+template <typename Float>
+static std::string shortest_reference(Float value) {
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return std::string(buffer, result.ptr);
+}
+
+// Formats through float_formatter with the printf conversion of the same
+// name, growing the buffer when the first attempt reports it is too small.
+static std::string with_precision(char conversion, double value, int precision) {
+    std::string out(32, '\0');
+    auto run = [&] {
+        switch (conversion) {
+            case 'f': return float_formatter::format_fixed(out.data(), out.size(), value, precision);
+            case 'e': return float_formatter::format_scientific(out.data(), out.size(), value, precision);
+            default: return float_formatter::format_general(out.data(), out.size(), value, precision);
+        }
+    };
+    std::size_t len = run();
+    if (len > out.size()) {
+        out.resize(len);
+        len = run();
+    }
+    out.resize(len);
+    return out;
+}
+
+static std::string printf_reference(char conversion, double value, int precision) {
+    const char format[] = {'%', '.', '*', conversion, '\0'};
+    std::string out(static_cast<std::size_t>(std::snprintf(nullptr, 0, format, precision, value)), '\0');
+    std::snprintf(out.data(), out.size() + 1, format, precision, value);
+    return out;
+}
+
+#define FORMATTED(...) ([&] { \
+        char buffer[256]; \
+        fl::buffer_sink sink(buffer, sizeof(buffer)); \
+        fl::format_to(sink, __VA_ARGS__); \
+        return std::string(buffer, sink.written()); \
+    }())
+
+int main() {
+    // Digit counting at every power-of-ten boundary.
+    {
+        bool ok = integer_formatter::count_digits(0) == 1;
+        uint64_t power = 1;
+        for (unsigned digits = 1; digits <= 20; ++digits) {
+            ok = ok && integer_formatter::count_digits(power) == digits;
+            if (power > 1) ok = ok && integer_formatter::count_digits(power - 1) == digits - 1;
+            if (digits < 20) power *= 10;
+        }
+        ok = ok && integer_formatter::count_digits(std::numeric_limits<uint64_t>::max()) == 20;
+        TEST(ok, "count_digits: exact at every power of ten");
+    }
+
+    // Decimal edge cases.
+    {
+        TEST(decimal(int64_t{0}) == "0", "decimal: zero");
+        TEST(decimal(int64_t{-1}) == "-1", "decimal: minus one");
+        TEST(decimal(std::numeric_limits<int64_t>::min()) == "-9223372036854775808", "decimal: INT64_MIN");
+        TEST(decimal(std::numeric_limits<int64_t>::max()) == "9223372036854775807", "decimal: INT64_MAX");
+        TEST(decimal(std::numeric_limits<uint64_t>::max()) == "18446744073709551615", "decimal: UINT64_MAX");
+
+        char small[3];
+        TEST(integer_formatter::format_int64(small, sizeof(small), -100) == 0, "decimal: too small reports 0");
+    }
+
+    // Randomised comparison against std::to_chars across all magnitudes.
+    {
+        std::mt19937_64 rng(12345);
+        bool ok = true;
+        for (int i = 0; i < 200000 && ok; ++i) {
+            uint64_t bits = rng() >> (rng() % 64);
+            int64_t signed_value = static_cast<int64_t>(rng()) >> (rng() % 64);
+            ok = decimal(bits) == reference(bits) && decimal(signed_value) == reference(signed_value) &&
+                 pow2(bits, 4) == reference(bits, 16) && pow2(bits, 3) == reference(bits, 8) &&
+                 pow2(bits, 1) == reference(bits, 2);
+        }
+        TEST(ok, "random: decimal, hex, octal, binary match std::to_chars");
+    }
+
+    // format_to integer specs keep full unsigned range and signed minimum.
+    {
+        TEST(FORMATTED("{:x}", std::numeric_limits<uint64_t>::max()) == "ffffffffffffffff", "spec: uint64 max hex");
+        TEST(FORMATTED("{:>22}", std::numeric_limits<uint64_t>::max()) == "  18446744073709551615",
+             "spec: uint64 max padded");
+        TEST(FORMATTED("{:d}", std::numeric_limits<int64_t>::min()) == "-9223372036854775808", "spec: INT64_MIN");
+        TEST(FORMATTED("{:#X}", 48879) == "0XBEEF", "spec: upper hex with prefix");
+        TEST(FORMATTED("{:#o} {:#b}", 8, 0) == "010 0", "spec: octal prefix, zero without prefix");
+        TEST(FORMATTED("{:+0=8x}", 255) == "+00000ff", "spec: sign with zero padding");
+        TEST(FORMATTED("{}", std::numeric_limits<int64_t>::min()) == "-9223372036854775808", "default: INT64_MIN");
+    }
+
+    // Shortest floating-point output matches std::to_chars.
+    {
+        TEST(shortest(0.1) == "0.1", "shortest: 0.1");
+        TEST(shortest(0.1f) == "0.1", "shortest: 0.1f");
+        TEST(shortest(-0.0) == "-0", "shortest: negative zero");
+        TEST(shortest(1e22) == "1e+22", "shortest: scientific when shorter");
+        TEST(shortest(123456.0) == "123456", "shortest: integer stays fixed");
+        TEST(shortest(5e-324) == "5e-324", "shortest: smallest subnormal");
+        TEST(shortest(std::numeric_limits<double>::max()) == "1.7976931348623157e+308", "shortest: double max");
+        TEST(shortest(std::numeric_limits<double>::infinity()) == "inf", "shortest: infinity");
+        TEST(shortest(-std::numeric_limits<double>::quiet_NaN()) == "-nan", "shortest: negative NaN");
+
+        std::mt19937_64 rng(0x5EEDF10A7ull);
+        bool ok = true;
+        for (int i = 0; i < 1000000 && ok; ++i) {
+            const uint64_t bits = rng();
+            double d;
+            float f;
+            const uint32_t low = static_cast<uint32_t>(bits);
+            std::memcpy(&d, &bits, sizeof(d));
+            std::memcpy(&f, &low, sizeof(f));
+            if (i % 2 == 0) d = static_cast<double>(bits % 1000000) / 1000.0;  // Short decimals.
+            if (!std::isnan(d)) ok = shortest(d) == shortest_reference(d);
+            if (ok && !std::isnan(f)) ok = shortest(f) == shortest_reference(f);
+        }
+        TEST(ok, "random: shortest double and float match std::to_chars");
+    }
+
+    // Fixed, scientific and general precision match printf exactly.
+    {
+        TEST(with_precision('f', 2.5, 0) == "2", "fixed: ties round to even");
+        TEST(with_precision('f', 0.125, 2) == "0.12", "fixed: exact binary tie");
+        TEST(with_precision('f', 1e300, 2).size() == 304, "fixed: wide integer part");
+        TEST(with_precision('e', 5e-324, 30) == printf_reference('e', 5e-324, 30), "scientific: subnormal digits");
+        TEST(with_precision('g', 100000.0, 6) == "100000", "general: fixed below precision");
+        TEST(with_precision('g', 1000000.0, 6) == "1e+06", "general: scientific at precision");
+
+        std::mt19937_64 rng(0xF1C5ED);
+        bool ok = true;
+        for (int i = 0; i < 200000 && ok; ++i) {
+            const uint64_t bits = rng();
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            if (i % 2 == 0) d = static_cast<double>(bits % 100000000) / 997.0;
+            if (std::isnan(d)) continue;
+            const int precision = static_cast<int>(rng() % 25);
+            for (char conversion : {'f', 'e', 'g'}) {
+                ok = ok && with_precision(conversion, d, precision) == printf_reference(conversion, d, precision);
+            }
+        }
+        TEST(ok, "random: fixed, scientific and general match printf");
+    }
+
+    // format_to float specs.
+    {
+        TEST(FORMATTED("{}", 0.3) == "0.3", "default: shortest double");
+        TEST(FORMATTED("{}", 1.1f) == "1.1", "default: shortest float");
+        TEST(FORMATTED("{:.2f}", 3.14159) == "3.14", "spec: fixed precision");
+        TEST(FORMATTED("{:.3e}", 1234.5) == "1.234e+03", "spec: scientific precision");
+        TEST(FORMATTED("{:E}", 0.5) == "5.000000E-01", "spec: upper scientific default precision");
+        TEST(FORMATTED("{:F}", -std::numeric_limits<double>::infinity()) == "-INF", "spec: upper fixed infinity");
+        TEST(FORMATTED("{:.3}", 2.0 / 3.0) == "0.667", "spec: bare precision is significant digits");
+        TEST(FORMATTED("{:+.1f}", 2.0) == "+2.0", "spec: plus sign");
+        TEST(FORMATTED("{:0=8.2f}", -1.5) == "-0001.50", "spec: numeric padding after sign");
+        TEST(FORMATTED("{:*^9}", 0.25) == "***0.25**", "spec: centred shortest");
+        TEST(FORMATTED("{:.40f}", 0.1) == printf_reference('f', 0.1, 40), "spec: long fixed output");
+        TEST(FORMATTED(fl::runtime_format("{:.1f}"), 0.05f) == "0.1", "runtime: float precision");
+        TEST(fl::to_fl_string(2.5e-7) == fl::string("2.5e-07"), "to_fl_string: double");
+        TEST(fl::to_fl_string(-42) == fl::string("-42"), "to_fl_string: integer");
+    }
+
+    // string_builder::append_formatted writes numbers in place.
+    {
+        fl::string_builder builder;
+        builder.append_formatted("n={};", -9876543210ll).append_formatted("u={};", 42u);
+        builder.append_formatted("d={};", 0.1).append_formatted("f={}", 3.4028235e38f);
+        fl::string built = std::move(builder).build();
+        TEST(std::string(built.data(), built.size()) == "n=-9876543210;u=42;d=0.1;f=3.4028235e+38",
+             "builder: append_formatted numbers");
+    }
+
+    std::cout << "\nAll number format tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include <fl.hpp>
+#include <fl/parse.hpp>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+template <typename Fn>
+static bool throws_invalid(Fn&& fn) {
+    try {
+        fn();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+template <typename Fn>
+static bool throws_out_of_range(Fn&& fn) {
+    try {
+        fn();
+    } catch (const std::out_of_range&) {
+        return true;
+    }
+    return false;
+}
+
+// Bit-for-bit agreement with std::from_chars, including the characters used.
+template <typename F>
+static bool same_as_from_chars(const std::string& text) {
+    F expected{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), expected);
+    const fl::parse_result<F> got = fl::parse_prefix<F>(text);
+    if (error != std::errc{} || got.error != std::errc{}) {
+        return error == got.error;
+    }
+    return std::memcmp(&expected, &got.value, sizeof(F)) == 0 &&
+           got.size == static_cast<std::size_t>(end - text.data());
+}
+
+int main() {
+    // Integers.
+    {
+        TEST(fl::parse<int>("0") == 0 && fl::parse<int>("-0") == 0, "int: zero");
+        TEST(fl::parse<int>("12345678") == 12345678 && fl::parse<long long>("-1234567890123456") == -1234567890123456,
+             "int: eight-digit chunks");
+        TEST(fl::parse<std::uint64_t>("18446744073709551615") == std::numeric_limits<std::uint64_t>::max(),
+             "uint64: max");
+        TEST(fl::parse<std::int64_t>("-9223372036854775808") == std::numeric_limits<std::int64_t>::min(),
+             "int64: min");
+        TEST(fl::parse<std::uint8_t>("000000000000000000000255") == 255, "uint8: leading zeros");
+        TEST(throws_out_of_range([] { (void)fl::parse<std::uint64_t>("18446744073709551616"); }),
+             "uint64: max + 1");
+        TEST(throws_out_of_range([] { (void)fl::parse<std::int8_t>("-129"); }), "int8: below min");
+        TEST(throws_invalid([] { (void)fl::parse<unsigned>("-1"); }), "unsigned: no sign");
+        TEST(throws_invalid([] { (void)fl::parse<int>("+1"); }), "int: no plus");
+        TEST(throws_invalid([] { (void)fl::parse<int>(" 1"); }), "int: no whitespace");
+        TEST(throws_invalid([] { (void)fl::parse<int>("12x"); }), "int: trailing characters");
+        TEST(throws_invalid([] { (void)fl::parse<int>(""); }), "int: empty");
+
+        const fl::parse_result<int> prefix = fl::parse_prefix<int>("42,rest");
+        TEST(prefix && prefix.value == 42 && prefix.size == 2, "parse_prefix: stops at the first non-digit");
+
+        std::mt19937_64 rng(5);
+        bool all = true;
+        char buffer[32];
+        for (int i = 0; i < 20000; ++i) {
+            const std::int64_t value = static_cast<std::int64_t>(rng()) >> (rng() % 64);
+            const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+            const std::string text(buffer, end);
+            all = all && fl::parse<std::int64_t>(text) == value;
+            std::int32_t narrow = 0;
+            const auto error = std::from_chars(text.data(), text.data() + text.size(), narrow).ec;
+            const auto parsed = fl::parse_prefix<std::int32_t>(text);
+            all = all && parsed.error == error && (error != std::errc{} || parsed.value == narrow);
+        }
+        TEST(all, "int: random values match from_chars");
+    }
+
+    // Floating point.
+    {
+        TEST(fl::parse<double>("0.1") == 0.1 && fl::parse<double>("-2.5e-3") == -2.5e-3, "double: simple");
+        TEST(fl::parse<double>("1.") == 1.0 && fl::parse<double>(".5") == 0.5, "double: bare point");
+        TEST(std::signbit(fl::parse<double>("-0.0")), "double: negative zero");
+        TEST(fl::parse<double>("1.7976931348623157e308") == std::numeric_limits<double>::max(), "double: max");
+        TEST(fl::parse<double>("4.9e-324") == std::numeric_limits<double>::denorm_min(), "double: denorm_min");
+        TEST(fl::parse<double>("2.2250738585072014e-308") == std::numeric_limits<double>::min(), "double: min normal");
+        TEST(fl::parse<float>("3.4028235e38") == std::numeric_limits<float>::max(), "float: max");
+        TEST(std::isinf(fl::parse<double>("-inf")) && std::isinf(fl::parse<double>("Infinity")), "double: infinity");
+        TEST(std::isnan(fl::parse<double>("nan")), "double: nan");
+        TEST(fl::parse<double>("9007199254740993") == 9007199254740992.0, "double: halfway rounds to even");
+        TEST(fl::parse<double>("123456789012345678901234567890") == 123456789012345678901234567890.0,
+             "double: more than 19 digits");
+        TEST(throws_out_of_range([] { (void)fl::parse<double>("1e400"); }), "double: overflow");
+        TEST(throws_out_of_range([] { (void)fl::parse<double>("1e-400"); }), "double: underflow");
+        TEST(throws_invalid([] { (void)fl::parse<double>("1e"); }), "double: exponent without digits");
+        TEST(throws_invalid([] { (void)fl::parse<double>("."); }), "double: no digits");
+
+        const fl::parse_result<double> prefix = fl::parse_prefix<double>("6.02e23mol");
+        TEST(prefix && prefix.value == 6.02e23 && prefix.size == 7, "parse_prefix: double");
+
+        const std::string edge_cases[] = {"2.4e-324", "2.5e-324", "1e-320", "2.2250738585072011e-308",
+                                          "1.7976931348623158e308", "1.7976931348623159e308",
+                                          "0.000000000000000000000000000001234567890123456789012345",
+                                          "7.2057594037927933e16", "1e23", "8.589973e9", "1.17549435e-38", "7e-46"};
+        bool all = true;
+        for (const std::string& text : edge_cases) {
+            all = all && same_as_from_chars<double>(text) && same_as_from_chars<float>(text);
+        }
+        TEST(all, "double/float: edge cases match from_chars");
+
+        std::mt19937_64 rng(9);
+        char buffer[64];
+        for (int i = 0; i < 50000; ++i) {
+            const std::uint64_t bits = rng();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            if (std::isnan(value)) {
+                continue;
+            }
+            const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+            all = all && same_as_from_chars<double>(std::string(buffer, end));
+            const auto float_end = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<float>(value)).ptr;
+            all = all && same_as_from_chars<float>(std::string(buffer, float_end));
+        }
+        TEST(all, "double/float: random round trips match from_chars");
+    }
+
+    // fl string types and try_parse.
+    {
+        const fl::string text("1234");
+        TEST(fl::parse<int>(text) == 1234, "fl::string");
+        const fl::substring_view field(text, 1, 2);
+        TEST(fl::parse<int>(field) == 23 && fl::try_parse<double>(field) == 23.0, "substring_view");
+        TEST(!fl::try_parse<int>("x") && !fl::try_parse<std::uint8_t>("256") && fl::try_parse<int>("7") == 7,
+             "try_parse");
+    }
+
+    // Columns.
+    {
+        std::vector<double> values;
+        TEST(fl::parse_column<double>("1.5,2,-3e2", ',', values) == 3 && (values == std::vector<double>{1.5, 2, -300}),
+             "parse_column: comma separated");
+        std::vector<int> lines;
+        TEST(fl::parse_column<int>("10\r\n20\n30\n", '\n', lines) == 3 && (lines == std::vector<int>{10, 20, 30}),
+             "parse_column: CRLF lines and trailing delimiter");
+        std::array<std::int64_t, 3> fixed{};
+        TEST(fl::parse_column<std::int64_t>("7|8|9", '|', std::span<std::int64_t>(fixed)) == 3 && fixed[2] == 9,
+             "parse_column: into a span");
+        TEST(throws_invalid([] {
+                 std::vector<int> out;
+                 (void)fl::parse_column<int>("1,2,x,4", ',', out);
+             }),
+             "parse_column: bad field");
+        TEST(throws_invalid([] {
+                 std::vector<int> out;
+                 (void)fl::parse_column<int>("1,,2", ',', out);
+             }),
+             "parse_column: empty field");
+        bool length = false;
+        try {
+            std::array<int, 2> small{};
+            (void)fl::parse_column<int>("1,2,3", ',', std::span<int>(small));
+        } catch (const std::length_error&) {
+            length = true;
+        }
+        TEST(length, "parse_column: span too small");
+    }
+
+    std::cout << "\nAll parse tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include <fl.hpp>
+#include <fl/sinks.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static std::string temp_path(const char* name) {
+    return "/tmp/fl_test_sinks_" + std::to_string(::getpid()) + "_" + name;
+}
+
+// Lends its own buffer through prepare()/commit() and counts how output
+// arrives.
+class lending_sink final : public fl::sinks::output_sink {
+public:
+    void write(const char* data, std::size_t len) override {
+        text.append(data, len);
+        ++writes;
+    }
+
+    std::span<char> prepare(std::size_t len) override {
+        ++prepares;
+        _space.resize(len);
+        return _space;
+    }
+
+    void commit(std::size_t len) override { text.append(_space.data(), len); }
+
+    std::string text;
+    int writes = 0;
+    int prepares = 0;
+
+private:
+    std::string _space;
+};
+
+// Overrides write() only.
+class write_only_sink final : public fl::sinks::output_sink {
+public:
+    void write(const char* data, std::size_t len) override { text.append(data, len); }
+
+    std::string text;
+};
+
+int main() {
+    // fd_sink: buffering, bypass and flush.
+    {
+        const std::string path = temp_path("fd");
+        {
+            fl::sinks::fd_sink sink(path.c_str(), false, 64);
+            sink.write("hello ", 6);
+            sink.put('w');
+            TEST(sink.buffered() == 7 && sink.bytes_written() == 0 && read_file(path).empty(),
+                 "fd_sink: small writes stay in the buffer");
+            const std::string large(100, 'x');
+            sink.write(large.data(), large.size());
+            TEST(sink.buffered() == 0 && sink.bytes_written() == 107 && read_file(path) == "hello w" + large,
+                 "fd_sink: a write larger than the buffer goes out with the buffered bytes");
+            sink.write("abc", 3);
+            sink.flush();
+            TEST(read_file(path) == "hello w" + large + "abc" && sink.buffered() == 0, "fd_sink: flush");
+            sink.write("tail", 4);
+        }
+        TEST(read_file(path).ends_with("abctail"), "fd_sink: destructor flushes");
+
+        {
+            fl::sinks::fd_sink sink(path.c_str(), true);
+            fl::format_to(sink, "{} {:.2f} {:>5}\n", 42, 2.5, "r");
+        }
+        TEST(read_file(path).ends_with("abctail42 2.50     r\n"), "fd_sink: append and format_to");
+        std::remove(path.c_str());
+    }
+
+    // prepare/commit through output_sink&.
+    {
+        static_assert(fl::sinks::direct_sink<fl::sinks::output_sink>);
+        const std::string text = "say \"hi\"\n\ttwice";
+        lending_sink lending;
+        fl::sinks::output_sink& lending_ref = lending;
+        fl::json_escape(lending_ref, text);
+        fl::format_to(lending_ref, "|{:>12}|", "right");
+        TEST(lending.text == "say \\\"hi\\\"\\n\\ttwice|       right|" && lending.prepares == 2,
+             "output_sink&: escaping and padding go through prepare()");
+
+        write_only_sink plain;
+        fl::sinks::output_sink& plain_ref = plain;
+        fl::json_escape(plain_ref, text);
+        fl::format_to(plain_ref, "|{:>12}|{}|{:.2f}", "right", -42, 1.5);
+        TEST(plain.text == "say \\\"hi\\\"\\n\\ttwice|       right|-42|1.50",
+             "output_sink&: a sink without prepare() falls back to write()");
+
+        char buffer[64];
+        fl::sinks::buffer_sink fixed(buffer, sizeof(buffer));
+        fl::sinks::output_sink& fixed_ref = fixed;
+        const std::span<char> space = fixed_ref.prepare(10);
+        std::memcpy(space.data(), "0123456789", 10);
+        fixed_ref.commit(4);
+        TEST(fixed.written() == 4 && fixed_ref.prepare(61).empty(), "buffer_sink: virtual prepare/commit");
+    }
+
+    // growing_sink: prepare/commit.
+    {
+        fl::sinks::growing_sink out(4);
+        out.write("ab", 2);
+        const std::span<char> space = out.prepare(100);
+        TEST(space.size() >= 100, "growing_sink: prepare grows");
+        std::memcpy(space.data(), "cde", 3);
+        out.commit(3);
+        fl::format_to(out, "{:>6}{}", 7, 8.25);
+        fl::html_escape(out, "<&>");
+        TEST(std::string(out.data(), out.size()) == "abcde     78.25&lt;&amp;&gt;" &&
+                 out.to_fl_string() == "abcde     78.25&lt;&amp;&gt;",
+             "growing_sink: formatting and escaping in place");
+    }
+
+    // growing_sink: take() moves the buffer out; one sink type serves the
+    // formatting and output APIs.
+    {
+        fl::growing_sink out(0);
+        fl::sinks::output_sink& base = out;
+        fl::format_to(out, "{:>100}", "end");
+        base.write_cstring("|tail");
+        out.truncate(102);
+        const char* const storage = out.data();
+        fl::string taken = out.take();
+        TEST(taken.size() == 102 && taken.data() == storage && std::strlen(taken.c_str()) == 102 &&
+                 taken.ends_with("end|t"),
+             "growing_sink: take() hands over the buffer with a terminator");
+        TEST(out.size() == 0 && out.take().empty(), "growing_sink: empty after take()");
+
+        fl::format_to(out, "{}", "short");
+        TEST(out.take() == "short", "growing_sink: short output taken into the small-string buffer");
+
+        const std::string long_text(200, 'r');
+        out.write(long_text.data(), long_text.size());
+        const char* const rope_storage = out.data();
+        const fl::rope rope(out.take());
+        const char* leaf = nullptr;
+        rope.for_each_chunk([&](std::string_view chunk) { leaf = chunk.data(); });
+        TEST(rope.length() == 200 && leaf == rope_storage, "growing_sink: take() into a rope leaf");
+    }
+
+    // fd_sink: prepare/commit.
+    {
+        const std::string path = temp_path("prepare");
+        {
+            fl::sinks::fd_sink sink(path.c_str(), false, 16);
+            sink.write("0123456789", 10);
+            const std::span<char> space = sink.prepare(8);
+            TEST(space.size() >= 8 && sink.buffered() == 0, "fd_sink: prepare flushes to make room");
+            std::memcpy(space.data(), "abcdefgh", 8);
+            sink.commit(8);
+            TEST(sink.prepare(17).empty(), "fd_sink: prepare beyond the buffer size is refused");
+        }
+        TEST(read_file(path) == "0123456789abcdefgh", "fd_sink: committed bytes are written");
+        std::remove(path.c_str());
+    }
+
+    // fd_sink: short writes and EAGAIN on a non-blocking pipe drained slowly.
+    {
+        int pipe_fds[2];
+        TEST(::pipe(pipe_fds) == 0, "pipe");
+        ::fcntl(pipe_fds[1], F_SETFL, ::fcntl(pipe_fds[1], F_GETFL) | O_NONBLOCK);
+        std::string expected;
+        for (int i = 0; expected.size() < (std::size_t{4} << 20); ++i) {
+            expected += "line " + std::to_string(i) + "\n";
+        }
+        std::string received;
+        std::thread reader([&] {
+            char chunk[1000];
+            for (ssize_t got; (got = ::read(pipe_fds[0], chunk, sizeof(chunk))) > 0;) {
+                received.append(chunk, static_cast<std::size_t>(got));
+            }
+        });
+        {
+            fl::sinks::fd_sink sink(pipe_fds[1], 256 * 1024, true);
+            // Mostly small writes into the buffer, with every eighth larger
+            // than the buffer and sent straight through.
+            for (std::size_t at = 0, step = 0; at < expected.size(); ++step) {
+                const std::size_t size = std::min<std::size_t>(step % 8 == 7 ? 300000 : 100, expected.size() - at);
+                sink.write(expected.data() + at, size);
+                at += size;
+            }
+        }
+        reader.join();
+        ::close(pipe_fds[0]);
+        TEST(received == expected, "fd_sink: every byte arrives through short writes");
+    }
+
+    // fd_sink: errors.
+    {
+        bool open_failed = false;
+        try {
+            fl::sinks::fd_sink sink("/nonexistent-directory/out.txt");
+        } catch (const std::system_error& e) {
+            open_failed = e.code() == std::errc::no_such_file_or_directory;
+        }
+        TEST(open_failed, "fd_sink: open failure carries errno");
+
+        const std::string path = temp_path("readonly");
+        std::ofstream(path) << "x";
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        bool write_failed = false;
+        {
+            fl::sinks::fd_sink sink(fd, 64, true);
+            sink.write("data", 4);
+            try {
+                sink.flush();
+            } catch (const std::system_error& e) {
+                write_failed = e.code() == std::errc::bad_file_descriptor && sink.buffered() == 0;
+            }
+        }
+        TEST(write_failed, "fd_sink: write failure throws std::system_error");
+        std::remove(path.c_str());
+    }
+
+    std::cout << "\nAll sinks tests passed!\n";
+    return 0;
+}
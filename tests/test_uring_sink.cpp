@@ -0,0 +1,175 @@
+#include <fl.hpp>
+#include <fl/uring_sink.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static std::string temp_path(const char* name) {
+    return "/tmp/fl_test_uring_sink_" + std::to_string(::getpid()) + "_" + name;
+}
+
+// Runs every check with io_uring (where the kernel allows it) and with the
+// write() fallback; both must produce the same files.
+static int run_checks(bool io_uring) {
+    const std::string mode = io_uring ? "io_uring: " : "fallback: ";
+    fl::sinks::uring_options opts;
+    opts.buffer_size = 4096;
+    opts.queue_depth = 3;
+    opts.io_uring = io_uring;
+
+    // Many buffers in flight against a regular file.
+    {
+        const std::string path = temp_path("file");
+        std::string expected;
+        {
+            fl::sinks::uring_sink sink(path.c_str(), false, opts);
+            if (io_uring && !sink.uses_io_uring()) {
+                std::cout << "io_uring unavailable; checking the fallback only\n";
+            }
+            for (int i = 0; i < 20000; ++i) {
+                const std::string line = "line " + std::to_string(i) + "\n";
+                sink.write(line.data(), line.size());
+                expected += line;
+            }
+            const std::string large(10000, 'L');
+            sink.write(large.data(), large.size());
+            sink.put('\n');
+            expected += large + "\n";
+            fl::format_to(sink, "{} {:.3f} {:>6}\n", 42, 3.14159, "end");
+            expected += "42 3.142    end\n";
+        }
+        TEST(read_file(path) == expected, mode + "buffers in flight land in order");
+
+        {
+            fl::sinks::uring_sink sink(path.c_str(), true, opts);
+            sink.write("appended\n", 9);
+            sink.flush();
+            TEST(read_file(path) == expected + "appended\n" && sink.bytes_written() == 9, mode + "append and flush");
+            const std::span<char> space = sink.prepare(5);
+            std::memcpy(space.data(), "12345", 5);
+            sink.commit(5);
+            TEST(sink.prepare(4097).empty(), mode + "prepare beyond the buffer size is refused");
+        }
+        TEST(read_file(path) == expected + "appended\n12345", mode + "prepare/commit");
+        std::remove(path.c_str());
+    }
+
+    // A caller's descriptor: the position moves past what was written, and
+    // an O_APPEND descriptor keeps one write in flight.
+    {
+        const std::string path = temp_path("fd");
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        {
+            fl::sinks::uring_sink sink(fd, opts);
+            const std::string block(9000, 'a');
+            sink.write(block.data(), block.size());
+        }
+        TEST(::write(fd, "b", 1) == 1, "write after the sink");
+        ::close(fd);
+        TEST(read_file(path) == std::string(9000, 'a') + "b", mode + "descriptor position follows the output");
+
+        const int append_fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        {
+            fl::sinks::uring_sink sink(append_fd, opts, true);
+            for (int i = 0; i < 1000; ++i) {
+                sink.write("0123456789", 10);
+            }
+        }
+        std::string expected = std::string(9000, 'a') + "b";
+        for (int i = 0; i < 1000; ++i) {
+            expected += "0123456789";
+        }
+        TEST(read_file(path) == expected, mode + "O_APPEND descriptor");
+        std::remove(path.c_str());
+    }
+
+    // A pipe: no offsets, short writes, a reader that drains slowly.
+    {
+        int pipe_fds[2];
+        TEST(::pipe(pipe_fds) == 0, "pipe");
+        std::string expected;
+        for (int i = 0; expected.size() < (std::size_t{1} << 20); ++i) {
+            expected += "record " + std::to_string(i) + "\n";
+        }
+        std::string received;
+        std::thread reader([&] {
+            char chunk[700];
+            for (ssize_t got; (got = ::read(pipe_fds[0], chunk, sizeof(chunk))) > 0;) {
+                received.append(chunk, static_cast<std::size_t>(got));
+            }
+        });
+        {
+            fl::sinks::uring_sink sink(pipe_fds[1], opts, true);
+            for (std::size_t at = 0; at < expected.size(); at += 100) {
+                sink.write(expected.data() + at, std::min<std::size_t>(100, expected.size() - at));
+            }
+        }
+        reader.join();
+        ::close(pipe_fds[0]);
+        TEST(received == expected, mode + "pipe");
+    }
+
+    // Errors carry the error code.
+    {
+        bool open_failed = false;
+        try {
+            fl::sinks::uring_sink sink("/nonexistent-directory/out.txt", false, opts);
+        } catch (const std::system_error& e) {
+            open_failed = e.code() == std::errc::no_such_file_or_directory;
+        }
+        TEST(open_failed, mode + "open failure carries errno");
+
+        const std::string path = temp_path("readonly");
+        std::ofstream(path) << "x";
+        bool write_failed = false;
+        {
+            fl::sinks::uring_sink sink(::open(path.c_str(), O_RDONLY), opts, true);
+            sink.write("data", 4);
+            try {
+                sink.flush();
+            } catch (const std::system_error& e) {
+                write_failed = e.code() == std::errc::bad_file_descriptor;
+            }
+        }
+        TEST(write_failed, mode + "write failure throws std::system_error");
+        std::remove(path.c_str());
+    }
+    return 0;
+}
+
+int main() {
+    {
+        fl::sinks::uring_sink probe(::dup(1), {}, true);
+        std::cout << "io_uring " << (probe.uses_io_uring() ? "available" : "unavailable")
+                  << (probe.registered_buffers() ? ", buffers registered" : "") << "\n";
+    }
+    if (run_checks(true) != 0 || run_checks(false) != 0) {
+        return 1;
+    }
+    std::cout << "\nAll uring_sink tests passed!\n";
+    return 0;
+}
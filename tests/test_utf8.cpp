@@ -0,0 +1,294 @@
+#include <fl.hpp>
+#include <fl/utf8.hpp>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+// Reference validator: decodes each sequence in full and applies the
+// RFC 3629 rules to the code point rather than to byte ranges.
+static std::size_t reference_find_invalid(std::string_view text) {
+    std::size_t i = 0;
+    while (i < text.size()) {
+        const unsigned char lead = static_cast<unsigned char>(text[i]);
+        const std::size_t length = lead < 0x80            ? 1
+                                   : (lead >> 5) == 0x6   ? 2
+                                   : (lead >> 4) == 0xE   ? 3
+                                   : (lead >> 3) == 0x1E  ? 4
+                                                          : 0;
+        if (length == 0 || i + length > text.size()) {
+            return i;
+        }
+        char32_t cp = length == 1 ? lead : lead & (0x7F >> length);
+        for (std::size_t k = 1; k < length; ++k) {
+            const unsigned char c = static_cast<unsigned char>(text[i + k]);
+            if ((c & 0xC0) != 0x80) {
+                return i;
+            }
+            cp = cp << 6 | (c & 0x3F);
+        }
+        const char32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (cp < minimum[length] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return i;
+        }
+        i += length;
+    }
+    return std::string_view::npos;
+}
+
+template <typename Fn>
+static bool throws_invalid(Fn&& fn) {
+    try {
+        fn();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+static std::vector<char32_t> decode_all(fl::utf8_view view) {
+    std::vector<char32_t> out;
+    for (const char32_t cp : view) {
+        out.push_back(cp);
+    }
+    return out;
+}
+
+int main() {
+    const std::string ascii = "The quick brown fox jumps over the lazy dog. ";
+    const std::string latin = "Größenordnung, naïve café, Ærøskøbing, señor. ";
+    const std::string cjk = "統一碼は世界中の文字を扱う。한국어 텍스트. ";
+    const std::string emoji = "smile \xF0\x9F\x98\x80 and \xF4\x8F\xBF\xBF max. ";
+
+    // Well-formed text of every width, at every alignment.
+    {
+        std::string text;
+        for (int i = 0; i < 20; ++i) {
+            text += ascii + latin + cjk + emoji;
+        }
+        bool all = true;
+        for (std::size_t start = 0; start < 40; ++start) {
+            const std::string_view part = std::string_view(text).substr(start);
+            const std::size_t boundary = fl::utf8::find_codepoint_boundary(text, start);
+            const std::string_view aligned = std::string_view(text).substr(boundary);
+            all = all && fl::utf8::validate(aligned) && fl::utf8::find_invalid(aligned) == std::string_view::npos;
+            all = all && fl::utf8::validate(part) == (reference_find_invalid(part) == std::string_view::npos);
+        }
+        TEST(all, "validate: well-formed text at every offset");
+        TEST(fl::utf8::validate("") && fl::utf8::validate(ascii), "validate: empty and ASCII");
+    }
+
+    // Each class of error, alone and inside long text.
+    {
+        const std::string_view bad[] = {
+            "\x80",              // stray continuation
+            "\xC0\xAF",          // overlong 2-byte
+            "\xC1\xBF",          // overlong 2-byte
+            "\xE0\x80\xAF",      // overlong 3-byte
+            "\xE0\x9F\xBF",      // overlong 3-byte
+            "\xED\xA0\x80",      // surrogate
+            "\xED\xBF\xBF",      // surrogate
+            "\xF0\x80\x80\xAF",  // overlong 4-byte
+            "\xF0\x8F\xBF\xBF",  // overlong 4-byte
+            "\xF4\x90\x80\x80",  // above U+10FFFF
+            "\xF5\x80\x80\x80",  // invalid lead
+            "\xFF",              // invalid lead
+            "\xC3",              // truncated
+            "\xE2\x82",          // truncated
+            "\xF0\x9F\x98",      // truncated
+            "\xC3\x28",          // lead followed by ASCII
+            "\xE2\x28\xA1",      // bad second byte
+            "\xE2\x82\x28",      // bad third byte
+            "\xF0\x9F\x98\x28",  // bad fourth byte
+            "\xE2\x82\xAC\xAC",  // surplus continuation
+        };
+        bool all = true;
+        const std::string prefix = ascii + latin + cjk;
+        for (const std::string_view error : bad) {
+            all = all && !fl::utf8::validate(error) && fl::utf8::find_invalid(error) == reference_find_invalid(error);
+            for (std::size_t pad = 0; pad < 40; ++pad) {
+                const std::string text = prefix.substr(0, fl::utf8::find_codepoint_boundary(prefix, 60 + pad)) +
+                                         std::string(error) + ascii;
+                const std::size_t expected = reference_find_invalid(text);
+                all = all && !fl::utf8::validate(text) && fl::utf8::find_invalid(text) == expected;
+            }
+        }
+        TEST(all, "validate: error classes at every block position");
+        const std::string valid_edges =
+            "\xC2\x80\xDF\xBF\xE0\xA0\x80\xED\x9F\xBF\xEE\x80\x80\xF0\x90\x80\x80\xF4\x8F\xBF\xBF";
+        TEST(fl::utf8::validate(valid_edges), "validate: range boundaries");
+    }
+
+    // Random corruption against the reference.
+    {
+        std::mt19937 rng(3);
+        const std::string base = ascii + latin + cjk + emoji + cjk + latin;
+        bool all = true;
+        for (int i = 0; i < 20000; ++i) {
+            std::string text = base.substr(0, rng() % base.size());
+            for (int flips = rng() % 3; flips > 0 && !text.empty(); --flips) {
+                text[rng() % text.size()] = static_cast<char>(rng());
+            }
+            const std::size_t expected = reference_find_invalid(text);
+            all = all && fl::utf8::validate(text) == (expected == std::string_view::npos) &&
+                  fl::utf8::find_invalid(text) == expected;
+        }
+        TEST(all, "validate: random corruption matches reference");
+    }
+
+    // Streaming validator, split at every position.
+    {
+        const std::string text = latin + emoji + cjk + latin;
+        bool all = true;
+        for (std::size_t split = 0; split <= text.size(); ++split) {
+            fl::utf8::validator checker;
+            checker.update(std::string_view(text).substr(0, split));
+            checker.update(std::string_view(text).substr(split));
+            all = all && checker.finish();
+            checker.update(std::string_view(text).substr(0, split));
+            all = all && (checker.finish() == fl::utf8::validate(std::string_view(text).substr(0, split)));
+        }
+        TEST(all, "validator: any split of valid text");
+        fl::utf8::validator checker;
+        checker.update("abc\xE2\x82");
+        TEST(!checker.finish(), "validator: truncated at the end");
+    }
+
+    // Counting and boundaries.
+    {
+        TEST(fl::utf8::count_codepoints(ascii) == ascii.size(), "count_codepoints: ASCII");
+        TEST(fl::utf8::count_codepoints("naïve") == 5, "count_codepoints: Latin");
+        TEST(fl::utf8::count_codepoints("統一碼") == 3, "count_codepoints: CJK");
+        std::string long_text;
+        std::size_t expected = 0;
+        for (int i = 0; i < 300; ++i) {
+            long_text += cjk + emoji + latin;
+            expected += decode_all(cjk).size() + decode_all(emoji).size() + decode_all(latin).size();
+        }
+        TEST(fl::utf8::count_codepoints(long_text) == expected, "count_codepoints: long mixed text");
+
+        const std::string_view euro = "a\xE2\x82\xAC" "b";
+        TEST(fl::utf8::find_codepoint_boundary(euro, 0) == 0 && fl::utf8::find_codepoint_boundary(euro, 2) == 1 &&
+                 fl::utf8::find_codepoint_boundary(euro, 3) == 1 && fl::utf8::find_codepoint_boundary(euro, 4) == 4 &&
+                 fl::utf8::find_codepoint_boundary(euro, 99) == 5,
+             "find_codepoint_boundary");
+    }
+
+    // utf8_view.
+    {
+        const fl::string text("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+        TEST((decode_all(text) == std::vector<char32_t>{U'a', U'é', U'€', U'\U0001F600'}),
+             "utf8_view: decodes every width");
+        const fl::substring_view middle(text, 1, 5);
+        TEST((decode_all(middle) == std::vector<char32_t>{U'é', U'€'}), "utf8_view: substring_view");
+        TEST((decode_all("x\xFFy\xE2\x82") == std::vector<char32_t>{U'x', U'\uFFFD', U'y', U'\uFFFD', U'\uFFFD'}),
+             "utf8_view: ill-formed bytes yield U+FFFD");
+        const fl::utf8_view view(text);
+        TEST(view.valid() && view.count() == 4 && !view.empty(), "utf8_view: valid and count");
+        auto it = view.begin();
+        ++it;
+        TEST(it.base() - text.data() == 1 && *it == U'é', "utf8_view: iterator position");
+    }
+
+    // Ropes, with sequences split across leaves.
+    {
+        const std::string text = latin + cjk + emoji;
+        const std::vector<char32_t> expected = decode_all(text);
+        bool all = true;
+        for (std::size_t split = 0; split + 2 <= text.size(); split += 1) {
+            fl::rope r(text.substr(0, split).c_str());
+            r += fl::rope(text.substr(split, 1).c_str());
+            r += fl::rope(text.substr(split + 1).c_str());
+            std::vector<char32_t> decoded;
+            fl::utf8::for_each_codepoint(r, [&](char32_t cp) { decoded.push_back(cp); });
+            all = all && decoded == expected && fl::utf8::validate(r) &&
+                  fl::utf8::count_codepoints(r) == expected.size();
+        }
+        TEST(all, "rope: split sequences decode and validate");
+
+        fl::rope broken("ab\xE2\x82");
+        broken += fl::rope("x\xF0");
+        std::vector<char32_t> decoded;
+        fl::utf8::for_each_codepoint(broken, [&](char32_t cp) { decoded.push_back(cp); });
+        TEST(!fl::utf8::validate(broken) &&
+                 (decoded == std::vector<char32_t>{U'a', U'b', U'\uFFFD', U'\uFFFD', U'x', U'\uFFFD'}),
+             "rope: ill-formed across leaves");
+    }
+
+    // Transcoding: round trips at every length, against a scalar reference.
+    {
+        const std::string text = ascii + latin + ascii + ascii + cjk + emoji + ascii + ascii + ascii + latin;
+        bool all = true;
+        for (std::size_t size = 0; size <= text.size(); ++size) {
+            const std::string_view part =
+                std::string_view(text).substr(0, fl::utf8::find_codepoint_boundary(text, size));
+            const std::vector<char32_t> points = decode_all(part);
+            std::u16string expected16;
+            for (const char32_t cp : points) {
+                if (cp < 0x10000) {
+                    expected16 += static_cast<char16_t>(cp);
+                } else {
+                    expected16 += static_cast<char16_t>(0xD800 + ((cp - 0x10000) >> 10));
+                    expected16 += static_cast<char16_t>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+                }
+            }
+            const std::u16string utf16 = fl::utf8_to_utf16(part);
+            const std::u32string utf32 = fl::utf8_to_utf32(part);
+            all = all && utf16 == expected16 && utf32 == std::u32string(points.begin(), points.end());
+            all = all && fl::utf8::utf16_length_from_utf8(part) == utf16.size() &&
+                  fl::utf8::utf8_length_from_utf16(utf16) == part.size();
+            all = all && std::string_view(fl::utf16_to_utf8(utf16)) == part;
+            fl::string_builder builder;
+            fl::utf16_to_utf8(builder, utf16);
+            all = all && std::string_view(builder.data(), builder.size()) == part;
+        }
+        TEST(all, "transcode: UTF-8 -> UTF-16/32 -> UTF-8 at every length");
+
+        // A write-only sink takes the chunked path, which must not split a
+        // surrogate pair.
+        std::u16string pairs;
+        for (int i = 0; i < 600; ++i) {
+            pairs += i % 3 == 0 ? u"a" : u"\U0001F600";
+        }
+        struct string_sink {
+            std::string text;
+            void write(const char* data, std::size_t len) { text.append(data, len); }
+        } plain;
+        fl::utf16_to_utf8(plain, pairs);
+        TEST(plain.text == std::string_view(fl::utf16_to_utf8(pairs)) && fl::utf8::validate(plain.text),
+             "utf16_to_utf8: chunked sink keeps surrogate pairs whole");
+        TEST(fl::utf8_to_utf16(fl::substring_view(fl::string("x\u00e9y"), 1, 2)) == u"\u00e9",
+             "utf8_to_utf16: substring_view");
+    }
+
+    // Transcoding errors.
+    {
+        bool threw = false;
+        try {
+            (void)fl::utf8_to_utf16("abc\xC3");
+        } catch (const std::invalid_argument& e) {
+            threw = std::string_view(e.what()).find("offset 3") != std::string_view::npos;
+        }
+        TEST(threw, "utf8_to_utf16: invalid input reports its offset");
+        TEST(throws_invalid([] { (void)fl::utf8_to_utf32("\xED\xA0\x80"); }), "utf8_to_utf32: surrogate");
+        TEST(throws_invalid([] { (void)fl::utf16_to_utf8(u"ab\xD800"); }), "utf16_to_utf8: trailing high surrogate");
+        TEST(throws_invalid([] { (void)fl::utf16_to_utf8(std::u16string(40, u'a') + u'\xDC00'); }),
+             "utf16_to_utf8: lone low surrogate");
+        TEST(throws_invalid([] { (void)fl::utf16_to_utf8(u"\xD800\xD800\xDC00"); }),
+             "utf16_to_utf8: high surrogate before high");
+    }
+
+    std::cout << "\nAll UTF-8 tests passed!\n";
+    return 0;
+}
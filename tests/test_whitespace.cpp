@@ -0,0 +1,130 @@
+#include <fl.hpp>
+#include <fl/whitespace.hpp>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+
+#define TEST(condition, name) \
+    if (!(condition)) { \
+        std::cerr << "FAIL: " << name << "\n"; \
+        return 1; \
+    } else { \
+        std::cout << "PASS: " << name << "\n"; \
+    }
+
+// A sink with write() only, so collapse_whitespace takes its chunked path.
+struct string_sink {
+    std::string text;
+    void write(const char* data, std::size_t len) { text.append(data, len); }
+};
+
+static constexpr std::string_view kSpaces = " \t\n\v\f\r";
+
+static std::string_view reference_trim(std::string_view text) {
+    const std::size_t first = text.find_first_not_of(kSpaces);
+    if (first == std::string_view::npos) {
+        return text.substr(text.size());
+    }
+    return text.substr(first, text.find_last_not_of(kSpaces) - first + 1);
+}
+
+static std::string reference_collapse(std::string_view text) {
+    std::string out;
+    bool pending = false;
+    for (const char c : reference_trim(text)) {
+        if (kSpaces.find(c) != std::string_view::npos) {
+            pending = true;
+            continue;
+        }
+        if (pending) {
+            out.push_back(' ');
+            pending = false;
+        }
+        out.push_back(c);
+    }
+    return out;
+}
+
+int main() {
+    // Views.
+    {
+        TEST(fl::trim_view("  a b \t\r\n") == "a b", "trim_view: both ends");
+        TEST(fl::ltrim_view("\v\f x ") == "x " && fl::rtrim_view(" x \n") == " x", "ltrim_view / rtrim_view");
+        TEST(fl::trim_view("").empty() && fl::trim_view(" \t\n").empty(), "trim_view: empty and all whitespace");
+        const std::string_view all(" \t\n");
+        TEST(fl::ltrim_view(all).data() == all.data() + all.size() && fl::rtrim_view(all).data() == all.data(),
+             "ltrim_view / rtrim_view: all whitespace keeps the far end");
+        TEST(fl::trim_view("\x80\xA0 x \xC2\xA0") == "\x80\xA0 x \xC2\xA0", "trim_view: bytes above 0x7F are kept");
+        TEST(fl::trim_view("\x1F x \x0E") == "\x1F x \x0E", "trim_view: only the isspace() controls");
+
+        const std::string padded = std::string(100, ' ') + "value" + std::string(70, '\t');
+        TEST(fl::trim_view(padded) == "value", "trim_view: padding longer than a block");
+
+        const fl::string text("  field one  ");
+        TEST(fl::trim_view(text) == "field one", "trim_view: fl::string");
+        const fl::substring_view field(text, 1, 9);
+        const fl::substring_view trimmed = fl::trim_view(field);
+        TEST(trimmed == "field on" && trimmed.data() == field.data() + 1, "trim_view: substring_view stays in place");
+        TEST(fl::ltrim_view(field) == "field on" && fl::rtrim_view(field) == " field on",
+             "ltrim_view / rtrim_view: substring_view");
+    }
+
+    // In place.
+    {
+        fl::string s("\t  padded value \r\n");
+        TEST(fl::trim(s) == "padded value", "trim: both ends");
+        fl::string left("   left ");
+        fl::string right(" right   ");
+        TEST(fl::ltrim(left) == "left " && fl::rtrim(right) == " right", "ltrim / rtrim");
+        fl::string blank(" \n ");
+        TEST(fl::trim(blank).empty(), "trim: all whitespace");
+        fl::string long_text(std::string(40, ' ') + std::string(200, 'x') + std::string(40, '\n'));
+        TEST(fl::trim(long_text) == std::string(200, 'x'), "trim: heap string");
+    }
+
+    // Collapsing.
+    {
+        fl::string log_line("  2026-10-17  12:00:01\tINFO   [worker-3]\t\trequest  handled  \r\n");
+        TEST(fl::collapse_whitespace(log_line) == "2026-10-17 12:00:01 INFO [worker-3] request handled",
+             "collapse_whitespace: log line");
+        fl::string one(" a ");
+        TEST(fl::collapse_whitespace(one) == "a", "collapse_whitespace: single character");
+        fl::string none("\t \n");
+        TEST(fl::collapse_whitespace(none).empty(), "collapse_whitespace: all whitespace");
+
+        // Random mixes at every length, so runs straddle 16- and 32-byte
+        // blocks and the scalar tail, in place and through both sink paths.
+        std::mt19937 rng(17);
+        const std::string alphabet = "ab,. \t\n\v\f\r";
+        bool all = true;
+        for (int round = 0; round < 4000 && all; ++round) {
+            std::string text(static_cast<std::size_t>(rng() % 200), ' ');
+            const unsigned spread = 1 + rng() % 10;
+            for (char& c : text) {
+                c = alphabet[rng() % spread];
+            }
+            const std::string expected = reference_collapse(text);
+            fl::string in_place(text);
+            all = all && std::string_view(fl::collapse_whitespace(in_place)) == expected;
+            string_sink plain;
+            fl::collapse_whitespace(plain, text);
+            fl::string_builder direct;
+            fl::collapse_whitespace(direct, text);
+            all = all && plain.text == expected && std::string_view(direct.data(), direct.size()) == expected;
+            all = all && fl::trim_view(text) == reference_trim(text);
+            fl::string trimmed(text);
+            all = all && std::string_view(fl::trim(trimmed)) == reference_trim(text);
+        }
+        TEST(all, "collapse_whitespace / trim: random text matches the reference");
+
+        string_sink chunked;
+        const std::string long_run = "x" + std::string(600, ' ') + "y" + std::string(300, '\t') + "z";
+        fl::collapse_whitespace(chunked, long_run);
+        TEST(chunked.text == "x y z", "collapse_whitespace: runs spanning sink chunks");
+    }
+
+    std::cout << "\nAll whitespace tests passed!\n";
+    return 0;
+}